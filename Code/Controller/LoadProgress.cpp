@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadProgress.cpp
+//! \brief The LoadProgress.cpp file contains the definition of
+//!        non-inline methods of the LoadProgress class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "LoadProgress.h"
+using namespace std;
+
+// Constructor
+LoadProgress::LoadProgress()
+{
+    reset();
+}
+
+// Destructor
+LoadProgress::~LoadProgress()
+{}
+
+// The 'reset' method
+void LoadProgress::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_clock.start();
+    m_sliceCount = 0;
+    m_loadedSliceCount = 0;
+    m_bytes = 0;
+    m_finished = false;
+
+    for(int i = 0 ; i < STAGE_COUNT ; i++)
+    {
+        m_stageStarts[i] = -1;
+        m_stageEnds[i] = -1;
+        m_stageBusyTimes[i] = 0;
+    }
+}
+
+// The 'setSliceCount' method
+void LoadProgress::setSliceCount(unsigned int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sliceCount = count;
+}
+
+// The 'elapsed' method
+int LoadProgress::elapsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_clock.elapsed();
+}
+
+// The 'addStageSpan' method
+void LoadProgress::addStageSpan(Stage stage, int start, int end)
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_stageStarts[stage] < 0 || start < m_stageStarts[stage])
+        m_stageStarts[stage] = start;
+    if(end > m_stageEnds[stage])
+        m_stageEnds[stage] = end;
+    m_stageBusyTimes[stage] += end - start;
+}
+
+// The 'addSlice' method
+void LoadProgress::addSlice(unsigned long long bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_loadedSliceCount++;
+    m_bytes += bytes;
+}
+
+// The 'finish' method
+void LoadProgress::finish()
+{
+    QMutexLocker locker(&m_mutex);
+    m_finished = true;
+}
+
+// The 'value' method
+float LoadProgress::value() const
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_finished)
+        return 1.0;
+    if(m_sliceCount == 0)
+        return 0.0;
+
+    return static_cast<float>(m_loadedSliceCount) / m_sliceCount;
+}
+
+// The 'bytesPerSecond' method
+double LoadProgress::bytesPerSecond() const
+{
+    QMutexLocker locker(&m_mutex);
+    int start = m_stageStarts[TRANSFER];
+    int end = m_finished ? m_stageEnds[TRANSFER] : m_clock.elapsed();
+    if(start < 0 || end <= start)
+        return 0.0;
+
+    return m_bytes * 1000.0 / (end - start);
+}
+
+// The 'remainingTime' method
+int LoadProgress::remainingTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_finished)
+        return 0;
+
+    int start = m_stageStarts[TRANSFER];
+    if(start < 0 || m_loadedSliceCount == 0 || m_sliceCount < m_loadedSliceCount)
+        return -1;
+
+    // The slices still to load are assumed to arrive at the current pace
+    double sliceTime = static_cast<double>(m_clock.elapsed() - start) / m_loadedSliceCount;
+    return static_cast<int>(sliceTime * (m_sliceCount - m_loadedSliceCount));
+}
+
+// The 'stageTime' method
+int LoadProgress::stageTime(Stage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_stageStarts[stage] < 0)
+        return 0;
+
+    return m_stageEnds[stage] - m_stageStarts[stage];
+}
+
+// The 'stageBusyTime' method
+int LoadProgress::stageBusyTime(Stage stage) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stageBusyTimes[stage];
+}
+
+// The 'summary' method
+QString LoadProgress::summary() const
+{
+    double rate = bytesPerSecond();
+    int remaining = remainingTime();
+
+    if(value() >= 1.0)
+        return "Terminé";
+    if(rate <= 0)
+        return "Préparation...";
+
+    QString text = QString::number(rate / (1024 * 1024), 'f', 1) + " Mo/s";
+    if(remaining >= 0)
+        text += ", reste " + QString::number((remaining + 999) / 1000) + " s";
+
+    return text;
+}
+
+// The 'print' method
+void LoadProgress::print(ostream& out) const
+{
+    out << "  total : " << elapsed() << " ms, "
+        << bytesPerSecond() / (1024 * 1024) << " MB/s" << endl;
+
+    for(int i = 0 ; i < STAGE_COUNT ; i++)
+    {
+        Stage stage = static_cast<Stage>(i);
+        out << "  " << stageName(stage) << " : " << stageTime(stage) << " ms"
+            << " (busy " << stageBusyTime(stage) << " ms)" << endl;
+    }
+}
+
+// The 'stageName' static method
+char const* LoadProgress::stageName(Stage stage)
+{
+    switch(stage)
+    {
+        case METADATA:
+            return "metadata";
+        case TRANSFER:
+            return "transfer and decoding";
+        case REORIENTATION:
+            return "reorientation";
+        case STATISTICS:
+            return "statistics";
+        default:
+            return "?";
+    }
+}
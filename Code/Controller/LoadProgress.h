@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadProgress.h
+//! \brief The LoadProgress.h file contains the interface of the
+//!        LoadProgress class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef LOADPROGRESS_H
+#define LOADPROGRESS_H
+
+#include <iostream>
+
+#include <QMutex>
+#include <QString>
+#include <QTime>
+
+//!
+//! \brief The LoadProgress class gathers the progression and the timing of
+//!        the loading of a series.
+//!
+//! The loading is split in stages. For each stage, the wall time (from its
+//! first start to its last end) and the busy time (summed over the threads
+//! which run it) are recorded. The transferred bytes give the transfer rate
+//! and the remaining time.
+//!
+//! All the methods are thread-safe.
+//!
+class LoadProgress
+{
+    public:
+        //! The stages of the loading of a series
+        enum Stage
+        {
+            METADATA,       // Cache check, instance tags and slice sorting
+            TRANSFER,       // Download and decoding of the slices
+            REORIENTATION,  // Writing of the slices in the volume
+            STATISTICS,     // Basic windows of the series
+            STAGE_COUNT
+        };
+
+        //!
+        //! \brief The LoadProgress constructor initializes an empty
+        //!        progression.
+        //!
+        LoadProgress();
+
+        //!
+        //! \brief The LoadProgress destructor.
+        //!
+        ~LoadProgress();
+
+        //!
+        //! \brief The reset method clears the progression and restarts the
+        //!        clock.
+        //!
+        //! \return Nothing.
+        //!
+        void reset();
+
+        //!
+        //! \brief The setSliceCount method sets the number of slices to load.
+        //!
+        //! \param count The number of slices of the series.
+        //!
+        //! \return Nothing.
+        //!
+        void setSliceCount(unsigned int count);
+
+        //!
+        //! \brief The elapsed method returns the time since the last reset.
+        //!
+        //! \return The elapsed time in milliseconds.
+        //!
+        int elapsed() const;
+
+        //!
+        //! \brief The addStageSpan method records that a stage has been run
+        //!        between two instants.
+        //!
+        //! \param stage The stage which has been run.
+        //! \param start The start of the run (as given by elapsed).
+        //! \param end The end of the run (as given by elapsed).
+        //!
+        //! \return Nothing.
+        //!
+        void addStageSpan(Stage stage, int start, int end);
+
+        //!
+        //! \brief The addSlice method records that a slice has been loaded.
+        //!
+        //! \param bytes The size of the decoded slice.
+        //!
+        //! \return Nothing.
+        //!
+        void addSlice(unsigned long long bytes);
+
+        //!
+        //! \brief The finish method marks the loading as complete.
+        //!
+        //! \return Nothing.
+        //!
+        void finish();
+
+        //!
+        //! \brief The value method returns the loading progression.
+        //!
+        //! \return A floating point value between 0 and 1.
+        //!
+        float value() const;
+
+        //!
+        //! \brief The bytesPerSecond method returns the transfer rate of the
+        //!        slices.
+        //!
+        //! \return The number of decoded bytes received per second.
+        //!
+        double bytesPerSecond() const;
+
+        //!
+        //! \brief The remainingTime method estimates the time needed to load
+        //!        the remaining slices.
+        //!
+        //! \return The remaining time in milliseconds, or -1 if it can not be
+        //!         estimated yet.
+        //!
+        int remainingTime() const;
+
+        //!
+        //! \brief The stageTime method returns the wall time of a stage.
+        //!
+        //! \param stage The stage.
+        //!
+        //! \return The wall time of the stage in milliseconds.
+        //!
+        int stageTime(Stage stage) const;
+
+        //!
+        //! \brief The stageBusyTime method returns the time spent in a stage,
+        //!        summed over the threads which ran it.
+        //!
+        //! \param stage The stage.
+        //!
+        //! \return The busy time of the stage in milliseconds.
+        //!
+        int stageBusyTime(Stage stage) const;
+
+        //!
+        //! \brief The summary method returns a short description of the
+        //!        progression, for the user.
+        //!
+        //! \return A QString object which contains the rate and the remaining
+        //!         time.
+        //!
+        QString summary() const;
+
+        //!
+        //! \brief The print method writes the timing of each stage.
+        //!
+        //! \param out The stream to write on.
+        //!
+        //! \return Nothing.
+        //!
+        void print(std::ostream& out) const;
+
+        //!
+        //! \brief The stageName static method returns the name of a stage.
+        //!
+        //! \param stage The stage.
+        //!
+        //! \return The name of the stage.
+        //!
+        static char const* stageName(Stage stage);
+
+    private:
+        mutable QMutex m_mutex;
+        QTime m_clock;                        // Started on reset
+
+        unsigned int m_sliceCount, m_loadedSliceCount;
+        unsigned long long m_bytes;
+        bool m_finished;
+
+        int m_stageStarts[STAGE_COUNT];       // -1 if the stage was not run
+        int m_stageEnds[STAGE_COUNT];
+        int m_stageBusyTimes[STAGE_COUNT];
+};
+
+#endif
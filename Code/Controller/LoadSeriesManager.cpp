@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadSeriesManager.cpp
+//! \brief The LoadSeriesManager.cpp file contains the definition of
+//!        non-inline methods of the LoadSeriesManager class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "LoadSeriesManager.h"
+using namespace std;
+
+// Constructor
+LoadSeriesManager::LoadSeriesManager(OrthancClient::OrthancConnection& orthanc,
+                                     QString const& user, QString const& password,
+                                     QObject* parent)
+    : QObject(parent), m_orthanc(orthanc), m_user(user), m_password(password),
+      m_requestCount(0)
+{
+    m_slicePool.setMaxThreadCount(ProgramConfiguration::instance()->loadingThreadCount());
+}
+
+// Destructor
+LoadSeriesManager::~LoadSeriesManager()
+{
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(m_loads.at(i).thread != 0)
+            m_loads.at(i).thread->cancel();
+    }
+
+    // The thread destructor waits for the end of the loading
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(m_loads.at(i).thread != 0)
+            delete m_loads.at(i).thread;
+    }
+    m_slicePool.waitForDone();
+}
+
+// The 'seriesIds' method
+QStringList LoadSeriesManager::seriesIds() const
+{
+    QStringList ids;
+    for(int i = 0 ; i < m_loads.size() ; i++)
+        ids << m_loads.at(i).seriesId;
+
+    return ids;
+}
+
+// The 'title' method
+QString LoadSeriesManager::title(QString const& seriesId) const
+{
+    int index = findLoad(seriesId);
+    if(index < 0)
+        return "";
+
+    return m_loads.at(index).title;
+}
+
+// The 'progressValue' method
+float LoadSeriesManager::progressValue(QString const& seriesId) const
+{
+    int index = findLoad(seriesId);
+    if(index < 0 || m_loads.at(index).thread == 0)
+        return 0.0;
+
+    return m_loads.at(index).thread->progressValue();
+}
+
+// The 'progressSummary' method
+QString LoadSeriesManager::progressSummary(QString const& seriesId) const
+{
+    int index = findLoad(seriesId);
+    if(index < 0)
+        return "";
+    if(m_loads.at(index).thread == 0)
+        return "En attente";
+
+    return m_loads.at(index).thread->progress().summary();
+}
+
+// The 'isLoading' method
+bool LoadSeriesManager::isLoading(QString const& seriesId) const
+{
+    return findLoad(seriesId) >= 0;
+}
+
+// The 'pendingCount' method
+int LoadSeriesManager::pendingCount() const
+{
+    int count = 0;
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(!m_loads.at(i).delivered)
+            count++;
+    }
+
+    return count;
+}
+
+// The 'load' slot
+void LoadSeriesManager::load(QString const& seriesId, QString const& title)
+{
+    if(seriesId.isEmpty() || isLoading(seriesId))
+        return;
+
+    SeriesLoad newLoad;
+    newLoad.seriesId = seriesId;
+    newLoad.title = title.isEmpty() ? seriesId : title;
+    newLoad.priority = 0;
+    newLoad.order = m_requestCount++;
+    newLoad.thread = 0;
+    newLoad.delivered = false;
+
+    // Keep the list sorted by decreasing priority, then by request order
+    int position = 0;
+    while(position < m_loads.size() && m_loads.at(position).priority >= newLoad.priority)
+        position++;
+    m_loads.insert(position, newLoad);
+
+    startLoads();
+    emit loadsChanged();
+}
+
+// The 'cancel' slot
+void LoadSeriesManager::cancel(QString const& seriesId)
+{
+    int index = findLoad(seriesId);
+    if(index < 0)
+        return;
+
+    // A queued series is simply forgotten, a loading one is removed once its
+    // thread has ended
+    if(m_loads.at(index).thread == 0)
+    {
+        m_loads.removeAt(index);
+        emit loadsChanged();
+    }
+    else
+    {
+        m_loads.at(index).thread->cancel();
+    }
+}
+
+// The 'prioritize' slot
+void LoadSeriesManager::prioritize(QString const& seriesId)
+{
+    int index = findLoad(seriesId);
+    if(index < 0)
+        return;
+
+    SeriesLoad load = m_loads.takeAt(index);
+    load.priority = m_loads.isEmpty() ? load.priority : m_loads.first().priority + 1;
+    if(load.thread != 0)
+        load.thread->setPriority(load.priority);
+    m_loads.prepend(load);
+
+    startLoads();
+    emit loadsChanged();
+}
+
+// The 'receiveLoadedSeries' private slot
+void LoadSeriesManager::receiveLoadedSeries(SeriesData* series)
+{
+    int index = findThread(sender());
+    if(index < 0)
+        return;
+
+    m_loads[index].delivered = true;
+    if(series != 0)
+        emit seriesLoaded(series);
+    else
+        emit loadFailed(m_loads.at(index).title);
+}
+
+// The 'removeFinishedLoad' private slot
+void LoadSeriesManager::removeFinishedLoad()
+{
+    int index = findThread(sender());
+    if(index < 0)
+        return;
+
+    m_loads.at(index).thread->deleteLater();
+    m_loads.removeAt(index);
+
+    startLoads();
+    emit loadsChanged();
+}
+
+// The 'findLoad' private method
+int LoadSeriesManager::findLoad(QString const& seriesId) const
+{
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(m_loads.at(i).seriesId == seriesId)
+            return i;
+    }
+
+    return -1;
+}
+
+// The 'findThread' private method
+int LoadSeriesManager::findThread(QObject* thread) const
+{
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(thread != 0 && m_loads.at(i).thread == thread)
+            return i;
+    }
+
+    return -1;
+}
+
+// The 'startLoads' private method
+void LoadSeriesManager::startLoads()
+{
+    unsigned int runningCount = 0;
+    for(int i = 0 ; i < m_loads.size() ; i++)
+    {
+        if(m_loads.at(i).thread != 0)
+            runningCount++;
+    }
+
+    unsigned int maxCount = ProgramConfiguration::instance()->concurrentLoadCount();
+    for(int i = 0 ; i < m_loads.size() && runningCount < maxCount ; i++)
+    {
+        SeriesLoad& load = m_loads[i];
+        if(load.thread != 0)
+            continue;
+
+        load.thread = new LoadSeriesThread(m_orthanc, m_slicePool, m_user, m_password);
+        load.thread->setPriority(load.priority);
+        connect(load.thread, SIGNAL(seriesLoaded(SeriesData*)), this, SLOT(receiveLoadedSeries(SeriesData*)));
+        connect(load.thread, SIGNAL(finished()), this, SLOT(removeFinishedLoad()));
+
+        cout << "Loading of series " << load.seriesId.toStdString() << " started." << endl;
+        load.thread->load(load.seriesId);
+        runningCount++;
+    }
+}
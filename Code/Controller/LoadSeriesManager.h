@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadSeriesManager.h
+//! \brief The LoadSeriesManager.h file contains the interface of the
+//!        LoadSeriesManager class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef LOADSERIESMANAGER_H
+#define LOADSERIESMANAGER_H
+
+#include <iostream>
+
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "orthanc/OrthancCppClient.h"
+
+#include "Model/ProgramConfiguration.h"
+#include "Model/SeriesData.h"
+#include "Controller/LoadSeriesThread.h"
+
+//!
+//! \brief The SeriesLoad structure describes a series which is queued or
+//!        loading in the LoadSeriesManager.
+//!
+struct SeriesLoad
+{
+    QString seriesId;            // The Orthanc id of the series
+    QString title;               // The text which describes the series
+    int priority;                // The higher, the sooner
+    unsigned int order;          // The request order (for equal priorities)
+    LoadSeriesThread* thread;    // The loading thread (0 while queued)
+    bool delivered;              // True once the series has been signaled
+};
+
+//!
+//! \brief The LoadSeriesManager class queues the series to load from Orthanc
+//!        and loads several of them at the same time.
+//!
+//! The number of series loaded at once is given by the program
+//! configuration. All the loads share a single pool of slice downloads, in
+//! which the slices of the series with the highest priority are served
+//! first. A load can be canceled or prioritized at any time.
+//!
+class LoadSeriesManager : public QObject
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The LoadSeriesManager constructor links the manager with an
+        //!        Orthanc connexion.
+        //!
+        //! \param orthanc A reference to an active OrthancConnection object.
+        //! \param user The user name of the connexion.
+        //! \param password The password of the connexion.
+        //! \param parent A pointer to the parent QObject.
+        //!
+        LoadSeriesManager(OrthancClient::OrthancConnection& orthanc,
+                          QString const& user = "", QString const& password = "",
+                          QObject* parent = 0);
+
+        //!
+        //! \brief The LoadSeriesManager destructor cancels the loads and
+        //!        waits for the loading threads.
+        //!
+        ~LoadSeriesManager();
+
+        //!
+        //! \brief The seriesIds method returns the ids of the series which are
+        //!        queued or loading, by decreasing priority.
+        //!
+        //! \return A QStringList object which contains the series ids.
+        //!
+        QStringList seriesIds() const;
+
+        //!
+        //! \brief The title method returns the text given with a load request.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        //! \return A QString object which contains the title (empty if the
+        //!         series is not handled by the manager).
+        //!
+        QString title(QString const& seriesId) const;
+
+        //!
+        //! \brief The progressValue method returns the loading progression of
+        //!        a series.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        //! \return A floating point value between 0 and 1 (0 while the series
+        //!         is queued).
+        //!
+        float progressValue(QString const& seriesId) const;
+
+        //!
+        //! \brief The progressSummary method returns a short description of
+        //!        the loading of a series (transfer rate, remaining time).
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        //! \return A QString object which contains the description.
+        //!
+        QString progressSummary(QString const& seriesId) const;
+
+        //!
+        //! \brief The isLoading method indicates if a series is queued or
+        //!        loading.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        //! \return A boolean which is true if the series is handled by the
+        //!         manager.
+        //!
+        bool isLoading(QString const& seriesId) const;
+
+        //!
+        //! \brief The pendingCount method returns the number of series which
+        //!        have not been signaled yet.
+        //!
+        //! \return The number of series waiting to be signaled.
+        //!
+        int pendingCount() const;
+
+    public slots:
+        //!
+        //! \brief The load slot queues the loading of a series.
+        //!
+        //! Nothing is done if the series is already queued or loading.
+        //!
+        //! \param seriesId A QString object which contains the series id.
+        //! \param title A QString object which describes the series.
+        //!
+        //! \return Nothing.
+        //!
+        void load(QString const& seriesId, QString const& title = "");
+
+        //!
+        //! \brief The cancel slot cancels the loading of a series.
+        //!
+        //! \param seriesId A QString object which contains the series id.
+        //!
+        //! \return Nothing.
+        //!
+        void cancel(QString const& seriesId);
+
+        //!
+        //! \brief The prioritize slot gives to a series a higher priority than
+        //!        all the other ones.
+        //!
+        //! \param seriesId A QString object which contains the series id.
+        //!
+        //! \return Nothing.
+        //!
+        void prioritize(QString const& seriesId);
+
+    signals:
+        //!
+        //! \brief The seriesLoaded signal, once emitted, give access to a
+        //!        loaded series data.
+        //!
+        //! \param series A pointer to a SeriesData object which contains the
+        //!               series.
+        //!
+        void seriesLoaded(SeriesData* series);
+
+        //!
+        //! \brief The loadFailed signal, once emitted, indicates that a series
+        //!        could not be loaded.
+        //!
+        //! \param title The title of the series.
+        //!
+        void loadFailed(QString const& title);
+
+        //!
+        //! \brief The loadsChanged signal, once emitted, indicates that a
+        //!        series has been queued, started or removed.
+        //!
+        void loadsChanged();
+
+    private slots:
+        //!
+        //! \brief The receiveLoadedSeries private slot forwards the series
+        //!        signaled by a loading thread.
+        //!
+        //! \param series A pointer to the loaded series (0 on failure).
+        //!
+        //! \return Nothing.
+        //!
+        void receiveLoadedSeries(SeriesData* series);
+
+        //!
+        //! \brief The removeFinishedLoad private slot forgets a loading thread
+        //!        which has ended and starts the next queued series.
+        //!
+        //! \return Nothing.
+        //!
+        void removeFinishedLoad();
+
+    private:
+        //!
+        //! \brief The findLoad private method returns the position of a
+        //!        series in the load list.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        //! \return The position of the series, or -1 if it is not handled.
+        //!
+        int findLoad(QString const& seriesId) const;
+
+        //!
+        //! \brief The findThread private method returns the position of the
+        //!        series loaded by a thread.
+        //!
+        //! \param thread A pointer to the loading thread.
+        //!
+        //! \return The position of the series, or -1 if it is not handled.
+        //!
+        int findThread(QObject* thread) const;
+
+        //!
+        //! \brief The startLoads private method starts the queued series with
+        //!        the highest priorities while the limit of concurrent loads
+        //!        is not reached.
+        //!
+        //! \return Nothing.
+        //!
+        void startLoads();
+
+        OrthancClient::OrthancConnection& m_orthanc;
+        QString m_user, m_password;
+
+        QThreadPool m_slicePool;       // Shared by all the loading threads
+        QList<SeriesLoad> m_loads;     // Sorted by decreasing priority
+        unsigned int m_requestCount;
+};
+
+#endif
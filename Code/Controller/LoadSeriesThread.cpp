@@ -33,16 +33,156 @@
 //!
 
 #include "LoadSeriesThread.h"
+#include "Controller/LoadSliceTask.h"
+#include "Model/ProgramConfiguration.h"
 using namespace std;
 
+//!
+//! \brief The SlicePosition structure associates an instance index with the
+//!        position of the instance along the slice normal.
+//!
+struct SlicePosition
+{
+    unsigned int index;
+    double position;
+
+    bool operator<(SlicePosition const& other) const
+    { return position < other.position; }
+};
+
+//!
+//! \brief The copyInstanceSlice function writes the decoded rows of an
+//!        instance in a volume of voxels of type T.
+//!
+//! \param instance The instance whose image has been downloaded.
+//! \param permutation The permutation which gives the slice position.
+//! \param stackDims The dimensions of the stack of slices.
+//! \param slice The index of the slice in the stack.
+//! \param output A pointer to the first voxel of the volume.
+//!
+//! \return Nothing.
+//!
+template <class T>
+static void copyInstanceSlice(OrthancClient::Instance& instance,
+                              AxisPermutation const& permutation,
+                              int const stackDims[3], unsigned int slice, T* output)
+{
+    vector<T const*> rows(stackDims[1]);
+    for(int y = 0 ; y < stackDims[1] ; y++)
+        rows.at(y) = static_cast<T const*>(instance.GetBuffer(y));
+
+    permutation.copySlice(rows, stackDims, slice, output);
+}
+
 // Constructor
-LoadSeriesThread::LoadSeriesThread(OrthancClient::OrthancConnection& orthanc)
-    : QThread(), m_orthanc(orthanc), m_seriesToLoadId(""), m_progressValue(0.0)
+LoadSeriesThread::LoadSeriesThread(OrthancClient::OrthancConnection& orthanc,
+                                   QThreadPool& slicePool,
+                                   QString const& user, QString const& password)
+    : QThread(), m_orthanc(orthanc), m_user(user), m_password(password),
+      m_seriesToLoadId(""), m_slicePool(slicePool),
+      m_sliceWindow(2 * slicePool.maxThreadCount()), m_sliceSlots(m_sliceWindow),
+      m_sliceData(0), m_sliceBuffer(0), m_sliceScalarType(VTK_SHORT), m_sliceWidth(0), m_sliceHeight(0), m_sliceCount(0),
+      m_sliceFailure(false), m_canceled(false), m_priority(0)
 {}
 
 // Destructor
 LoadSeriesThread::~LoadSeriesThread()
-{}
+{
+    // A series may still be loading in the background
+    wait();
+}
+
+// The 'storeSlice' method
+void LoadSeriesThread::storeSlice(unsigned int slice, OrthancClient::Instance& instance)
+{
+    // The image is downloaded and decoded on its first access
+    int start = m_progress.elapsed();
+    if(instance.GetWidth() != m_sliceWidth || instance.GetHeight() != m_sliceHeight)
+        throw OrthancClient::OrthancClientException("Instance size differs from the series size");
+    int transferEnd = m_progress.elapsed();
+
+    // Write the decoded rows at their position in the volume, in the native
+    // type of the series
+    int stackDims[3] = { static_cast<int>(m_sliceWidth), static_cast<int>(m_sliceHeight),
+                         static_cast<int>(m_sliceCount) };
+    switch(m_sliceScalarType)
+    {
+        vtkTemplateMacro(copyInstanceSlice(instance, m_slicePermutation, stackDims, slice,
+                                           static_cast<VTK_TT*>(m_sliceBuffer)));
+    }
+    if(m_slicePermutation.outputAxis(2) == 2)
+        m_sliceData->markSliceLoaded(m_slicePermutation.isFlipped(2) ? m_sliceCount-1-slice : slice);
+
+    // Update the progression
+    m_progress.addStageSpan(LoadProgress::TRANSFER, start, transferEnd);
+    m_progress.addStageSpan(LoadProgress::REORIENTATION, transferEnd, m_progress.elapsed());
+    m_progress.addSlice(static_cast<unsigned long long>(m_sliceWidth) * m_sliceHeight
+                        * m_sliceData->GetScalarSize());
+}
+
+// The 'extractionMode' method
+Orthanc::ImageExtractionMode LoadSeriesThread::extractionMode() const
+{
+    switch(m_sliceScalarType)
+    {
+        case VTK_UNSIGNED_CHAR:
+            return Orthanc::ImageExtractionMode_UInt8;
+
+        case VTK_UNSIGNED_SHORT:
+            return Orthanc::ImageExtractionMode_UInt16;
+
+        default:
+            return Orthanc::ImageExtractionMode_Int16;
+    }
+}
+
+// The 'signalFailure' method
+void LoadSeriesThread::signalFailure()
+{
+    QMutexLocker locker(&m_sliceMutex);
+    m_sliceFailure = true;
+}
+
+// The 'hasFailed' method
+bool LoadSeriesThread::hasFailed()
+{
+    QMutexLocker locker(&m_sliceMutex);
+    return m_sliceFailure || m_canceled;
+}
+
+// The 'sliceFinished' method
+void LoadSeriesThread::sliceFinished()
+{
+    m_sliceSlots.release();
+}
+
+// The 'cancel' method
+void LoadSeriesThread::cancel()
+{
+    QMutexLocker locker(&m_sliceMutex);
+    m_canceled = true;
+}
+
+// The 'isCanceled' method
+bool LoadSeriesThread::isCanceled()
+{
+    QMutexLocker locker(&m_sliceMutex);
+    return m_canceled;
+}
+
+// The 'priority' method
+int LoadSeriesThread::priority()
+{
+    QMutexLocker locker(&m_sliceMutex);
+    return m_priority;
+}
+
+// The 'setPriority' method
+void LoadSeriesThread::setPriority(int priority)
+{
+    QMutexLocker locker(&m_sliceMutex);
+    m_priority = priority;
+}
 
 // The 'load' slot
 void LoadSeriesThread::load(QString const& seriesId)
@@ -57,6 +197,25 @@ void LoadSeriesThread::run()
     if(m_seriesToLoadId.isEmpty())
         return;
 
+    m_progress.reset();
+
+    // Reopen the series from the cache if it did not change on the server
+    QString stamp("");
+    if(SeriesCache::isEnabled())
+    {
+        stamp = fetchLastUpdate(m_seriesToLoadId);
+        SeriesData* cachedData = SeriesCache::load(m_seriesToLoadId, stamp);
+        if(cachedData != 0)
+        {
+            cout << "Series " << m_seriesToLoadId.toStdString() << " loaded from the cache." << endl;
+            m_progress.addStageSpan(LoadProgress::METADATA, 0, m_progress.elapsed());
+            m_progress.finish();
+            m_seriesToLoadId = "";
+            emit seriesLoaded(cachedData);
+            return;
+        }
+    }
+
     // Load the series data from Orthanc
     OrthancClient::Series series(m_orthanc, m_seriesToLoadId.toStdString());
 
@@ -64,132 +223,272 @@ void LoadSeriesThread::run()
     if(w != 0 && h != 0 && nbInst != 0)
     {
         // If the series is valid, prepare a series data
-        vtkSmartPointer<SeriesData> seriesData(new SeriesData());
-        seriesData->SetDimensions(w, h, nbInst);
-        seriesData->SetScalarType(VTK_UNSIGNED_SHORT);
-        seriesData->AllocateScalars();
-
-        // Load 3D image from Orthanc
-        try{
-            series.Load3DImage(seriesData->GetScalarPointer(0, 0, 0),
-                               Orthanc::PixelFormat_SignedGrayscale16, 2*w, 2*w*h, &m_progressValue);
-        }
-        catch(OrthancClient::OrthancClientException& e)
-        {
-            cerr << e.What() << endl;
-            m_seriesToLoadId = "";
-            emit seriesLoaded(0);
-            return;
-        }
+        vtkSmartPointer<SeriesData> seriesData;
+        seriesData.TakeReference(new SeriesData());
 
-        // Load other information
-        OrthancClient::Instance instance = series.GetInstance(0);
+        bool sent = false;
+        try {
+            // Read the tags of all the instances at once
+            SeriesMetadata metadata(series);
 
-        instance.LoadTagContent("0010-0010"); // Patient name
-        seriesData->setPatientName(instance.GetLoadedTagContent()); // TODO encoding problem
-        instance.LoadTagContent("0008-1030"); // Study description
-        seriesData->setStudyDescription(instance.GetLoadedTagContent());
-        instance.LoadTagContent("0008-103E"); // Series description
-        seriesData->setSeriesDescription(instance.GetLoadedTagContent());
+            // Sort the slices along their normal
+            vector<unsigned int> sliceOrder;
+            double sliceSpacing = computeSliceOrder(metadata, sliceOrder);
+            m_progress.addStageSpan(LoadProgress::METADATA, 0, m_progress.elapsed());
 
-        // Voxel size and spacing
-        seriesData->SetSpacing(series.GetVoxelSizeX(), series.GetVoxelSizeY(),
-                               computeSliceSpacing(series));
+            int stackDims[3] = { w, h, nbInst };
+            double stackSpacing[3] = { series.GetVoxelSizeX(), series.GetVoxelSizeY(), sliceSpacing };
 
-        try {
-            instance.LoadTagContent("0008-0060"); // Modality
-            seriesData->setModality(instance.GetLoadedTagContent());
-        }
-        catch(exception& e)
-        {}
+            // The slices whose directions follow the volume axes are written
+            // directly at their final position, the oblique ones are resliced
+            // once loaded
+            Vector3D v = metadata.rowDirection(), w = metadata.columnDirection();
+            Vector3D n = v.crossProduct(w);
+            n.normalize();
+            AxisPermutation permutation(v, w, n);
 
-        try {
-            instance.LoadTagContent("0028-1052"); // Rescale intercept
-            double intercept = QString(instance.GetLoadedTagContent().c_str()).toDouble();
-            instance.LoadTagContent("0028-1053"); // Rescale slope
-            double slope = QString(instance.GetLoadedTagContent().c_str()).toDouble();
-            seriesData->setRescaleInterceptAndSlope(intercept, slope);
-        }
-        catch(exception& e)
-        {}
+            int dims[3];
+            double spacing[3], origin[3];
+            permutation.outputGeometry(stackDims, stackSpacing, dims, spacing, origin);
+            seriesData->SetDimensions(dims);
+            seriesData->SetSpacing(spacing);
+            seriesData->SetOrigin(origin);
+            seriesData->SetScalarType(metadata.scalarType());
+            seriesData->AllocateScalars();
 
-        try {
-            seriesData->addBasicWindow();
+            prepareSlices(seriesData, permutation);
+            vector<unsigned int> planes;
+
+            // The slices can be shown as they arrive only if each of them
+            // fills a z-plane of the volume
+            if(ProgramConfiguration::instance()->progressiveLoading() &&
+               permutation.isAxisAligned() && permutation.outputAxis(2) == 2)
+            {
+                // The central slice is loaded first to setup the display...
+                unsigned int center = nbInst / 2;
+                seriesData->startLoading();
+                if(!loadSlices(series, sliceOrder, vector<unsigned int>(1, center)))
+                    throw OrthancClient::OrthancClientException("The central slice could not be loaded");
+                int start = m_progress.elapsed();
+                loadSeriesInformation(metadata, seriesData, permutation.isFlipped(2) ? nbInst-1-center : center);
+                m_progress.addStageSpan(LoadProgress::STATISTICS, start, m_progress.elapsed());
+
+                seriesData->Register(0); // The receiver takes this reference
+                emit seriesLoaded(seriesData.GetPointer());
+                sent = true;
 
-            instance.LoadTagContent("0028-1050"); // Window center
-            QString centersString = instance.GetLoadedTagContent().c_str();
-            instance.LoadTagContent("0028-1051"); // Window width
-            QString widthsString = instance.GetLoadedTagContent().c_str();
+                // ... and the other ones are filled in while it is displayed,
+                // from every 16th slice to every slice, so that a coarse view
+                // of the whole series is soon available
+                bool loaded = true;
+                for(unsigned int step = s_coarsestSliceStep ; step >= 1 && loaded ; step /= 2)
+                {
+                    planes.clear();
+                    for(unsigned int z = 0 ; z < sliceOrder.size() ; z += step)
+                    {
+                        if(z != center && (step == s_coarsestSliceStep || z % (2 * step) != 0))
+                            planes.push_back(z);
+                    }
 
-            QStringList centers = centersString.split("\\");
-            QStringList widths = widthsString.split("\\");
+                    loaded = loadSlices(series, sliceOrder, planes);
+                    if(loaded && step > 1)
+                        seriesData->fillMissingSlices();
+                }
+                seriesData->finishLoading();
 
-            if(centers.size() == widths.size())
+                if(loaded)
+                    SeriesCache::store(m_seriesToLoadId, stamp, seriesData);
+                else if(!isCanceled())
+                    cerr << "Some slices of the series could not be loaded" << endl;
+            }
+            else
             {
-                for(int i = 0 ; i < centers.size() ; i++)
-                    seriesData->addBasicWindow(centers.at(i).toDouble(),
-                                               widths.at(i).toDouble());
+                for(unsigned int z = 0 ; z < sliceOrder.size() ; z++)
+                    planes.push_back(z);
+
+                if(!loadSlices(series, sliceOrder, planes))
+                    throw OrthancClient::OrthancClientException("The series slices could not be loaded");
+
+                // Signal the data after having transformed it
+                int start = m_progress.elapsed();
+                if(!permutation.isAxisAligned())
+                {
+                    vtkSmartPointer<vtkImageReslice> transform = vtkSmartPointer<vtkImageReslice>::New();
+                    transform->SetInput(seriesData);
+                    transform->SetResliceAxesDirectionCosines(v.x(), v.y(), v.z(),
+                                                              w.x(), w.y(), w.z(),
+                                                              n.x(), n.y(), n.z());
+                    transform->Update();
+                    seriesData->DeepCopy(transform->GetOutput());
+                    m_progress.addStageSpan(LoadProgress::REORIENTATION, start, m_progress.elapsed());
+                }
+
+                start = m_progress.elapsed();
+                loadSeriesInformation(metadata, seriesData, -1);
+                m_progress.addStageSpan(LoadProgress::STATISTICS, start, m_progress.elapsed());
+
+                seriesData->Register(0); // The receiver takes this reference
+                emit seriesLoaded(seriesData.GetPointer());
+
+                SeriesCache::store(m_seriesToLoadId, stamp, seriesData);
             }
         }
-        catch(exception& e)
-        {}
-
-        // Signal the data...
-        SeriesData* data = seriesData.GetPointer();
-        seriesData = 0;
-        // ... after having transformed it
-        instance.LoadTagContent("0020-0037");
-        QString or1 = instance.GetLoadedTagContent().c_str();
-        QStringList or1s = or1.split("\\");
-        Vector3D v(or1s.at(0).toDouble(), or1s.at(1).toDouble(), or1s.at(2).toDouble());
-        Vector3D w(or1s.at(3).toDouble(), or1s.at(4).toDouble(), or1s.at(5).toDouble());
-        Vector3D cross = v.crossProduct(w);
-        vtkSmartPointer<vtkImageReslice> transform = vtkSmartPointer<vtkImageReslice>::New();
-        transform->SetInput(data);
-        transform->SetResliceAxesDirectionCosines(v.x(), v.y(), v.z(),
-                                                  w.x(), w.y(), w.z(),
-                                                  cross.x(), cross.y(), cross.z());
-        transform->Update();
-        data->DeepCopy(transform->GetOutput());
-        emit seriesLoaded(data);
+        catch(OrthancClient::OrthancClientException& e)
+        {
+            if(isCanceled())
+                cout << "Loading of series " << m_seriesToLoadId.toStdString() << " canceled." << endl;
+            else
+                cerr << e.What() << endl;
+
+            if(sent)
+                seriesData->finishLoading();
+            else if(!isCanceled())
+                emit seriesLoaded(0);
+        }
     }
 
+    // Report where the loading time went
+    m_progress.finish();
+    cout << "Loading times of series " << m_seriesToLoadId.toStdString() << " :" << endl;
+    m_progress.print(cout);
+
     m_seriesToLoadId = "";
 }
 
-// The 'computeSliceSpacing' method
-double LoadSeriesThread::computeSliceSpacing(OrthancClient::Series& series) const
+// The 'fetchLastUpdate' method
+QString LoadSeriesThread::fetchLastUpdate(QString const& seriesId) const
+{
+    QString url = string(m_orthanc.GetOrthancUrl()).c_str();
+    if(!url.contains("://"))
+        url.prepend("http://");
+
+    QNetworkRequest request(QUrl(url + "/series/" + seriesId));
+    if(!m_user.isEmpty())
+        request.setRawHeader("Authorization", "Basic " + (m_user + ":" + m_password).toUtf8().toBase64());
+
+    // Wait for the answer (at most a few seconds)
+    QNetworkAccessManager manager;
+    QNetworkReply* reply = manager.get(request);
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    QTimer::singleShot(5000, &loop, SLOT(quit()));
+    loop.exec();
+
+    QString lastUpdate("");
+    if(reply->isFinished() && reply->error() == QNetworkReply::NoError)
+    {
+        QRegExp exp("\"LastUpdate\"\\s*:\\s*\"([^\"]*)\"");
+        if(exp.indexIn(QString(reply->readAll())) != -1)
+            lastUpdate = exp.cap(1);
+    }
+    else
+        cerr << "The modification date of the series could not be retrieved" << endl;
+
+    if(!reply->isFinished())
+        reply->abort();
+    delete reply;
+    return lastUpdate;
+}
+
+// The 'loadSeriesInformation' method
+void LoadSeriesThread::loadSeriesInformation(SeriesMetadata const& metadata,
+                                             SeriesData* seriesData,
+                                             int basicWindowSlice) const
 {
-    OrthancClient::Instance instance = series.GetInstance(0);
-    instance.LoadTagContent("0020-0032"); // ImagePositionPatient
-    QString pos1 = instance.GetLoadedTagContent().c_str();
-    QStringList pos1s = pos1.split("\\");
-    Vector3D pos1vector(pos1s.at(0).toDouble(), pos1s.at(1).toDouble(),
-                        pos1s.at(2).toDouble());
+    seriesData->setPatientName(metadata.tag("PatientName")); // TODO encoding problem
+    seriesData->setStudyDescription(metadata.tag("StudyDescription"));
+    seriesData->setSeriesDescription(metadata.tag("SeriesDescription"));
+    seriesData->setModality(metadata.tag("Modality", "?"));
+    seriesData->setRescaleInterceptAndSlope(metadata.rescaleIntercept(0),
+                                            metadata.rescaleSlope(0));
 
-    instance.LoadTagContent("0020-0037"); // ImageOrientationPatient
-    QString or1 = instance.GetLoadedTagContent().c_str();
-    QStringList or1s = or1.split("\\");
-    Vector3D v(or1s.at(0).toDouble(), or1s.at(1).toDouble(), or1s.at(2).toDouble());
-    Vector3D w(or1s.at(3).toDouble(), or1s.at(4).toDouble(), or1s.at(5).toDouble());
+    if(basicWindowSlice < 0)
+        seriesData->addBasicWindow();
+    else
+        seriesData->addSliceBasicWindow(basicWindowSlice);
+
+    if(metadata.hasTag("WindowCenter") && metadata.hasTag("WindowWidth"))
+    {
+        QStringList centers = QString(metadata.tag("WindowCenter").c_str()).split("\\");
+        QStringList widths = QString(metadata.tag("WindowWidth").c_str()).split("\\");
 
-    Vector3D n = v.crossProduct(w);
+        if(centers.size() == widths.size())
+        {
+            for(int i = 0 ; i < centers.size() ; i++)
+                seriesData->addBasicWindow(centers.at(i).toDouble(),
+                                           widths.at(i).toDouble());
+        }
+    }
+}
+
+// The 'computeSliceOrder' method
+double LoadSeriesThread::computeSliceOrder(SeriesMetadata const& metadata,
+                                           vector<unsigned int>& sliceOrder) const
+{
+    Vector3D n = metadata.rowDirection().crossProduct(metadata.columnDirection());
     n.normalize();
 
+    // Locate each instance along the slice normal
+    vector<SlicePosition> positions(metadata.instanceCount());
+    for(unsigned int i = 0 ; i < positions.size() ; i++)
+    {
+        positions.at(i).index = i;
+        positions.at(i).position = n.dotProduct(metadata.position(i));
+    }
+
+    sort(positions.begin(), positions.end());
+
+    // The spacing is the smallest non-null distance between two neighbours
     double min = -1;
-    for(unsigned int i = 1 ; i < series.GetInstanceCount() ; i++) // TODO normally one can be enough but some bug forced me to search for the minest
+    sliceOrder.resize(positions.size());
+    for(unsigned int i = 0 ; i < positions.size() ; i++)
     {
-        OrthancClient::Instance instance2 = series.GetInstance(i);
-        instance2.LoadTagContent("0020-0032");
-        QString pos2 = instance2.GetLoadedTagContent().c_str();
-        QStringList pos2s = pos2.split("\\");
-        Vector3D pos2vector(pos2s.at(0).toDouble(), pos2s.at(1).toDouble(),
-                            pos2s.at(2).toDouble());
-
-        double dist = fabs(n.dotProduct(pos1vector-pos2vector));
-        if(dist < min || min < 0)
+        sliceOrder.at(i) = positions.at(i).index;
+        if(i == 0)
+            continue;
+
+        double dist = positions.at(i).position - positions.at(i-1).position;
+        if(dist > 1e-6 && (dist < min || min < 0))
             min = dist;
     }
 
-    return min;
+    return min > 0 ? min : 1.0;
+}
+
+// The 'prepareSlices' method
+void LoadSeriesThread::prepareSlices(SeriesData* seriesData, AxisPermutation const& permutation)
+{
+    int* dims = seriesData->GetDimensions();
+    m_sliceData = seriesData;
+    m_sliceBuffer = seriesData->GetScalarPointer(0, 0, 0);
+    m_sliceScalarType = seriesData->GetScalarType();
+    m_slicePermutation = permutation;
+    m_sliceWidth = dims[permutation.outputAxis(0)];
+    m_sliceHeight = dims[permutation.outputAxis(1)];
+    m_sliceCount = dims[permutation.outputAxis(2)];
+    m_progress.setSliceCount(m_sliceCount);
+    m_sliceFailure = false;
+}
+
+// The 'loadSlices' method
+bool LoadSeriesThread::loadSlices(OrthancClient::Series& series,
+                                  vector<unsigned int> const& sliceOrder,
+                                  vector<unsigned int> const& planes)
+{
+    // Each worker downloads a whole instance and writes it in the volume. Only
+    // a few slices are queued at once, so that the pool keeps serving the
+    // series with the highest priority.
+    for(unsigned int i = 0 ; i < planes.size() && !hasFailed() ; i++)
+    {
+        unsigned int z = planes.at(i);
+        m_sliceSlots.acquire();
+        m_slicePool.start(new LoadSliceTask(*this, series.GetInstance(sliceOrder.at(z)), z),
+                          priority());
+    }
+
+    // Wait for the started slices
+    m_sliceSlots.acquire(m_sliceWindow);
+    m_sliceSlots.release(m_sliceWindow);
+
+    return !hasFailed();
 }
@@ -36,17 +36,33 @@
 #define LOADSERIESTHREAD_H
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
 
+#include <QEventLoop>
+#include <QMutex>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRegExp>
+#include <QSemaphore>
 #include <QStringList>
 #include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 
 #include <vtkSmartPointer.h>
 #include <vtkImageReslice.h>
 
 #include "orthanc/OrthancCppClient.h"
 
+#include "Model/AxisPermutation.h"
+#include "Model/SeriesCache.h"
 #include "Model/SeriesData.h"
 #include "Model/Vector3D.h"
+#include "Controller/LoadProgress.h"
+#include "Controller/SeriesMetadata.h"
 
 //!
 //! \brief The LoadSeriesThread class permits to load a series from Orthanc
@@ -62,8 +78,15 @@ class LoadSeriesThread : public QThread
         //!        specified Orthanc connexion.
         //!
         //! \param orthanc A reference to an active OrthancConnection object.
+        //! \param slicePool A reference to the thread pool which runs the
+        //!                  slice downloads (it can be shared by several
+        //!                  loading threads).
+        //! \param user The user name of the connexion (used to check the
+        //!             series modification date).
+        //! \param password The password of the connexion.
         //!
-        LoadSeriesThread(OrthancClient::OrthancConnection& orthanc);
+        LoadSeriesThread(OrthancClient::OrthancConnection& orthanc, QThreadPool& slicePool,
+                         QString const& user = "", QString const& password = "");
 
         //!
         //! \brief The LoadSeriesThread destructor.
@@ -71,15 +94,111 @@ class LoadSeriesThread : public QThread
         ~LoadSeriesThread();
 
         //!
-        //! \brief The progressValue method returns a reference which permits
-        //!        to read the loading progression.
+        //! \brief The progressValue method returns the loading progression.
         //!
         //! The method is inline.
         //!
         //! \return A floating point value between 0 and 1 which indicates the
         //!         percentage of progression.
         //!
-        inline float const& progressValue() const;
+        inline float progressValue() const;
+
+        //!
+        //! \brief The progress method returns a reference which permits to
+        //!        read the progression and the timing of the loading.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A constant reference to the LoadProgress object.
+        //!
+        inline LoadProgress const& progress() const;
+
+        //!
+        //! \brief The storeSlice method copies the decoded pixels of an
+        //!        instance at their position in the series being loaded and
+        //!        updates the loading progression.
+        //!
+        //! The method is called concurrently by the LoadSliceTask workers.
+        //!
+        //! \param slice The index of the slice in the sorted stack.
+        //! \param instance A reference to the instance whose image has been
+        //!                 downloaded.
+        //!
+        //! \return Nothing.
+        //!
+        void storeSlice(unsigned int slice, OrthancClient::Instance& instance);
+
+        //!
+        //! \brief The extractionMode method returns the mode in which the
+        //!        instances must be decoded, so that their pixels have the
+        //!        native type of the series being loaded.
+        //!
+        //! \return The Orthanc image extraction mode.
+        //!
+        Orthanc::ImageExtractionMode extractionMode() const;
+
+        //!
+        //! \brief The signalFailure method indicates that a slice could not be
+        //!        loaded, so that the remaining downloads are skipped.
+        //!
+        //! \return Nothing.
+        //!
+        void signalFailure();
+
+        //!
+        //! \brief The hasFailed method indicates if a slice of the current
+        //!        series failed to be loaded or if the loading was canceled.
+        //!
+        //! \return A boolean which is true if the remaining slices must not
+        //!         be loaded.
+        //!
+        bool hasFailed();
+
+        //!
+        //! \brief The sliceFinished method indicates that a slice task has
+        //!        ended, so that another one can be started.
+        //!
+        //! \return Nothing.
+        //!
+        void sliceFinished();
+
+        //!
+        //! \brief The cancel method stops the loading of the series.
+        //!
+        //! The slices which are downloading are completed but no other slice
+        //! is started. If the series was not signaled yet, it will not be.
+        //!
+        //! \return Nothing.
+        //!
+        void cancel();
+
+        //!
+        //! \brief The isCanceled method indicates if the loading of the series
+        //!        was canceled.
+        //!
+        //! \return A boolean which is true if the loading was canceled.
+        //!
+        bool isCanceled();
+
+        //!
+        //! \brief The priority method returns the priority given to the slice
+        //!        downloads of the series in the shared thread pool.
+        //!
+        //! \return The loading priority.
+        //!
+        int priority();
+
+        //!
+        //! \brief The setPriority method changes the priority of the slice
+        //!        downloads of the series.
+        //!
+        //! The new priority applies to the slices which are not started yet.
+        //!
+        //! \param priority The new loading priority.
+        //!
+        //! \return Nothing.
+        //!
+        void setPriority(int priority);
 
     public slots:
         //!
@@ -95,10 +214,16 @@ class LoadSeriesThread : public QThread
     protected:
         //!
         //! \brief The run method loads the series while updating the
-        //!        progression value.
+        //!        progression, and then logs the time spent in each stage.
         //!
         //! This is an implementation of the QThread method.
         //!
+        //! When the progressive loading is enabled, the series is signaled
+        //! as soon as its central slice is available and the other slices are
+        //! filled in afterwards: every 16th slice first, then every 8th, and so
+        //! on. After each pass, the missing slices are filled with the nearest
+        //! loaded ones.
+        //!
         //! \section emit
         //! The seriesLoaded(SeriesData*) signal is emitted.
         //!
@@ -120,23 +245,108 @@ class LoadSeriesThread : public QThread
 
     protected:
         //!
-        //! \brief The computeSliceSpacing method computes the spacing between
-        //!        the slices of the given Orthanc series.
+        //! \brief The fetchLastUpdate method asks the Orthanc server the date
+        //!        of the last modification of a series.
+        //!
+        //! \param seriesId A QString object which contains the series id.
+        //!
+        //! \return A QString object which contains the modification date, or
+        //!         an empty string if it could not be retrieved.
+        //!
+        QString fetchLastUpdate(QString const& seriesId) const;
+
         //!
-        //! \param series A reference to the Orthanc Series to work on.
+        //! \brief The computeSliceOrder method sorts the instances of a series
+        //!        along the slice normal and computes the spacing between the
+        //!        slices.
+        //!
+        //! \param metadata The prefetched tags of the series instances.
+        //! \param sliceOrder A vector which is filled with the instance
+        //!                   indexes, in the stacking order.
         //!
         //! \return The spacing between the series slices.
         //!
-        double computeSliceSpacing(OrthancClient::Series& series) const;
+        double computeSliceOrder(SeriesMetadata const& metadata,
+                                 std::vector<unsigned int>& sliceOrder) const;
+
+        //!
+        //! \brief The loadSeriesInformation method stores the descriptive
+        //!        tags, the rescale parameters and the windows of the series
+        //!        in the series data.
+        //!
+        //! \param metadata The prefetched tags of the series instances.
+        //! \param seriesData A pointer to the series data to complete.
+        //! \param basicWindowSlice The index of the only z-plane whose scalar
+        //!                         range must be used for the basic window, or
+        //!                         -1 to use the whole volume.
+        //!
+        //! \return Nothing.
+        //!
+        void loadSeriesInformation(SeriesMetadata const& metadata,
+                                   SeriesData* seriesData,
+                                   int basicWindowSlice) const;
+
+        //!
+        //! \brief The prepareSlices method sets the given series data as the
+        //!        destination of the next slice downloads and resets the
+        //!        loading progression.
+        //!
+        //! \param seriesData A pointer to the allocated series data to fill.
+        //! \param permutation The permutation which gives the position of the
+        //!                    slices in the series data.
+        //!
+        //! \return Nothing.
+        //!
+        void prepareSlices(SeriesData* seriesData, AxisPermutation const& permutation);
+
+        //!
+        //! \brief The loadSlices method downloads some instances of the series
+        //!        concurrently and writes each of them at its position in the
+        //!        prepared series data.
+        //!
+        //! The slices are handed to the shared thread pool a few at a time,
+        //! with the current priority of the series. The method returns once
+        //! all the given planes have been processed.
+        //!
+        //! \param series A reference to the Orthanc Series to load.
+        //! \param sliceOrder The instance indexes, in the stacking order.
+        //! \param planes The indexes, in the stack, of the slices to download.
+        //!
+        //! \return A boolean which is true if all the slices were loaded.
+        //!
+        bool loadSlices(OrthancClient::Series& series,
+                        std::vector<unsigned int> const& sliceOrder,
+                        std::vector<unsigned int> const& planes);
 
     private:
+        static unsigned int const s_coarsestSliceStep = 16; // First loaded slices
+
         OrthancClient::OrthancConnection& m_orthanc; // Connexion to Orthanc
+        QString m_user, m_password;                  // Connexion credentials
         QString m_seriesToLoadId;                    // The series id
-        float m_progressValue;                       // The loading progression
+        LoadProgress m_progress;                     // The loading progression
+
+        // State shared with the slice workers
+        QThreadPool& m_slicePool;
+        int m_sliceWindow;                   // Maximum number of started slices
+        QSemaphore m_sliceSlots;             // Available slice starts
+        QMutex m_sliceMutex;
+        SeriesData* m_sliceData;             // The series data being filled
+        void* m_sliceBuffer;                 // The first voxel of the series data
+        int m_sliceScalarType;               // The VTK type of the voxels
+        AxisPermutation m_slicePermutation;  // The position of the slices
+        unsigned int m_sliceWidth, m_sliceHeight, m_sliceCount;
+        bool m_sliceFailure;
+        bool m_canceled;
+        int m_priority;
 };
 
 // The 'progressValue' inline method
-inline float const& LoadSeriesThread::progressValue() const
-{ return m_progressValue; }
+inline float LoadSeriesThread::progressValue() const
+{ return m_progress.value(); }
+
+// The 'progress' inline method
+inline LoadProgress const& LoadSeriesThread::progress() const
+{ return m_progress; }
 
 #endif
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadSliceTask.cpp
+//! \brief The LoadSliceTask.cpp file contains the definition of
+//!        non-inline methods of the LoadSliceTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "LoadSliceTask.h"
+#include "Controller/LoadSeriesThread.h"
+using namespace std;
+
+// Constructor
+LoadSliceTask::LoadSliceTask(LoadSeriesThread& loader, OrthancClient::Instance const& instance,
+                             unsigned int slice)
+    : QRunnable(), m_loader(loader), m_instance(instance), m_slice(slice)
+{}
+
+// Destructor
+LoadSliceTask::~LoadSliceTask()
+{}
+
+// The 'run' method
+void LoadSliceTask::run()
+{
+    // Do not download anything more if another slice already failed
+    if(!m_loader.hasFailed())
+    {
+        try {
+            m_instance.SetImageExtractionMode(m_loader.extractionMode());
+            m_loader.storeSlice(m_slice, m_instance);
+            m_instance.DiscardImage();
+        }
+        catch(OrthancClient::OrthancClientException& e)
+        {
+            cerr << e.What() << endl;
+            m_loader.signalFailure();
+        }
+    }
+
+    m_loader.sliceFinished();
+}
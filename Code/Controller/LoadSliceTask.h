@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadSliceTask.h
+//! \brief The LoadSliceTask.h file contains the interface of the
+//!        LoadSliceTask class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef LOADSLICETASK_H
+#define LOADSLICETASK_H
+
+#include <iostream>
+
+#include <QRunnable>
+
+#include "orthanc/OrthancCppClient.h"
+
+class LoadSeriesThread;
+
+//!
+//! \brief The LoadSliceTask class downloads and decodes a single instance of
+//!        a series and hands its pixels to the LoadSeriesThread which
+//!        launched it.
+//!
+//! The tasks are run by a thread pool, so that several slices of a series
+//! are transferred at the same time on distinct connections.
+//!
+class LoadSliceTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The LoadSliceTask constructor prepares the download of an
+        //!        instance into a given slice of the loaded series.
+        //!
+        //! \param loader A reference to the LoadSeriesThread which receives
+        //!               the slice.
+        //! \param instance The Orthanc instance to download.
+        //! \param slice The index of the instance in the sorted stack of
+        //!              slices, which gives where it must be stored.
+        //!
+        LoadSliceTask(LoadSeriesThread& loader, OrthancClient::Instance const& instance,
+                      unsigned int slice);
+
+        //!
+        //! \brief The LoadSliceTask destructor.
+        //!
+        ~LoadSliceTask();
+
+        //!
+        //! \brief The run method downloads the instance pixels and stores them
+        //!        in the series data of the loader.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        LoadSeriesThread& m_loader;         // The loader which receives the slice
+        OrthancClient::Instance m_instance; // The instance to download
+        unsigned int m_slice;               // The index in the stack
+};
+
+#endif
@@ -38,7 +38,8 @@ using namespace customwidget;
 
 // Constructor
 MergedSeriesInterface::MergedSeriesInterface(QString const& title, QWidget* parent)
-    : DisplayInterface(parent), m_seriesInterfaces()
+    : DisplayInterface(parent), m_seriesInterfaces(), m_registrationFixed(0),
+      m_registrationMoving(0), m_registering(false)
 {
     cout << "Building merged series interface... " << flush;
 
@@ -56,6 +57,11 @@ MergedSeriesInterface::MergedSeriesInterface(QString const& title, QWidget* pare
     m_opacitySlider->setEnabled(false);
     m_toolBar->addWidget(m_opacitySlider);
 
+    m_autoRegisterAction = new QAction("Recalage automatique", m_toolBar);
+    m_autoRegisterAction->setEnabled(false);
+    m_toolBar->addAction(m_autoRegisterAction);
+    m_registrationThread = new RegistrationThread(this);
+
     m_subInterface[VOLUME] = new VolumeSubInterface(new MergedSeriesVolumeViewer());
     m_subInterface[SAGITTAL_SLICE] = new SliceSubInterface(
                 new MergedSeriesSliceViewer(SAGITTAL));
@@ -71,6 +77,8 @@ MergedSeriesInterface::MergedSeriesInterface(QString const& title, QWidget* pare
 
     connect(m_seriesSelector, SIGNAL(currentIndexChanged(int)), this, SLOT(updateToolBarForSeries(int)));
     connect(m_opacitySlider, SIGNAL(doubleValueChanged(double)), this, SLOT(changeCurrentSeriesOpacity(double)));
+    connect(m_autoRegisterAction, SIGNAL(triggered()), this, SLOT(autoRegister()));
+    connect(m_registrationThread, SIGNAL(finished()), this, SLOT(applyRegistration()));
 
     cout << "done." << endl;
 }
@@ -93,6 +101,7 @@ void MergedSeriesInterface::addSeriesInterface(SeriesInterface* interface)
     m_seriesSelector->addItem(interface->title());
     connect(interface, SIGNAL(viewConfigurationChanged(ViewConfiguration const&, ViewConfiguration::ViewParam)),
             this, SLOT(updateViewConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)));
+    connect(interface, SIGNAL(loadingFinished()), this, SLOT(updateAutoRegisterAction()));
 
     for(unsigned int i = 0 ; i < 4 ; i++)
     {
@@ -109,6 +118,7 @@ void MergedSeriesInterface::addSeriesInterface(SeriesInterface* interface)
 
     if(m_seriesInterfaces.size() == 1)
         m_opacitySlider->setDoubleValue(1.0);
+    updateAutoRegisterAction();
 }
 
 // The 'removeSeriesInterface' method
@@ -126,8 +136,17 @@ void MergedSeriesInterface::removeSeriesInterface(SeriesInterface* interface, bo
         msv->unlinkSeriesViewer(sv);
     }
 
+    // A registration must not read the series anymore
+    if(m_registering && (interface == m_registrationFixed || interface == m_registrationMoving))
+    {
+        m_registrationThread->wait();
+        m_registrationFixed = 0;
+        m_registrationMoving = 0;
+    }
+
     disconnect(interface, SIGNAL(viewConfigurationChanged(ViewConfiguration const&, ViewConfiguration::ViewParam)),
                this, SLOT(updateViewConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)));
+    disconnect(interface, SIGNAL(loadingFinished()), this, SLOT(updateAutoRegisterAction()));
     QList<QAction*> actions = interface->getCustomActions();
     for(int i = 0 ; i < actions.size() ; i++)
         m_toolBar->removeAction(actions.at(i));
@@ -161,6 +180,7 @@ void MergedSeriesInterface::removeSeriesInterface(SeriesInterface* interface, bo
 
     if(m_seriesInterfaces.size() == 1)
         m_opacitySlider->setDoubleValue(1.0);
+    updateAutoRegisterAction();
 }
 
 // The 'removeAllSeriesInterface' method
@@ -208,6 +228,9 @@ void MergedSeriesInterface::updateToolBarForSeries(int index)
         m_toolBar->addActions(m_seriesInterfaces.at(index)->getCustomActions());
 
     m_lastSelectedSeriesIndex = index;
+
+    // The registered series follows the selection
+    updateAutoRegisterAction();
 }
 
 // The 'changeCurrentSeriesOpacity' slot
@@ -219,5 +242,79 @@ void MergedSeriesInterface::changeCurrentSeriesOpacity(double opacity)
     SeriesInterface* interface = m_seriesInterfaces.at(m_seriesSelector->currentIndex());
     interface->setPropsOpacity(opacity);
     for(unsigned int i = 0 ; i < 4 ; i++)
-        viewer(i)->repaint();
+        viewer(i)->scheduleRender();
+}
+
+// The 'autoRegister' slot
+void MergedSeriesInterface::autoRegister()
+{
+    SeriesInterface *fixed, *moving;
+    if(m_registering || !registrationPair(fixed, moving))
+        return;
+
+    // The voxels must not change during the search
+    if(fixed->series().isLoading() || moving->series().isLoading())
+        return;
+
+    cout << "Registering " << moving->title().toStdString() << " on "
+         << fixed->title().toStdString() << "... " << endl;
+
+    m_registering = true;
+    m_registrationFixed = fixed;
+    m_registrationMoving = moving;
+    m_autoRegisterAction->setText("Recalage en cours...");
+    updateAutoRegisterAction();
+
+    // The search starts from the current place of the moving series
+    ViewConfiguration const& fixedConfig = fixed->transformConfiguration();
+    m_registrationThread->startRegistration(const_cast<SeriesData*>(&fixed->series()),
+                                            fixedConfig.translation(), fixedConfig.rotation(),
+                                            const_cast<SeriesData*>(&moving->series()),
+                                            moving->transformConfiguration().translation(),
+                                            moving->transformConfiguration().rotation());
+}
+
+// The 'applyRegistration' slot
+void MergedSeriesInterface::applyRegistration()
+{
+    // The series may have left the fusion during the search
+    if(m_registrationMoving != 0 && m_registrationFixed != 0)
+    {
+        m_registrationMoving->setTransform(m_registrationThread->translation(),
+                                           m_registrationThread->rotation());
+        cout << "Registration done (" << m_registrationThread->elapsed() << " ms, similarity "
+             << m_registrationThread->similarity() << ")." << endl;
+    }
+    else
+        cout << "Registration canceled." << endl;
+
+    m_registering = false;
+    m_registrationFixed = 0;
+    m_registrationMoving = 0;
+    m_autoRegisterAction->setText("Recalage automatique");
+    updateAutoRegisterAction();
+}
+
+// The 'updateAutoRegisterAction' slot
+void MergedSeriesInterface::updateAutoRegisterAction()
+{
+    SeriesInterface *fixed, *moving;
+    bool enabled = !m_registering && registrationPair(fixed, moving)
+                   && !fixed->series().isLoading() && !moving->series().isLoading();
+    m_autoRegisterAction->setEnabled(enabled);
+}
+
+// The 'registrationPair' private method
+bool MergedSeriesInterface::registrationPair(SeriesInterface*& fixed, SeriesInterface*& moving) const
+{
+    if(m_seriesInterfaces.size() < 2)
+        return false;
+
+    int index = m_seriesSelector->currentIndex();
+    if(index <= 0 || index >= static_cast<int>(m_seriesInterfaces.size()))
+        index = 1;
+
+    fixed = m_seriesInterfaces.at(0);
+    moving = m_seriesInterfaces.at(index);
+    return true;
 }
@@ -39,11 +39,14 @@
 #include <iostream>
 #include <vector>
 
+#include <QAction>
+
 #include "View/Qt/customwidget/ComboBox.h"
 
 #include "View/Qt/DoubleSlider.h"
 #include "View/VTK/MergedSeriesSliceViewer.h"
 #include "View/VTK/MergedSeriesVolumeViewer.h"
+#include "Controller/RegistrationThread.h"
 #include "Controller/SeriesInterface.h"
 
 //!
@@ -139,10 +142,58 @@ class MergedSeriesInterface : public DisplayInterface
         //!
         void changeCurrentSeriesOpacity(double opacity);
 
+        //!
+        //! \brief The autoRegister slot aligns the selected series on the first
+        //!        series of the fusion, and applies the translation and the
+        //!        rotation found to the selected series.
+        //!
+        //! If the first series is selected, the second one is aligned. The
+        //! search runs in a RegistrationThread, and its result is applied by
+        //! the applyRegistration() slot. Both series must be loaded.
+        //!
+        //! \return Nothing.
+        //!
+        void autoRegister();
+
+        //!
+        //! \brief The applyRegistration slot applies the translation and the
+        //!        rotation found by the registration thread to the aligned
+        //!        series, if it is still part of the fusion.
+        //!
+        //! \return Nothing.
+        //!
+        void applyRegistration();
+
+        //!
+        //! \brief The updateAutoRegisterAction slot enables the automatic
+        //!        registration when two loaded series can be aligned and no
+        //!        registration runs.
+        //!
+        //! \return Nothing.
+        //!
+        void updateAutoRegisterAction();
+
     private:
+        //!
+        //! \brief The registrationPair private method gives the series which
+        //!        the automatic registration would align.
+        //!
+        //! \param fixed A reference which receives the fixed series interface.
+        //! \param moving A reference which receives the moving series interface.
+        //!
+        //! \return A boolean which is true if the fusion has two series.
+        //!
+        bool registrationPair(SeriesInterface*& fixed, SeriesInterface*& moving) const;
+
         std::vector<SeriesInterface*> m_seriesInterfaces;
         customwidget::ComboBox* m_seriesSelector;
         DoubleSlider* m_opacitySlider;
+        QAction* m_autoRegisterAction;
+
+        // The automatic registration being computed
+        RegistrationThread* m_registrationThread; // Owned as a child
+        SeriesInterface *m_registrationFixed, *m_registrationMoving;
+        bool m_registering;
 
         int m_lastSelectedSeriesIndex;
 };
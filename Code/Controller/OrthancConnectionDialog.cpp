@@ -39,7 +39,7 @@ using namespace customwidget;
 
 // Constructor
 OrthancConnectionDialog::OrthancConnectionDialog(QWidget* parent)
-    : OkCancelDialog(parent), m_orthanc(0)
+    : OkCancelDialog(parent), m_orthanc(0), m_browsingOrthanc(0)
 {
     setModal(true);
     setWindowTitle("Connexion");
@@ -69,6 +69,8 @@ OrthancConnectionDialog::~OrthancConnectionDialog()
 {
     if(m_orthanc != 0)
         delete m_orthanc;
+    if(m_browsingOrthanc != 0)
+        delete m_browsingOrthanc;
 }
 
 // The 'accept' slot
@@ -76,18 +78,33 @@ void OrthancConnectionDialog::accept()
 {
     if(m_orthanc != 0)
         delete m_orthanc;
+    if(m_browsingOrthanc != 0)
+        delete m_browsingOrthanc;
+    m_orthanc = 0;
+    m_browsingOrthanc = 0;
 
     setEnabled(false);
 
     try
     {
-        m_orthanc = new OrthancClient::OrthancConnection(computeUrl().toStdString(),
-                                                         m_userLineEdit->text().toStdString(),
-                                                         m_passLineEdit->text().toStdString());
+        string url = computeUrl().toStdString();
+        string user = m_userLineEdit->text().toStdString();
+        string password = m_passLineEdit->text().toStdString();
+
+        // The connection is not thread-safe: the browsing uses its own one
+        m_browsingOrthanc = new OrthancClient::OrthancConnection(url, user, password);
+
+        // The instances information of the loaded series is also retrieved
+        // by several threads
+        m_orthanc = new OrthancClient::OrthancConnection(url, user, password);
+        m_orthanc->SetThreadCount(ProgramConfiguration::instance()->loadingThreadCount());
     }
     catch(OrthancClient::OrthancClientException& e)
     {
         cout << e.What() << endl;
+        if(m_browsingOrthanc != 0)
+            delete m_browsingOrthanc;
+        m_browsingOrthanc = 0;
     }
 
     OkCancelDialog::accept();
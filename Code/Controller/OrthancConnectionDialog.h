@@ -70,7 +70,7 @@ class OrthancConnectionDialog : public OkCancelDialog
         //!
         //! \brief The OrthancConnectionDialog destructor.
         //!
-        //! The OrthancConnection is closed.
+        //! The OrthancConnection objects are closed.
         //!
         ~OrthancConnectionDialog();
 
@@ -85,6 +85,41 @@ class OrthancConnectionDialog : public OkCancelDialog
         //!
         inline OrthancClient::OrthancConnection* orthanc() const;
 
+        //!
+        //! \brief The browsingOrthanc method returns the OrthancConnection
+        //!        object used to browse the Orthanc content.
+        //!
+        //! It is a second connection to the same server, so that the browsing
+        //! requests never use the connection of the loading threads at the
+        //! same time.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A pointer to the browsing OrthancConnection (or 0 if not
+        //!         initialized).
+        //!
+        inline OrthancClient::OrthancConnection* browsingOrthanc() const;
+
+        //!
+        //! \brief The user method returns the user name given to connect to
+        //!        the Orthanc server.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A QString object which contains the user name.
+        //!
+        inline QString user() const;
+
+        //!
+        //! \brief The password method returns the password given to connect
+        //!        to the Orthanc server.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A QString object which contains the password.
+        //!
+        inline QString password() const;
+
     public slots:
         //!
         //! \brief The accept slot close the dialog after trying to initialize
@@ -111,11 +146,22 @@ class OrthancConnectionDialog : public OkCancelDialog
         customwidget::SpinBox* m_portSpinBox;
         customwidget::LineEdit *m_userLineEdit, *m_passLineEdit;
 
-        OrthancClient::OrthancConnection* m_orthanc; // The Orthanc server connexion
+        OrthancClient::OrthancConnection* m_orthanc;         // The Orthanc server connexion
+        OrthancClient::OrthancConnection* m_browsingOrthanc; // The one of the browsing
 };
 
 // The 'orthanc' method
 inline OrthancClient::OrthancConnection* OrthancConnectionDialog::orthanc() const
 { return m_orthanc; }
 
+// The 'browsingOrthanc' method
+inline OrthancClient::OrthancConnection* OrthancConnectionDialog::browsingOrthanc() const
+{ return m_browsingOrthanc; }
+
+// The 'user' method
+inline QString OrthancConnectionDialog::user() const { return m_userLineEdit->text(); }
+
+// The 'password' method
+inline QString OrthancConnectionDialog::password() const { return m_passLineEdit->text(); }
+
 #endif
@@ -39,7 +39,7 @@ using namespace customwidget;
 
 // Constructor
 OrthancDialog::OrthancDialog(QWidget* parent)
-    : OkCancelDialog(parent), m_loadSeriesThread(0)
+    : OkCancelDialog(parent), m_loadsLayout(0), m_loadSeriesManager(0)
 {
     m_orthancConnectionDialog = new OrthancConnectionDialog(this);
     m_orthancConnectionDialog->exec();
@@ -61,26 +61,24 @@ OrthancDialog::OrthancDialog(QWidget* parent)
     m_orthancView->setIndentation(40);
     vLayout->addWidget(m_orthancView);
 
-    m_progressBar = new ProgressBar();
-    m_progressBar->setMinimum(0);
-    m_progressBar->setMaximum(100);
+    m_loadsLayout = new QVBoxLayout();
+    vLayout->addLayout(m_loadsLayout);
     m_progressBarTimer.setInterval(250);
-    vLayout->addWidget(m_progressBar);
 
     setLayout(vLayout);
 
     // Connect signals and slots
     connect(m_refreshButton, SIGNAL(clicked()), this, SLOT(refresh()));
     connect(m_orthancView, SIGNAL(doubleClicked(QModelIndex const&)), this, SLOT(checkSelection(QModelIndex const&)));
-    connect(this, SIGNAL(seriesSelected(QString const&)), this, SLOT(updateProgressBar()));
-    connect(&m_progressBarTimer, SIGNAL(timeout()), this, SLOT(updateProgressBar()));
+    connect(&m_orthancModel, SIGNAL(childrenFetched(QModelIndex const&)), this, SLOT(queueStudySeries(QModelIndex const&)));
+    connect(&m_progressBarTimer, SIGNAL(timeout()), this, SLOT(updateProgressBars()));
 }
 
 // Destructor
 OrthancDialog::~OrthancDialog()
 {
-    if(m_loadSeriesThread != 0)
-        delete m_loadSeriesThread;
+    if(m_loadSeriesManager != 0)
+        delete m_loadSeriesManager;
 }
 
 // The 'connectOrthanc' slot
@@ -89,20 +87,25 @@ void OrthancDialog::connectOrthanc()
     if(m_orthancConnectionDialog->orthanc() == 0)
         throw OrthancClient::OrthancClientException("");
 
-    if(m_loadSeriesThread != 0)
-        delete m_loadSeriesThread;
+    if(m_loadSeriesManager != 0)
+        delete m_loadSeriesManager;
 
-    m_loadSeriesThread = new LoadSeriesThread(*(m_orthancConnectionDialog->orthanc()));
-    connect(this, SIGNAL(seriesSelected(QString const&)), m_loadSeriesThread, SLOT(load(QString const&)));
-    connect(m_loadSeriesThread, SIGNAL(seriesLoaded(SeriesData*)), this, SLOT(sendLoadedSeries(SeriesData*)));
+    m_loadSeriesManager = new LoadSeriesManager(*(m_orthancConnectionDialog->orthanc()),
+                                                m_orthancConnectionDialog->user(),
+                                                m_orthancConnectionDialog->password());
+    connect(m_loadSeriesManager, SIGNAL(seriesLoaded(SeriesData*)), this, SLOT(sendLoadedSeries(SeriesData*)));
+    connect(m_loadSeriesManager, SIGNAL(loadFailed(QString const&)), this, SLOT(signalLoadFailure(QString const&)));
+    connect(m_loadSeriesManager, SIGNAL(loadsChanged()), this, SLOT(updateLoads()));
 
+    m_pendingStudies.clear();
+    updateLoads();
     refresh();
 }
 
 // The 'checkSelection' slot
 void OrthancDialog::checkSelection(QModelIndex const& index)
 {
-    QVariant selection = m_orthancModel.itemFromIndex(index)->data();
+    QVariant selection = index.data(OrthancTreeModel::SeriesIdRole);
     if(!selection.isNull())
         accept();
 }
@@ -113,102 +116,117 @@ void OrthancDialog::accept()
     QItemSelectionModel* selectionModel = m_orthancView->selectionModel();
     QModelIndex selIndex = selectionModel->currentIndex();
 
-    QVariant selection;
+    StandardItem::StandardItemType type = StandardItem::NONE;
     if(selIndex.isValid())
-        selection = m_orthancModel.itemFromIndex(selIndex)->data();
+        type = static_cast<StandardItem::StandardItemType>(selIndex.data(OrthancTreeModel::ItemTypeRole).toInt());
 
-    if(!selIndex.isValid() || selection.isNull())
-        QMessageBox::warning(this, "Aucune série sélectionnée", "Vous devez sélectionner une série avant de valider !");
-    else
+    if(type != StandardItem::SERIES && type != StandardItem::STUDY)
+        QMessageBox::warning(this, "Aucune série sélectionnée", "Vous devez sélectionner une série ou une étude avant de valider !");
+    else if(type == StandardItem::STUDY && !m_orthancModel.isFetched(selIndex))
     {
-        setEnabled(false);
-        ViewerWindow::instance()->changeStatusBarMessage("Chargement de la série en cours...", 0);
-        emit seriesSelected(selection.toString());
+        // The series are queued once the study content is received
+        if(!m_pendingStudies.contains(QPersistentModelIndex(selIndex)))
+            m_pendingStudies.append(QPersistentModelIndex(selIndex));
+        if(m_orthancModel.canFetchMore(selIndex))
+            m_orthancModel.fetchMore(selIndex);
     }
+    else
+        queueSeries(selIndex);
 }
 
 // The 'sendLoadedSeries' slot
 void OrthancDialog::sendLoadedSeries(SeriesData* series)
 {
-    setEnabled(true);
-    ViewerWindow::instance()->clearStatusBarMessage();
-    if(series != 0)
+    emit seriesLoaded(series);
+
+    if(m_loadSeriesManager->pendingCount() == 0 && m_pendingStudies.isEmpty())
     {
-        emit seriesLoaded(series);
+        ViewerWindow::instance()->clearStatusBarMessage();
         OkCancelDialog::accept();
     }
-    else
+}
+
+// The 'signalLoadFailure' slot
+void OrthancDialog::signalLoadFailure(QString const& title)
+{
+    if(m_loadSeriesManager->pendingCount() == 0 && m_pendingStudies.isEmpty())
+        ViewerWindow::instance()->clearStatusBarMessage();
+
+    QMessageBox::critical(this, "Erreur", "Orthanc n'a pas pu charger la série " + title + " !");
+}
+
+// The 'queueStudySeries' slot
+void OrthancDialog::queueStudySeries(QModelIndex const& parent)
+{
+    int position = m_pendingStudies.indexOf(QPersistentModelIndex(parent));
+    if(position < 0)
+        return;
+
+    m_pendingStudies.removeAt(position);
+    queueSeries(parent);
+}
+
+// The 'updateLoads' slot
+void OrthancDialog::updateLoads()
+{
+    if(m_loadsLayout == 0)
+        return;
+
+    for(int i = 0 ; i < m_loadWidgets.size() ; i++)
+        m_loadWidgets.at(i)->deleteLater();
+    m_loadWidgets.clear();
+
+    // One row per series, by decreasing priority
+    QStringList ids = m_loadSeriesManager->seriesIds();
+    for(int i = 0 ; i < ids.size() ; i++)
     {
-        QMessageBox::critical(this, "Erreur", "Orthanc n'a pas pu charger cette série !");
+        LoadProgressWidget* widget = new LoadProgressWidget(ids.at(i), m_loadSeriesManager->title(ids.at(i)));
+        connect(widget, SIGNAL(prioritized(QString const&)), m_loadSeriesManager, SLOT(prioritize(QString const&)));
+        connect(widget, SIGNAL(canceled(QString const&)), m_loadSeriesManager, SLOT(cancel(QString const&)));
+        m_loadsLayout->addWidget(widget);
+        m_loadWidgets.append(widget);
     }
+
+    updateProgressBars();
 }
 
-// The 'updateProgressBar' slot
-void OrthancDialog::updateProgressBar()
+// The 'updateProgressBars' slot
+void OrthancDialog::updateProgressBars()
 {
-    m_progressBar->setValue(ceil(m_loadSeriesThread->progressValue()*100));
-    if(m_progressBar->value() < 100)
+    for(int i = 0 ; i < m_loadWidgets.size() ; i++)
+    {
+        LoadProgressWidget* widget = m_loadWidgets.at(i);
+        widget->setProgress(m_loadSeriesManager->progressValue(widget->seriesId()),
+                            m_loadSeriesManager->progressSummary(widget->seriesId()));
+    }
+
+    if(m_loadWidgets.isEmpty())
+        m_progressBarTimer.stop();
+    else if(!m_progressBarTimer.isActive())
         m_progressBarTimer.start();
-    else
-        m_progressBar->setValue(0);
 }
 
 // The 'refresh' slot
 void OrthancDialog::refresh()
 {
-    if(m_orthancConnectionDialog->orthanc() == 0)
-        return;
-
-    m_orthancConnectionDialog->orthanc()->Reload();
-    constructOrthancModel();
-    repaint();
+    m_pendingStudies.clear();
+    m_orthancModel.setConnection(m_orthancConnectionDialog->browsingOrthanc(),
+                                 m_orthancConnectionDialog->user(),
+                                 m_orthancConnectionDialog->password());
 }
 
-// The 'constructOrthancModel' private method
-void OrthancDialog::constructOrthancModel()
+// The 'queueSeries' private method
+void OrthancDialog::queueSeries(QModelIndex const& index)
 {
-    m_orthancModel.clear();
-    if(m_orthancConnectionDialog->orthanc() == 0)
+    QModelIndexList series = m_orthancModel.seriesIndexes(index);
+    if(series.isEmpty())
         return;
 
-    // Run through patient list
-    for(unsigned int i = 0 ; i < m_orthancConnectionDialog->orthanc()->GetPatientCount() ; i++)
+    ViewerWindow::instance()->changeStatusBarMessage("Chargement des séries en cours...", 0);
+    for(int i = 0 ; i < series.size() ; i++)
     {
-        OrthancClient::Patient patient = m_orthancConnectionDialog->orthanc()->GetPatient(i);
-
-        QString id = patient.GetMainDicomTag("PatientID", "?").c_str();
-        QString name = patient.GetMainDicomTag("PatientName", "?").c_str();
-
-        StandardItem* patientItem = new StandardItem(QString("%1 - %2").arg(id).arg(name), StandardItem::PATIENT);
-        patientItem->setFlags(patientItem->flags() & ~Qt::ItemIsEditable);
-        m_orthancModel.appendRow(patientItem);
-
-        // Run through study list
-        for(unsigned int j = 0 ; j < patient.GetStudyCount() ; j++)
-        {
-            OrthancClient::Study study = patient.GetStudy(j);
-
-            QString date = study.GetMainDicomTag("StudyDate", "").c_str();
-            QString name = study.GetMainDicomTag("StudyDescription", "?").c_str();
-
-            StandardItem* studyItem = new StandardItem(QString("%1 - %2").arg(date).arg(name), StandardItem::STUDY);
-            studyItem->setFlags(studyItem->flags() & ~Qt::ItemIsEditable);
-            patientItem->appendRow(studyItem);
-
-            // Run through series list
-            for(unsigned int k = 0 ; k < study.GetSeriesCount() ; k++)
-            {
-                OrthancClient::Series series = study.GetSeries(k);
-                QString name = series.GetMainDicomTag("SeriesDescription", "?").c_str();
-
-                if(series.Is3DImage())
-                {
-                    StandardItem* seriesItem = new StandardItem(QString("%1 (%2)").arg(name).arg(series.GetInstanceCount()), StandardItem::SERIES);
-                    seriesItem->setFlags(seriesItem->flags() & ~Qt::ItemIsEditable);
-                    seriesItem->setData(QString(series.GetId().c_str()));
-                    studyItem->appendRow(seriesItem);
-                }
-            }
-        }
+        QString seriesId = series.at(i).data(OrthancTreeModel::SeriesIdRole).toString();
+        m_loadSeriesManager->load(seriesId, series.at(i).data(Qt::DisplayRole).toString());
+        emit seriesSelected(seriesId);
     }
 }
@@ -40,25 +40,28 @@
 #include <cmath>
 
 #include <QLayout>
+#include <QList>
 #include <QMessageBox>
-#include <QStandardItemModel>
+#include <QPersistentModelIndex>
 #include <QTimer>
 #include <QTreeView>
 
 #include "View/Qt/customwidget/PushButton.h"
-#include "View/Qt/customwidget/ProgressBar.h"
-#include "View/Qt/customwidget/PushButton.h"
-#include "View/Qt/customwidget/StandardItem.h"
 #include "View/Qt/customwidget/TreeView.h"
 
 #include "Model/SeriesData.h"
+#include "View/Qt/LoadProgressWidget.h"
 #include "View/Qt/OkCancelDialog.h"
-#include "Controller/LoadSeriesThread.h"
+#include "Controller/LoadSeriesManager.h"
 #include "Controller/OrthancConnectionDialog.h"
+#include "Controller/OrthancTreeModel.h"
 
 //!
 //! \brief The OrthancDialog class maintains a connexion with the Orthanc
-//!        server and permits to the user to select and load a series.
+//!        server and permits to the user to select and load series.
+//!
+//! Several series can be queued, each one is shown with its progression and
+//! can be prioritized or canceled.
 //!
 class OrthancDialog : public OkCancelDialog
 {
@@ -82,7 +85,7 @@ class OrthancDialog : public OkCancelDialog
         //!
         //! \brief The connectOrthanc slot uses the internal connection of its
         //!        connection dialog to load the Orthanc content and initialize
-        //!        the series loading thread.
+        //!        the series loading manager.
         //!
         //! The method does nothing if the orthanc connection had not been
         //! initialized.
@@ -104,21 +107,25 @@ class OrthancDialog : public OkCancelDialog
 
         //!
         //! \brief The accept slot checks the selection in the tree view widget.
-        //!        If it is a series, it emits the corresponding signal and if
-        //!        not, it runs a message box to indicate it to the user.
+        //!        If it is a series, it is queued for loading, if it is a
+        //!        study, all its series are queued and if not, it runs a
+        //!        message box to indicate it to the user.
+        //!
+        //! The series of a study which is not fetched yet are queued once the
+        //! Orthanc content has been received.
         //!
         //! \section emit
-        //! The seriesSelected(QString) signal is emitted, if the selection is
-        //! a series (and not a patient or a study).
+        //! The seriesSelected(QString) signal is emitted for each queued
+        //! series.
         //!
         //! \return Nothing.
         //!
         void accept();
 
         //!
-        //! \brief The sendLoadedSeries slot indicates that the dialog has
-        //!        been valided (and so close it) and transfers the loaded
-        //!        series.
+        //! \brief The sendLoadedSeries slot transfers a loaded series and
+        //!        closes the dialog once all the requested series have been
+        //!        transferred.
         //!
         //! \section emit
         //! The seriesLoaded(SeriesData*) signal is emitted.
@@ -131,17 +138,46 @@ class OrthancDialog : public OkCancelDialog
         void sendLoadedSeries(SeriesData* series);
 
         //!
-        //! \brief The updateProgressBar slot updates the progress bar value
-        //!        according to the progression value of the LoadSeriesThread
-        //!        and then starts the progress bar timer.
+        //! \brief The signalLoadFailure slot indicates to the user that a
+        //!        series could not be loaded.
+        //!
+        //! \param title A QString object which describes the series.
+        //!
+        //! \return Nothing.
+        //!
+        void signalLoadFailure(QString const& title);
+
+        //!
+        //! \brief The queueStudySeries slot queues the series of a study whose
+        //!        loading was requested before the study was fetched.
+        //!
+        //! \param parent The index of the fetched item.
         //!
         //! \return Nothing.
         //!
-        void updateProgressBar();
+        void queueStudySeries(QModelIndex const& parent);
+
+        //!
+        //! \brief The updateLoads slot rebuilds the list of the loading
+        //!        series.
+        //!
+        //! \return Nothing.
+        //!
+        void updateLoads();
+
+        //!
+        //! \brief The updateProgressBars slot updates the progress bar, the
+        //!        transfer rate and the remaining time of each loading series.
+        //!
+        //! \return Nothing.
+        //!
+        void updateProgressBars();
 
         //!
         //! \brief The refresh slot refreshes the orthanc patient list.
         //!
+        //! The list is reloaded in the background, the dialog stays usable.
+        //!
         //! \return Nothing.
         //!
         void refresh();
@@ -160,30 +196,34 @@ class OrthancDialog : public OkCancelDialog
         //!        loaded series data.
         //!
         //! \param series A pointer to a SeriesData object which contains
-        //!               the fully loaded 3D series.
+        //!               the 3D series.
         //!
         void seriesLoaded(SeriesData* series);
 
     private:
+        //!
+        //! \brief The queueSeries private method queues the loading of the
+        //!        series of an item.
+        //!
+        //! \param index The index of a series or of a fetched study.
+        //!
+        //! \return Nothing.
+        //!
+        void queueSeries(QModelIndex const& index);
+
         OrthancConnectionDialog* m_orthancConnectionDialog;
 
         customwidget::PushButton* m_refreshButton;
 
         customwidget::TreeView* m_orthancView;      // For Orthanc content
-        QStandardItemModel m_orthancModel;          // For Orthanc content
-        customwidget::ProgressBar* m_progressBar;   // For loading progression
-        QTimer m_progressBarTimer;          // To control progression updating
+        OrthancTreeModel m_orthancModel;            // For Orthanc content
+        QList<QPersistentModelIndex> m_pendingStudies; // Studies to fetch first
 
-        LoadSeriesThread* m_loadSeriesThread;        // For loading the series
+        QVBoxLayout* m_loadsLayout;                 // For loading progression
+        QList<LoadProgressWidget*> m_loadWidgets;   // One per loading series
+        QTimer m_progressBarTimer;          // To control progression updating
 
-        //!
-        //! \brief The constructOrthancModel private method loads Orthanc data
-        //!        from the server to the model which will be visualized in the
-        //!        OrthancDialog.
-        //!
-        //! \return Nothing.
-        //!
-        void constructOrthancModel();
+        LoadSeriesManager* m_loadSeriesManager;     // For loading the series
 };
 
 #endif
@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file OrthancTreeFetchTask.cpp
+//! \brief The OrthancTreeFetchTask.cpp file contains the definition of
+//!        non-inline methods of the OrthancTreeFetchTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "OrthancTreeFetchTask.h"
+using namespace std;
+using namespace customwidget;
+
+// Constructor
+OrthancTreeFetchTask::OrthancTreeFetchTask(OrthancTreeModel& model,
+                                           OrthancClient::OrthancConnection& orthanc,
+                                           QString const& user, QString const& password,
+                                           OrthancTreeFetch* fetch)
+    : QRunnable(), m_model(model), m_orthanc(orthanc), m_user(user), m_password(password),
+      m_fetch(fetch)
+{}
+
+// Destructor
+OrthancTreeFetchTask::~OrthancTreeFetchTask()
+{}
+
+// The 'run' method
+void OrthancTreeFetchTask::run()
+{
+    try {
+        switch(m_fetch->type)
+        {
+            case StandardItem::NONE:
+                fetchPatients();
+                break;
+
+            case StandardItem::PATIENT:
+            {
+                // Run through study list
+                OrthancClient::Patient patient(m_orthanc, m_fetch->patient.toStdString());
+                for(unsigned int j = 0 ; j < patient.GetStudyCount() ; j++)
+                {
+                    OrthancClient::Study study = patient.GetStudy(j);
+
+                    QString date = study.GetMainDicomTag("StudyDate", "").c_str();
+                    QString name = study.GetMainDicomTag("StudyDescription", "?").c_str();
+
+                    m_fetch->ids.append(QString(study.GetId().c_str()));
+                    m_fetch->texts.append(QString("%1 - %2").arg(date).arg(name));
+                }
+
+                m_fetch->childCount = m_fetch->texts.size();
+                break;
+            }
+
+            case StandardItem::STUDY:
+            {
+                // Run through series list
+                OrthancClient::Study study(m_orthanc, m_fetch->study.toStdString());
+                for(unsigned int k = 0 ; k < study.GetSeriesCount() ; k++)
+                {
+                    OrthancClient::Series series = study.GetSeries(k);
+                    QString name = series.GetMainDicomTag("SeriesDescription", "?").c_str();
+
+                    if(series.Is3DImage())
+                    {
+                        m_fetch->ids.append(QString(series.GetId().c_str()));
+                        m_fetch->texts.append(QString("%1 (%2)").arg(name).arg(series.GetInstanceCount()));
+                    }
+                }
+
+                m_fetch->childCount = m_fetch->texts.size();
+                break;
+            }
+
+            case StandardItem::SERIES:
+                break;
+        }
+    }
+    catch(OrthancClient::OrthancClientException& e)
+    {
+        cerr << e.What() << endl;
+        m_fetch->failed = true;
+    }
+
+    m_model.addFetchResult(m_fetch);
+}
+
+// The 'fetchPatients' private method
+void OrthancTreeFetchTask::fetchPatients()
+{
+    // The number of patients on the server
+    QRegExp countExp("\"CountPatients\"\\s*:\\s*(\\d+)");
+    if(countExp.indexIn(get("/statistics")) < 0)
+        throw OrthancClient::OrthancClientException("Invalid answer of Orthanc");
+    m_fetch->childCount = countExp.cap(1).toInt();
+
+    // The page of patients, expanded with their main tags
+    QString path = QString("/patients?expand&since=%1").arg(m_fetch->first);
+    if(m_fetch->count >= 0)
+        path += QString("&limit=%1").arg(m_fetch->count);
+    QString answer = get(path);
+
+    // Each patient begins with its id, as the members are sorted by name
+    QRegExp idExp("\"ID\"\\s*:\\s*\"([^\"]*)\"");
+    int pos = idExp.indexIn(answer);
+    while(pos >= 0)
+    {
+        QString id = idExp.cap(1);
+        int next = idExp.indexIn(answer, pos + idExp.matchedLength());
+        QString patient = answer.mid(pos, (next >= 0) ? next - pos : -1);
+
+        QString patientId = jsonString(patient, "PatientID", "?");
+        QString name = jsonString(patient, "PatientName", "?");
+
+        m_fetch->ids.append(id);
+        m_fetch->texts.append(QString("%1 - %2").arg(patientId).arg(name));
+
+        pos = next;
+    }
+}
+
+// The 'get' private method
+QString OrthancTreeFetchTask::get(QString const& path) const
+{
+    QString url = string(m_orthanc.GetOrthancUrl()).c_str();
+    if(!url.contains("://"))
+        url.prepend("http://");
+
+    QNetworkRequest request(QUrl(url + path));
+    if(!m_user.isEmpty())
+        request.setRawHeader("Authorization", "Basic " + (m_user + ":" + m_password).toUtf8().toBase64());
+
+    // Wait for the answer (at most a few seconds)
+    QNetworkAccessManager manager;
+    QNetworkReply* reply = manager.get(request);
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    QTimer::singleShot(10000, &loop, SLOT(quit()));
+    loop.exec();
+
+    bool succeeded = reply->isFinished() && reply->error() == QNetworkReply::NoError;
+    QString answer = succeeded ? QString::fromUtf8(reply->readAll()) : QString("");
+    reply->abort();
+    reply->deleteLater();
+
+    if(!succeeded)
+        throw OrthancClient::OrthancClientException("Cannot reach Orthanc at " + url.toStdString());
+
+    return answer;
+}
+
+// The 'jsonString' private static method
+QString OrthancTreeFetchTask::jsonString(QString const& json, QString const& name,
+                                         QString const& defaultValue)
+{
+    QRegExp exp("\"" + QRegExp::escape(name) + "\"\\s*:\\s*\"((?:[^\"\\\\]|\\\\.)*)\"");
+    if(exp.indexIn(json) < 0)
+        return defaultValue;
+
+    // Unescape the value
+    QString escaped = exp.cap(1), value;
+    for(int i = 0 ; i < escaped.size() ; i++)
+    {
+        QChar c = escaped.at(i);
+        if(c == '\\' && i + 1 < escaped.size())
+        {
+            c = escaped.at(++i);
+            if(c == 'n')
+                c = '\n';
+            else if(c == 't')
+                c = '\t';
+            else if(c == 'u' && i + 4 < escaped.size())
+            {
+                c = QChar(escaped.mid(i + 1, 4).toUShort(0, 16));
+                i += 4;
+            }
+        }
+        value += c;
+    }
+
+    return value;
+}
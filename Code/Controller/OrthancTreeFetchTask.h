@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file OrthancTreeFetchTask.h
+//! \brief The OrthancTreeFetchTask.h file contains the interface of the
+//!        OrthancTreeFetchTask class and the definitions of its inline
+//!        methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef ORTHANCTREEFETCHTASK_H
+#define ORTHANCTREEFETCHTASK_H
+
+#include <QByteArray>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QRegExp>
+#include <QRunnable>
+#include <QTimer>
+#include <QUrl>
+
+#include "orthanc/OrthancCppClient.h"
+
+#include "Controller/OrthancTreeModel.h"
+
+//!
+//! \brief The OrthancTreeFetchTask class reads, in a background thread, the
+//!        children of a node of the OrthancTreeModel from the Orthanc server.
+//!
+//! Once the request has run, its result is given back to the model, which
+//! inserts it in its own thread.
+//!
+//! The Orthanc client reads the whole patient list on its first access, with
+//! one request per patient. The pages of patients are therefore read through
+//! the REST API of the server instead ("/patients?expand&since=&limit="), and
+//! the client only reads the studies and series of the expanded nodes.
+//!
+class OrthancTreeFetchTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The OrthancTreeFetchTask constructor prepares a request.
+        //!
+        //! \param model A reference to the model which receives the result.
+        //! \param orthanc A reference to the Orthanc connection to read.
+        //! \param user The user name of the REST requests.
+        //! \param password The password of the REST requests.
+        //! \param fetch A pointer to the request description, which is
+        //!              completed by the task.
+        //!
+        OrthancTreeFetchTask(OrthancTreeModel& model,
+                             OrthancClient::OrthancConnection& orthanc,
+                             QString const& user, QString const& password,
+                             OrthancTreeFetch* fetch);
+
+        //!
+        //! \brief The OrthancTreeFetchTask destructor.
+        //!
+        ~OrthancTreeFetchTask();
+
+        //!
+        //! \brief The run method reads the requested children and hands the
+        //!        result to the model.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        //!
+        //! \brief The fetchPatients private method reads a page of the patient
+        //!        list, and the number of patients, through the REST API.
+        //!
+        //! \return Nothing.
+        //!
+        void fetchPatients();
+
+        //!
+        //! \brief The get private method sends a GET request to the REST API
+        //!        of the server and waits for the answer.
+        //!
+        //! An OrthancClientException is thrown if the request fails.
+        //!
+        //! \param path The path of the request (e.g. "/statistics").
+        //!
+        //! \return A QString object which contains the answer.
+        //!
+        QString get(QString const& path) const;
+
+        //!
+        //! \brief The jsonString private static method reads a string member
+        //!        in a JSON text.
+        //!
+        //! \param json The JSON text.
+        //! \param name The name of the member.
+        //! \param defaultValue The value to return if there is no such member.
+        //!
+        //! \return A QString object which contains the unescaped value.
+        //!
+        static QString jsonString(QString const& json, QString const& name,
+                                  QString const& defaultValue = "");
+
+        OrthancTreeModel& m_model;
+        OrthancClient::OrthancConnection& m_orthanc;
+        QString m_user, m_password;
+        OrthancTreeFetch* m_fetch;
+};
+
+#endif
@@ -0,0 +1,330 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file OrthancTreeModel.cpp
+//! \brief The OrthancTreeModel.cpp file contains the definition of
+//!        non-inline methods of the OrthancTreeModel class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "OrthancTreeModel.h"
+#include "Controller/OrthancTreeFetchTask.h"
+using namespace std;
+using namespace customwidget;
+
+// Constructor
+OrthancTreeModel::OrthancTreeModel(QObject* parent)
+    : QAbstractItemModel(parent), m_orthanc(0), m_generation(0)
+{
+    m_root = createNode(StandardItem::NONE, "", 0);
+
+    // The connection of the model is not shared with the loading threads, and
+    // its requests are sent one at a time
+    m_fetchPool.setMaxThreadCount(1);
+}
+
+// Destructor
+OrthancTreeModel::~OrthancTreeModel()
+{
+    m_fetchPool.waitForDone();
+
+    for(int i = 0 ; i < m_results.size() ; i++)
+        delete m_results.at(i);
+    deleteNode(m_root);
+}
+
+// The 'setConnection' method
+void OrthancTreeModel::setConnection(OrthancClient::OrthancConnection* orthanc,
+                                     QString const& user, QString const& password)
+{
+    m_orthanc = orthanc;
+    m_user = user;
+    m_password = password;
+    refresh();
+}
+
+// The 'addFetchResult' method
+void OrthancTreeModel::addFetchResult(OrthancTreeFetch* fetch)
+{
+    QMutexLocker locker(&m_resultMutex);
+    m_results.append(fetch);
+
+    QMetaObject::invokeMethod(this, "processFetchResults", Qt::QueuedConnection);
+}
+
+// The 'index' method
+QModelIndex OrthancTreeModel::index(int row, int column, QModelIndex const& parent) const
+{
+    if(!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    return createIndex(row, column, nodeFromIndex(parent)->children.at(row));
+}
+
+// The 'parent' method
+QModelIndex OrthancTreeModel::parent(QModelIndex const& index) const
+{
+    if(!index.isValid())
+        return QModelIndex();
+
+    OrthancTreeNode* parentNode = nodeFromIndex(index)->parent;
+    if(parentNode == m_root)
+        return QModelIndex();
+
+    return createIndex(parentNode->parent->children.indexOf(parentNode), 0, parentNode);
+}
+
+// The 'rowCount' method
+int OrthancTreeModel::rowCount(QModelIndex const& parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+
+    return nodeFromIndex(parent)->children.size();
+}
+
+// The 'columnCount' method
+int OrthancTreeModel::columnCount(QModelIndex const& parent) const
+{
+    return 1;
+}
+
+// The 'data' method
+QVariant OrthancTreeModel::data(QModelIndex const& index, int role) const
+{
+    if(!index.isValid())
+        return QVariant();
+
+    if(role == ItemTypeRole)
+        return static_cast<int>(nodeFromIndex(index)->type);
+
+    return nodeFromIndex(index)->item->data(role);
+}
+
+// The 'flags' method
+Qt::ItemFlags OrthancTreeModel::flags(QModelIndex const& index) const
+{
+    if(!index.isValid())
+        return 0;
+
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+// The 'hasChildren' method
+bool OrthancTreeModel::hasChildren(QModelIndex const& parent) const
+{
+    OrthancTreeNode* node = nodeFromIndex(parent);
+    if(node->type == StandardItem::SERIES)
+        return false;
+
+    // While the children are unknown, the node can be expanded
+    return node->childCount != 0;
+}
+
+// The 'canFetchMore' method
+bool OrthancTreeModel::canFetchMore(QModelIndex const& parent) const
+{
+    OrthancTreeNode* node = nodeFromIndex(parent);
+    if(m_orthanc == 0 || node->fetching || node->type == StandardItem::SERIES)
+        return false;
+
+    return node->childCount < 0 || node->children.size() < node->childCount;
+}
+
+// The 'fetchMore' method
+void OrthancTreeModel::fetchMore(QModelIndex const& parent)
+{
+    if(canFetchMore(parent))
+        startFetch(nodeFromIndex(parent));
+}
+
+// The 'isFetched' method
+bool OrthancTreeModel::isFetched(QModelIndex const& index) const
+{
+    OrthancTreeNode* node = nodeFromIndex(index);
+    return !node->fetching && node->childCount >= 0 && node->children.size() >= node->childCount;
+}
+
+// The 'seriesIndexes' method
+QModelIndexList OrthancTreeModel::seriesIndexes(QModelIndex const& index) const
+{
+    QModelIndexList indexes;
+    if(!index.isValid())
+        return indexes;
+
+    OrthancTreeNode* node = nodeFromIndex(index);
+    if(node->type == StandardItem::SERIES)
+        indexes.append(index);
+    else if(node->type == StandardItem::STUDY)
+    {
+        for(int i = 0 ; i < node->children.size() ; i++)
+            indexes.append(createIndex(i, 0, node->children.at(i)));
+    }
+
+    return indexes;
+}
+
+// The 'refresh' slot
+void OrthancTreeModel::refresh()
+{
+    // Forget the current tree and the requests which are still running
+    beginResetModel();
+    m_generation++;
+    deleteNode(m_root);
+    m_root = createNode(StandardItem::NONE, "", 0);
+    endResetModel();
+
+    if(m_orthanc != 0)
+        startFetch(m_root);
+}
+
+// The 'processFetchResults' slot
+void OrthancTreeModel::processFetchResults()
+{
+    QList<OrthancTreeFetch*> results;
+    m_resultMutex.lock();
+    results.swap(m_results);
+    m_resultMutex.unlock();
+
+    for(int i = 0 ; i < results.size() ; i++)
+    {
+        OrthancTreeFetch* fetch = results.at(i);
+
+        // The nodes of an older generation do not exist anymore
+        if(fetch->generation != m_generation)
+        {
+            delete fetch;
+            continue;
+        }
+
+        OrthancTreeNode* node = fetch->node;
+        QModelIndex parentIndex;
+        if(node != m_root)
+            parentIndex = createIndex(node->parent->children.indexOf(node), 0, node);
+
+        node->fetching = false;
+        if(fetch->failed)
+        {
+            cerr << "Orthanc content could not be fetched." << endl;
+            node->childCount = node->children.size();
+        }
+        else
+        {
+            // The patients, studies and series are children of each other
+            StandardItem::StandardItemType childType = StandardItem::SERIES;
+            if(node->type == StandardItem::NONE)
+                childType = StandardItem::PATIENT;
+            else if(node->type == StandardItem::PATIENT)
+                childType = StandardItem::STUDY;
+
+            if(!fetch->texts.isEmpty())
+            {
+                int first = node->children.size();
+                beginInsertRows(parentIndex, first, first + fetch->texts.size() - 1);
+                for(int j = 0 ; j < fetch->texts.size() ; j++)
+                {
+                    OrthancTreeNode* child = createNode(childType, fetch->texts.at(j), node);
+                    if(childType == StandardItem::PATIENT)
+                        child->patient = fetch->ids.at(j);
+                    else if(childType == StandardItem::STUDY)
+                        child->study = fetch->ids.at(j);
+                    else
+                        child->item->setData(fetch->ids.at(j), SeriesIdRole);
+
+                    node->children.append(child);
+                }
+                endInsertRows();
+            }
+
+            node->childCount = fetch->childCount;
+        }
+
+        // The expansion indicator may have changed
+        if(node != m_root && node->children.isEmpty())
+            emit dataChanged(parentIndex, parentIndex);
+
+        if(node->children.size() >= node->childCount)
+            emit childrenFetched(parentIndex);
+
+        delete fetch;
+    }
+}
+
+// The 'nodeFromIndex' private method
+OrthancTreeNode* OrthancTreeModel::nodeFromIndex(QModelIndex const& index) const
+{
+    if(!index.isValid())
+        return m_root;
+
+    return static_cast<OrthancTreeNode*>(index.internalPointer());
+}
+
+// The 'createNode' private method
+OrthancTreeNode* OrthancTreeModel::createNode(StandardItem::StandardItemType type,
+                                              QString const& text,
+                                              OrthancTreeNode* parent) const
+{
+    OrthancTreeNode* node = new OrthancTreeNode;
+    node->type = type;
+    node->patient = (parent != 0) ? parent->patient : "";
+    node->study = (parent != 0) ? parent->study : "";
+    node->item = new StandardItem(text, type);
+    node->parent = parent;
+    node->childCount = (type == StandardItem::SERIES) ? 0 : -1;
+    node->fetching = false;
+
+    return node;
+}
+
+// The 'deleteNode' private method
+void OrthancTreeModel::deleteNode(OrthancTreeNode* node) const
+{
+    for(int i = 0 ; i < node->children.size() ; i++)
+        deleteNode(node->children.at(i));
+
+    delete node->item;
+    delete node;
+}
+
+// The 'startFetch' private method
+void OrthancTreeModel::startFetch(OrthancTreeNode* node)
+{
+    OrthancTreeFetch* fetch = new OrthancTreeFetch;
+    fetch->generation = m_generation;
+    fetch->node = node;
+    fetch->type = node->type;
+    fetch->patient = node->patient;
+    fetch->study = node->study;
+    fetch->first = node->children.size();
+    fetch->count = (node == m_root) ? s_pageSize : -1; // Only the patients are paged
+    fetch->failed = false;
+    fetch->childCount = 0;
+
+    node->fetching = true;
+    m_fetchPool.start(new OrthancTreeFetchTask(*this, *m_orthanc, m_user, m_password, fetch));
+}
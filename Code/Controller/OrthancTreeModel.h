@@ -0,0 +1,376 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file OrthancTreeModel.h
+//! \brief The OrthancTreeModel.h file contains the interface of the
+//!        OrthancTreeModel class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef ORTHANCTREEMODEL_H
+#define ORTHANCTREEMODEL_H
+
+#include <iostream>
+
+#include <QAbstractItemModel>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "orthanc/OrthancCppClient.h"
+
+#include "View/Qt/customwidget/StandardItem.h"
+
+//!
+//! \brief The OrthancTreeNode structure represents a patient, a study or a
+//!        series of the Orthanc server in the OrthancTreeModel.
+//!
+struct OrthancTreeNode
+{
+    //! The kind of node (NONE for the root)
+    customwidget::StandardItem::StandardItemType type;
+
+    //! The Orthanc ids of the patient and of the study
+    QString patient, study;
+
+    //! The item which holds the text and the look of the node
+    customwidget::StandardItem* item;
+
+    OrthancTreeNode* parent;
+    QList<OrthancTreeNode*> children;
+
+    //! The number of children on the server (-1 while unknown)
+    int childCount;
+
+    //! True while a fetch of children is running for the node
+    bool fetching;
+};
+
+//!
+//! \brief The OrthancTreeFetch structure describes a request for children of
+//!        a node and, once run, its result.
+//!
+struct OrthancTreeFetch
+{
+    unsigned int generation;   // The model generation of the request
+    OrthancTreeNode* node;     // The node whose children are fetched
+
+    customwidget::StandardItem::StandardItemType type; // The type of the node
+    QString patient, study;    // The Orthanc ids of the node
+    int first, count;          // The range of children to fetch
+
+    bool failed;               // True if Orthanc could not be reached
+    int childCount;            // The number of children on the server
+    QStringList ids;           // The Orthanc ids of the fetched children
+    QStringList texts;         // The text of the fetched children
+};
+
+//!
+//! \brief The OrthancTreeModel class presents the patients, studies and series
+//!        of an Orthanc server as a tree, without blocking the user interface.
+//!
+//! The children of a node are only fetched when the node is expanded, and the
+//! requests to the Orthanc server are run by a background thread. The
+//! patients are requested by pages as the view is scrolled, through the REST
+//! API of the server, so that a page only costs one request whatever the
+//! number of patients.
+//!
+class OrthancTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+    public:
+        //! The role of the data which contains the id of a series
+        static int const SeriesIdRole = Qt::UserRole + 1;
+
+        //! The role of the data which contains the type of an item
+        static int const ItemTypeRole = Qt::UserRole + 2;
+
+        //!
+        //! \brief The OrthancTreeModel constructor initializes an empty model.
+        //!
+        //! \param parent A pointer to the parent QObject.
+        //!
+        OrthancTreeModel(QObject* parent = 0);
+
+        //!
+        //! \brief The OrthancTreeModel destructor waits for the running
+        //!        requests before freeing the nodes.
+        //!
+        ~OrthancTreeModel();
+
+        //!
+        //! \brief The setConnection method sets the Orthanc connection the
+        //!        model presents and refreshes it.
+        //!
+        //! The connection is used by the background requests, so no other
+        //! thread may use it.
+        //!
+        //! \param orthanc A pointer to the OrthancConnection to use (or 0).
+        //! \param user The user name of the REST requests.
+        //! \param password The password of the REST requests.
+        //!
+        //! \return Nothing.
+        //!
+        void setConnection(OrthancClient::OrthancConnection* orthanc,
+                           QString const& user = "", QString const& password = "");
+
+        //!
+        //! \brief The addFetchResult method is called by the background
+        //!        requests to hand their result to the model.
+        //!
+        //! The method is thread-safe, the result is inserted in the model
+        //! later, in the thread of the model.
+        //!
+        //! \param fetch A pointer to the completed request (the model takes
+        //!              its ownership).
+        //!
+        //! \return Nothing.
+        //!
+        void addFetchResult(OrthancTreeFetch* fetch);
+
+        //!
+        //! \brief The index method returns the index of an item.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param row The row of the item.
+        //! \param column The column of the item.
+        //! \param parent The index of the parent item.
+        //!
+        //! \return The QModelIndex of the item.
+        //!
+        QModelIndex index(int row, int column, QModelIndex const& parent = QModelIndex()) const;
+
+        //!
+        //! \brief The parent method returns the index of the parent of an
+        //!        item.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param index The index of the item.
+        //!
+        //! \return The QModelIndex of the parent item.
+        //!
+        QModelIndex parent(QModelIndex const& index) const;
+
+        //!
+        //! \brief The rowCount method returns the number of children which
+        //!        have been inserted under an item.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param parent The index of the item.
+        //!
+        //! \return The number of rows under the item.
+        //!
+        int rowCount(QModelIndex const& parent = QModelIndex()) const;
+
+        //!
+        //! \brief The columnCount method returns the number of columns of the
+        //!        model (always 1).
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param parent The index of the item.
+        //!
+        //! \return The number of columns.
+        //!
+        int columnCount(QModelIndex const& parent = QModelIndex()) const;
+
+        //!
+        //! \brief The data method returns the data of an item for a role.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //! The series id of a series item is given by the SeriesIdRole and
+        //! the type of any item by the ItemTypeRole.
+        //!
+        //! \param index The index of the item.
+        //! \param role The role of the data.
+        //!
+        //! \return A QVariant object which contains the data.
+        //!
+        QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const;
+
+        //!
+        //! \brief The flags method returns the flags of an item (which is
+        //!        selectable but not editable).
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param index The index of the item.
+        //!
+        //! \return The flags of the item.
+        //!
+        Qt::ItemFlags flags(QModelIndex const& index) const;
+
+        //!
+        //! \brief The hasChildren method indicates if an item has, or may
+        //!        have, children.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param parent The index of the item.
+        //!
+        //! \return A boolean which is true if the item may have children.
+        //!
+        bool hasChildren(QModelIndex const& parent = QModelIndex()) const;
+
+        //!
+        //! \brief The canFetchMore method indicates if some children of an
+        //!        item are still to be fetched.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param parent The index of the item.
+        //!
+        //! \return A boolean which is true if children can be fetched.
+        //!
+        bool canFetchMore(QModelIndex const& parent) const;
+
+        //!
+        //! \brief The fetchMore method starts the background fetch of the
+        //!        next children of an item.
+        //!
+        //! This is an implementation of the QAbstractItemModel method.
+        //!
+        //! \param parent The index of the item.
+        //!
+        //! \return Nothing.
+        //!
+        void fetchMore(QModelIndex const& parent);
+
+        //!
+        //! \brief The isFetched method indicates if all the children of an
+        //!        item have been inserted in the model.
+        //!
+        //! \param index The index of the item.
+        //!
+        //! \return A boolean which is true if the children are all known.
+        //!
+        bool isFetched(QModelIndex const& index) const;
+
+        //!
+        //! \brief The seriesIndexes method returns the series which can be
+        //!        loaded from an item.
+        //!
+        //! A series item gives itself and a study item gives its fetched
+        //! series.
+        //!
+        //! \param index The index of the item.
+        //!
+        //! \return A list of series indexes (empty for the other items).
+        //!
+        QModelIndexList seriesIndexes(QModelIndex const& index) const;
+
+    public slots:
+        //!
+        //! \brief The refresh slot clears the model and reloads the patient
+        //!        list from the Orthanc server.
+        //!
+        //! \return Nothing.
+        //!
+        void refresh();
+
+        //!
+        //! \brief The processFetchResults slot inserts in the model the
+        //!        children fetched by the background requests.
+        //!
+        //! The results of the requests started before the last refresh are
+        //! dropped.
+        //!
+        //! \return Nothing.
+        //!
+        void processFetchResults();
+
+    signals:
+        //!
+        //! \brief The childrenFetched signal, once emitted, indicates that all
+        //!        the children of an item have been inserted in the model.
+        //!
+        //! \param parent The index of the item.
+        //!
+        void childrenFetched(QModelIndex const& parent);
+
+    private:
+        //!
+        //! \brief The nodeFromIndex private method returns the node of an
+        //!        index (the root for an invalid index).
+        //!
+        //! \param index The index of the item.
+        //!
+        //! \return A pointer to the node.
+        //!
+        OrthancTreeNode* nodeFromIndex(QModelIndex const& index) const;
+
+        //!
+        //! \brief The createNode private method creates a node and its item.
+        //!
+        //! \param type The type of the node.
+        //! \param text The text of the node.
+        //! \param parent A pointer to the parent node.
+        //!
+        //! \return A pointer to the new node.
+        //!
+        OrthancTreeNode* createNode(customwidget::StandardItem::StandardItemType type,
+                                    QString const& text, OrthancTreeNode* parent) const;
+
+        //!
+        //! \brief The deleteNode private method frees a node and its
+        //!        children.
+        //!
+        //! \param node A pointer to the node to free.
+        //!
+        //! \return Nothing.
+        //!
+        void deleteNode(OrthancTreeNode* node) const;
+
+        //!
+        //! \brief The startFetch private method starts the background fetch
+        //!        of the next children of a node.
+        //!
+        //! \param node A pointer to the node.
+        //!
+        //! \return Nothing.
+        //!
+        void startFetch(OrthancTreeNode* node);
+
+        static int const s_pageSize = 100; // Number of patients per fetch
+
+        OrthancClient::OrthancConnection* m_orthanc;
+        QString m_user, m_password;
+        OrthancTreeNode* m_root;
+        unsigned int m_generation;        // Incremented on each refresh
+
+        QThreadPool m_fetchPool;          // Runs the requests one at a time
+        QMutex m_resultMutex;
+        QList<OrthancTreeFetch*> m_results;
+};
+
+#endif
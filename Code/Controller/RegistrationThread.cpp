@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RegistrationThread.cpp
+//! \brief The RegistrationThread.cpp file contains the definition of
+//!        non-inline methods of the RegistrationThread class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "RegistrationThread.h"
+using namespace std;
+
+// Constructor
+RegistrationThread::RegistrationThread(QObject* parent)
+    : QThread(parent), m_registration(), m_translation(), m_rotation(),
+      m_similarity(0), m_elapsed(0)
+{}
+
+// Destructor
+RegistrationThread::~RegistrationThread()
+{
+    wait();
+}
+
+// The 'startRegistration' method
+void RegistrationThread::startRegistration(SeriesData* fixed, Vector3D const& fixedTranslation,
+                                           Vector3D const& fixedRotation, SeriesData* moving,
+                                           Vector3D const& translation, Vector3D const& rotation)
+{
+    m_registration.setFixed(fixed, fixedTranslation, fixedRotation);
+    m_registration.setMoving(moving);
+    m_translation = translation;
+    m_rotation = rotation;
+
+    start();
+}
+
+// The 'run' method
+void RegistrationThread::run()
+{
+    QTime clock;
+    clock.start();
+
+    m_similarity = m_registration.run(m_translation, m_rotation);
+    m_elapsed = clock.elapsed();
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RegistrationThread.h
+//! \brief The RegistrationThread.h file contains the interface of the
+//!        RegistrationThread class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef REGISTRATIONTHREAD_H
+#define REGISTRATIONTHREAD_H
+
+#include <iostream>
+
+#include <QThread>
+#include <QTime>
+
+#include "Model/RigidRegistration.h"
+#include "Model/SeriesData.h"
+#include "Model/Vector3D.h"
+
+//!
+//! \brief The RegistrationThread class aligns a moving series on a fixed
+//!        series in a dedicated thread, so that the interface is not frozen
+//!        during the search.
+//!
+//! The series must not be modified until the thread is finished: their
+//! loading must be over.
+//!
+class RegistrationThread : public QThread
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The RegistrationThread constructor.
+        //!
+        //! \param parent A pointer to the parent of the thread.
+        //!
+        RegistrationThread(QObject* parent = 0);
+
+        //!
+        //! \brief The RegistrationThread destructor waits for the end of the
+        //!        search.
+        //!
+        ~RegistrationThread();
+
+        //!
+        //! \brief The startRegistration method starts the search of the place
+        //!        of the moving series in the thread.
+        //!
+        //! The finished() signal is emitted at the end of the search.
+        //!
+        //! \param fixed The fixed series.
+        //! \param fixedTranslation The translation of the fixed series (in mm).
+        //! \param fixedRotation The rotation of the fixed series (in degrees).
+        //! \param moving The moving series.
+        //! \param translation The translation of the moving series (in mm),
+        //!                    where the search starts.
+        //! \param rotation The rotation of the moving series (in degrees),
+        //!                 where the search starts.
+        //!
+        //! \return Nothing.
+        //!
+        void startRegistration(SeriesData* fixed, Vector3D const& fixedTranslation,
+                               Vector3D const& fixedRotation, SeriesData* moving,
+                               Vector3D const& translation, Vector3D const& rotation);
+
+        //!
+        //! \brief The translation method returns the translation found for the
+        //!        moving series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The translation of the moving series (in mm).
+        //!
+        inline Vector3D const& translation() const;
+
+        //!
+        //! \brief The rotation method returns the rotation found for the
+        //!        moving series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The rotation of the moving series (in degrees).
+        //!
+        inline Vector3D const& rotation() const;
+
+        //!
+        //! \brief The similarity method returns the similarity of the series
+        //!        at the found place.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The normalized mutual information of the series.
+        //!
+        inline double similarity() const;
+
+        //!
+        //! \brief The elapsed method returns the duration of the search.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The duration of the search (in ms).
+        //!
+        inline int elapsed() const;
+
+    protected:
+        //!
+        //! \brief The run method searches the place of the moving series.
+        //!
+        //! This is a redefinition of the QThread::run() method.
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        RigidRegistration m_registration;
+
+        Vector3D m_translation, m_rotation; // The start, then the result
+        double m_similarity;
+        int m_elapsed;
+};
+
+// The 'translation' method
+inline Vector3D const& RegistrationThread::translation() const { return m_translation; }
+
+// The 'rotation' method
+inline Vector3D const& RegistrationThread::rotation() const { return m_rotation; }
+
+// The 'similarity' method
+inline double RegistrationThread::similarity() const { return m_similarity; }
+
+// The 'elapsed' method
+inline int RegistrationThread::elapsed() const { return m_elapsed; }
+
+#endif
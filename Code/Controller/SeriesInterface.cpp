@@ -76,6 +76,8 @@ SeriesInterface::SeriesInterface(SeriesData* series, QWidget* parent)
     connect(m_hounsfieldColormapAction, SIGNAL(triggered()), m_hounsfieldColormapDialog, SLOT(show()));
     connect(m_hounsfieldColormapDialog, SIGNAL(newConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)), this, SLOT(updateViewConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)));
     m_hounsfieldColormapDialog->reset();
+    for(unsigned int i = SAGITTAL_SLICE ; i <= TRANSVERSE_SLICE ; i++)
+        connect(m_subInterface[i], SIGNAL(windowLevelChanged(Range const&)), m_hounsfieldColormapDialog, SLOT(setHounsfield(Range const&)));
 
     connect(m_translationRotationAction, SIGNAL(triggered()), m_translationRotationDialog, SLOT(show()));
     connect(m_translationRotationDialog, SIGNAL(newConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)), this, SLOT(updateViewConfiguration(ViewConfiguration const&, ViewConfiguration::ViewParam)));
@@ -89,6 +91,14 @@ SeriesInterface::SeriesInterface(SeriesData* series, QWidget* parent)
     dynamic_cast<SliceSubInterface*>(m_subInterface[FRONTAL_SLICE])->resetSlider();
     dynamic_cast<SliceSubInterface*>(m_subInterface[TRANSVERSE_SLICE])->resetSlider();
 
+    // Follow the slices which are still loading
+    m_loadedSliceCount = m_series->loadedSliceCount();
+    m_fillCount = m_series->fillCount();
+    m_loadingTimer.setInterval(200);
+    connect(&m_loadingTimer, SIGNAL(timeout()), this, SLOT(refreshLoadedSlices()));
+    if(m_series->isLoading())
+        m_loadingTimer.start();
+
     cout << "done." << endl;
 }
 
@@ -137,9 +147,49 @@ double SeriesInterface::getPropsOpacity() const
     return dynamic_cast<SeriesViewer*>(m_subInterface[0]->viewer())->getPropOpacity();
 }
 
+// The 'refreshLoadedSlices' slot
+void SeriesInterface::refreshLoadedSlices()
+{
+    bool loading = m_series->isLoading();
+    int loadedSliceCount = m_series->loadedSliceCount();
+    int fillCount = m_series->fillCount();
+    if(loadedSliceCount == m_loadedSliceCount && fillCount == m_fillCount && loading)
+        return;
+
+    // The voxels have been written behind VTK's back
+    m_loadedSliceCount = loadedSliceCount;
+    m_series->Modified();
+
+    for(unsigned int i = SAGITTAL_SLICE ; i <= TRANSVERSE_SLICE ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_subInterface[i]->viewer())->refreshLoadedSlices();
+
+    // The volume is only redrawn once a whole pass of slices is available
+    if(!loading || fillCount != m_fillCount)
+        m_subInterface[VOLUME]->viewer()->scheduleRender();
+    m_fillCount = fillCount;
+
+    if(!loading)
+    {
+        m_loadingTimer.stop();
+        emit loadingFinished();
+    }
+}
+
 // The 'setPropsOpacity' method
 void SeriesInterface::setPropsOpacity(double opacity)
 {
     for(unsigned int i = 0 ; i < 4 ; i++)
         dynamic_cast<SeriesViewer*>(m_subInterface[i]->viewer())->setPropOpacity(opacity);
 }
+
+// The 'transformConfiguration' method
+ViewConfiguration const& SeriesInterface::transformConfiguration() const
+{
+    return m_translationRotationDialog->currentConfiguration();
+}
+
+// The 'setTransform' method
+void SeriesInterface::setTransform(Vector3D const& translation, Vector3D const& rotation)
+{
+    m_translationRotationDialog->setTransform(translation, rotation);
+}
@@ -37,6 +37,7 @@
 
 #include <QGridLayout>
 #include <QButtonGroup>
+#include <QTimer>
 
 #include "Model/SeriesData.h"
 #include "Model/ViewConfiguration.h"
@@ -129,9 +130,53 @@ class SeriesInterface : public DisplayInterface
         //!
         void setPropsOpacity(double opacity);
 
+        //!
+        //! \brief The transformConfiguration method returns the configuration
+        //!        which holds the translation and the rotation of the series.
+        //!
+        //! \return The ViewConfiguration of the translation and rotation dialog.
+        //!
+        ViewConfiguration const& transformConfiguration() const;
+
+        //!
+        //! \brief The setTransform method moves the series to a new translation
+        //!        and rotation, through the translation and rotation dialog.
+        //!
+        //! \param translation The new translation (in mm).
+        //! \param rotation The new rotation (in degrees).
+        //!
+        //! \return Nothing.
+        //!
+        void setTransform(Vector3D const& translation, Vector3D const& rotation);
+
+    public slots:
+        //!
+        //! \brief The refreshLoadedSlices slot checks if new slices of the
+        //!        series have been loaded and, if so, refreshes the viewers.
+        //!
+        //! The slot is called periodically while the series is loading in the
+        //! background. The volume viewer is only refreshed once the loading
+        //! is finished.
+        //!
+        //! \return Nothing.
+        //!
+        void refreshLoadedSlices();
+
+    signals:
+        //!
+        //! \brief The loadingFinished signal, once emitted, indicates that all
+        //!        the slices of the series have been loaded.
+        //!
+        void loadingFinished();
+
     private:
         vtkSmartPointer<SeriesData> m_series; // The series the interface visualizes
 
+        // Progressive loading
+        QTimer m_loadingTimer;
+        int m_loadedSliceCount;
+        int m_fillCount;
+
         // Toolbar components
         QAction* m_hounsfieldColormapAction;
         QAction* m_translationRotationAction;
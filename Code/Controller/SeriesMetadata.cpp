@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesMetadata.cpp
+//! \brief The SeriesMetadata.cpp file contains the definition of
+//!        non-inline methods of the SeriesMetadata class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SeriesMetadata.h"
+using namespace std;
+
+// Constructor
+SeriesMetadata::SeriesMetadata(OrthancClient::Series& series)
+    : m_rowDirection(1, 0, 0), m_columnDirection(0, 1, 0)
+{
+    unsigned int count = series.GetInstanceCount();
+    m_positions.resize(count);
+    m_rescaleIntercepts.resize(count, 0);
+    m_rescaleSlopes.resize(count, 1);
+
+    // Series information, read on the first instance
+    char const* seriesTags[] = { "PatientName", "StudyDescription", "SeriesDescription",
+                                 "Modality", "ImageOrientationPatient",
+                                 "WindowCenter", "WindowWidth",
+                                 "BitsAllocated", "PixelRepresentation" };
+    OrthancClient::Instance first = series.GetInstance(0);
+    for(unsigned int i = 0 ; i < sizeof(seriesTags) / sizeof(seriesTags[0]) ; i++)
+    {
+        string value;
+        if(readTag(first, seriesTags[i], value))
+            m_tags[seriesTags[i]] = value;
+    }
+
+    if(hasTag("ImageOrientationPatient"))
+    {
+        m_rowDirection = parseVector(tag("ImageOrientationPatient"), 0);
+        m_columnDirection = parseVector(tag("ImageOrientationPatient"), 3);
+    }
+
+    // Instance information
+    for(unsigned int i = 0 ; i < count ; i++)
+    {
+        OrthancClient::Instance instance = series.GetInstance(i);
+
+        string value;
+        if(readTag(instance, "ImagePositionPatient", value))
+            m_positions.at(i) = parseVector(value);
+        else
+            m_positions.at(i) = Vector3D(0, 0, i); // Assume an ordered stack
+
+        if(readTag(instance, "RescaleIntercept", value))
+            m_rescaleIntercepts.at(i) = QString(value.c_str()).toDouble();
+        if(readTag(instance, "RescaleSlope", value))
+        {
+            double slope = QString(value.c_str()).toDouble();
+            if(slope != 0)
+                m_rescaleSlopes.at(i) = slope;
+        }
+    }
+}
+
+// Destructor
+SeriesMetadata::~SeriesMetadata()
+{}
+
+// The 'hasTag' method
+bool SeriesMetadata::hasTag(string const& name) const
+{
+    return m_tags.find(name) != m_tags.end();
+}
+
+// The 'tag' method
+string SeriesMetadata::tag(string const& name, string const& defaultValue) const
+{
+    map<string, string>::const_iterator iter = m_tags.find(name);
+    if(iter == m_tags.end())
+        return defaultValue;
+
+    return iter->second;
+}
+
+// The 'scalarType' method
+int SeriesMetadata::scalarType() const
+{
+    int bitsAllocated = QString(tag("BitsAllocated", "16").c_str()).toInt();
+    if(bitsAllocated <= 8)
+        return VTK_UNSIGNED_CHAR;
+    else if(bitsAllocated != 16)
+        throw OrthancClient::OrthancClientException("Pixels of more than 16 bits are not supported");
+    else if(QString(tag("PixelRepresentation", "0").c_str()).toInt() == 1)
+        return VTK_SHORT;
+    else
+        return VTK_UNSIGNED_SHORT;
+}
+
+// The 'readTag' private static method
+bool SeriesMetadata::readTag(OrthancClient::Instance& instance, char const* name,
+                             string& value)
+{
+    try {
+        value = instance.GetTagAsString(name);
+        return true;
+    }
+    catch(OrthancClient::OrthancClientException& e)
+    {}
+    catch(exception& e)
+    {}
+
+    return false;
+}
+
+// The 'parseVector' private static method
+Vector3D SeriesMetadata::parseVector(string const& value, int offset)
+{
+    QStringList values = QString(value.c_str()).split("\\");
+
+    Vector3D vector;
+    if(values.size() > offset)
+        vector.x() = values.at(offset).toDouble();
+    if(values.size() > offset+1)
+        vector.y() = values.at(offset+1).toDouble();
+    if(values.size() > offset+2)
+        vector.z() = values.at(offset+2).toDouble();
+
+    return vector;
+}
@@ -0,0 +1,229 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesMetadata.h
+//! \brief The SeriesMetadata.h file contains the interface of the
+//!        SeriesMetadata class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SERIESMETADATA_H
+#define SERIESMETADATA_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <QString>
+#include <QStringList>
+
+#include <vtkType.h>
+
+#include "orthanc/OrthancCppClient.h"
+
+#include "Model/Vector3D.h"
+
+//!
+//! \brief The SeriesMetadata class gathers, in a single pass, the DICOM tags
+//!        of all the instances of an Orthanc series which are needed to build
+//!        its volume.
+//!
+//! The tags are read from the simplified tags the Orthanc client downloads
+//! (by several threads) when it first accesses the instances of the series,
+//! so that no request is sent to the server for a single tag.
+//!
+class SeriesMetadata
+{
+    public:
+        //!
+        //! \brief The SeriesMetadata constructor reads and parses the tags of
+        //!        all the instances of the given series.
+        //!
+        //! \param series A reference to the Orthanc Series to read.
+        //!
+        SeriesMetadata(OrthancClient::Series& series);
+
+        //!
+        //! \brief The SeriesMetadata destructor.
+        //!
+        ~SeriesMetadata();
+
+        //!
+        //! \brief The instanceCount method returns the number of instances
+        //!        whose tags have been read.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The number of instances of the series.
+        //!
+        inline unsigned int instanceCount() const;
+
+        //!
+        //! \brief The hasTag method indicates if the first instance of the
+        //!        series contains the given tag.
+        //!
+        //! \param name The name of the tag (e.g. "PatientName").
+        //!
+        //! \return A boolean which is true if the tag is available.
+        //!
+        bool hasTag(std::string const& name) const;
+
+        //!
+        //! \brief The tag method returns the value of a tag of the first
+        //!        instance of the series.
+        //!
+        //! \param name The name of the tag (e.g. "PatientName").
+        //! \param defaultValue The value to return if the tag is not available.
+        //!
+        //! \return A string object which contains the tag value.
+        //!
+        std::string tag(std::string const& name, std::string const& defaultValue = "") const;
+
+        //!
+        //! \brief The scalarType method returns the VTK scalar type which
+        //!        holds the stored pixels of the series without any loss.
+        //!
+        //! The type is given by the BitsAllocated and PixelRepresentation
+        //! tags: VTK_UNSIGNED_CHAR, VTK_SHORT or VTK_UNSIGNED_SHORT. The
+        //! series whose pixels are allocated on more than 16 bits are not
+        //! supported: an OrthancClientException is thrown.
+        //!
+        //! \return The VTK scalar type of the series.
+        //!
+        int scalarType() const;
+
+        //!
+        //! \brief The rowDirection method returns the direction cosines of the
+        //!        rows of the series images.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A reference to read the row direction.
+        //!
+        inline Vector3D const& rowDirection() const;
+
+        //!
+        //! \brief The columnDirection method returns the direction cosines of
+        //!        the columns of the series images.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A reference to read the column direction.
+        //!
+        inline Vector3D const& columnDirection() const;
+
+        //!
+        //! \brief The position method returns the position of the upper left
+        //!        voxel of an instance.
+        //!
+        //! The method is inline.
+        //!
+        //! \param instance The index of the instance in the Orthanc series.
+        //!
+        //! \return A reference to read the instance position.
+        //!
+        inline Vector3D const& position(unsigned int instance) const;
+
+        //!
+        //! \brief The rescaleIntercept method returns the rescale intercept
+        //!        of an instance.
+        //!
+        //! The method is inline.
+        //!
+        //! \param instance The index of the instance in the Orthanc series.
+        //!
+        //! \return The rescale intercept of the instance (0 if not given).
+        //!
+        inline double rescaleIntercept(unsigned int instance) const;
+
+        //!
+        //! \brief The rescaleSlope method returns the rescale slope of an
+        //!        instance.
+        //!
+        //! The method is inline.
+        //!
+        //! \param instance The index of the instance in the Orthanc series.
+        //!
+        //! \return The rescale slope of the instance (1 if not given).
+        //!
+        inline double rescaleSlope(unsigned int instance) const;
+
+    private:
+        //!
+        //! \brief The readTag private static method reads a simplified tag of
+        //!        an instance.
+        //!
+        //! \param instance A reference to the Orthanc instance to read.
+        //! \param name The name of the tag.
+        //! \param value A reference to the string which receives the value.
+        //!
+        //! \return A boolean which is true if the tag is available.
+        //!
+        static bool readTag(OrthancClient::Instance& instance, char const* name,
+                            std::string& value);
+
+        //!
+        //! \brief The parseVector private static method converts a
+        //!        backslash-separated list of numbers in a vector.
+        //!
+        //! \param value The string to parse.
+        //! \param offset The index of the first number to use.
+        //!
+        //! \return The parsed vector (components not given are null).
+        //!
+        static Vector3D parseVector(std::string const& value, int offset = 0);
+
+        std::map<std::string, std::string> m_tags;  // Tags of the first instance
+        Vector3D m_rowDirection, m_columnDirection;
+        std::vector<Vector3D> m_positions;
+        std::vector<double> m_rescaleIntercepts, m_rescaleSlopes;
+};
+
+// The 'instanceCount' method
+inline unsigned int SeriesMetadata::instanceCount() const { return m_positions.size(); }
+
+// The 'rowDirection' method
+inline Vector3D const& SeriesMetadata::rowDirection() const { return m_rowDirection; }
+
+// The 'columnDirection' method
+inline Vector3D const& SeriesMetadata::columnDirection() const { return m_columnDirection; }
+
+// The 'position' method
+inline Vector3D const& SeriesMetadata::position(unsigned int instance) const
+{ return m_positions.at(instance); }
+
+// The 'rescaleIntercept' method
+inline double SeriesMetadata::rescaleIntercept(unsigned int instance) const
+{ return m_rescaleIntercepts.at(instance); }
+
+// The 'rescaleSlope' method
+inline double SeriesMetadata::rescaleSlope(unsigned int instance) const
+{ return m_rescaleSlopes.at(instance); }
+
+#endif
@@ -38,14 +38,15 @@ using namespace customwidget;
 
 // Constructor
 SliceSubInterface::SliceSubInterface(SeriesData* series, SliceOrientation orien)
-    : SubInterface(), m_orientation(orien)
+    : SubInterface(), m_orientation(orien), m_windowLevelDrag(false)
 {
     setViewer(new SeriesSliceViewer(series, orien));
     initInterface();
 }
 
 // Constructor II
-SliceSubInterface::SliceSubInterface(MergedSeriesSliceViewer* viewer) : SubInterface()
+SliceSubInterface::SliceSubInterface(MergedSeriesSliceViewer* viewer)
+    : SubInterface(), m_windowLevelDrag(false)
 {
     m_orientation = viewer->orientation();
     setViewer(viewer);
@@ -81,6 +82,39 @@ void SliceSubInterface::initInterface()
 
     m_gridLayout->addLayout(vLayout, 1, 2);
 
+    QHBoxLayout* hLayout = new QHBoxLayout();
+    m_obliqueButton = new PushButton("Oblique");
+    m_obliqueButton->setCheckable(true);
+    hLayout->addWidget(m_obliqueButton);
+
+    m_slabModeComboBox = new ComboBox();
+    m_slabModeComboBox->addItem("Coupe");   // SLAB_NONE
+    m_slabModeComboBox->addItem("MIP");     // SLAB_MAXIMUM
+    m_slabModeComboBox->addItem("MinIP");   // SLAB_MINIMUM
+    m_slabModeComboBox->addItem("Moyenne"); // SLAB_MEAN
+    hLayout->addWidget(m_slabModeComboBox);
+
+    m_slabThicknessBox = new DoubleSpinBox();
+    m_slabThicknessBox->setRange(0, 500);
+    m_slabThicknessBox->setDecimals(1);
+    m_slabThicknessBox->setSuffix(" mm");
+    m_slabThicknessBox->setValue(10);
+    hLayout->addWidget(m_slabThicknessBox);
+
+    m_cineButton = new PushButton("Ciné");
+    m_cineButton->setCheckable(true);
+    hLayout->addWidget(m_cineButton);
+
+    m_frameRateBox = new SpinBox();
+    m_frameRateBox->setRange(1, 60);
+    m_frameRateBox->setSuffix(" images/s");
+    m_frameRateBox->setValue(15);
+    hLayout->addWidget(m_frameRateBox);
+
+    m_cineLabel = new Label("");
+    hLayout->addWidget(m_cineLabel);
+    m_gridLayout->addLayout(hLayout, 2, 1);
+
     Label* label = new Label("");
     switch(m_orientation)
     {
@@ -103,6 +137,12 @@ void SliceSubInterface::initInterface()
     // Event connection
     connect(m_sliceSlider, SIGNAL(doubleValueChanged(double)), m_viewer, SLOT(changeCurrentSlice(double)));
     connect(m_resetSliderButton, SIGNAL(clicked()), this, SLOT(resetSlider()));
+    connect(m_obliqueButton, SIGNAL(clicked(bool)), m_viewer, SLOT(enableOblique(bool)));
+    connect(m_slabModeComboBox, SIGNAL(currentIndexChanged(int)), m_viewer, SLOT(setSlabMode(int)));
+    connect(m_slabThicknessBox, SIGNAL(valueChanged(double)), m_viewer, SLOT(setSlabThickness(double)));
+    connect(m_cineButton, SIGNAL(clicked(bool)), m_viewer, SLOT(enableCine(bool)));
+    connect(m_cineButton, SIGNAL(clicked(bool)), this, SLOT(toggleCine(bool)));
+    connect(&m_cineTimer, SIGNAL(timeout()), this, SLOT(cineTick()));
 
     // Some post-init
     updateSliceRange();
@@ -115,3 +155,85 @@ void SliceSubInterface::resetSlider()
     m_sliceSlider->setDoubleValue(range.max()); // To force the slider to move
     m_sliceSlider->setDoubleValue((range.min()+range.max())/2);
 }
+
+// The 'toggleCine' slot
+void SliceSubInterface::toggleCine(bool play)
+{
+    if(play)
+    {
+        m_cineValue = m_sliceSlider->doubleValue();
+        m_cineFrame = 0;
+        m_shownFrames = 0;
+        m_droppedFrames = 0;
+        m_cineLabel->setText("");
+        m_cineClock.start();
+        m_cineTimer.start(1000 / m_frameRateBox->value());
+    }
+    else if(m_cineTimer.isActive())
+    {
+        m_cineTimer.stop();
+        cout << "Cine: " << m_shownFrames << " images shown, " << m_droppedFrames
+             << " dropped at " << m_frameRateBox->value() << " images/s" << endl;
+    }
+}
+
+// The 'cineTick' slot
+void SliceSubInterface::cineTick()
+{
+    // The frame due now, according to the clock and the frame rate
+    int frame = static_cast<int>(m_cineClock.elapsed() * static_cast<qint64>(m_frameRateBox->value()) / 1000);
+    int steps = frame - m_cineFrame;
+    if(steps <= 0)
+        return;
+
+    m_droppedFrames += steps - 1;
+    m_shownFrames++;
+    m_cineFrame = frame;
+
+    // Go back to the first slice after the last one
+    Range const& range = m_sliceSlider->doubleRange();
+    m_cineValue += steps * m_viewer->sliceStep();
+    if(m_cineValue > range.max())
+        m_cineValue = range.min();
+    m_sliceSlider->setDoubleValue(m_cineValue);
+
+    m_cineLabel->setText(QString("%1 images, %2 perdues").arg(m_shownFrames).arg(m_droppedFrames));
+}
+
+// The 'eventFilter' method
+bool SliceSubInterface::eventFilter(QObject* object, QEvent* event)
+{
+    // Only the slices of a single series have their own window
+    SeriesSliceViewer* viewer = dynamic_cast<SeriesSliceViewer*>(m_viewer);
+    if(viewer == 0 || object != viewer->widget())
+        return SubInterface::eventFilter(object, event);
+
+    QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+    switch(event->type())
+    {
+        case QEvent::MouseButtonPress:
+            if(mouseEvent->button() != Qt::RightButton || !viewer->startWindowLevel())
+                break;
+            m_windowLevelDrag = true;
+            m_dragOrigin = mouseEvent->pos();
+            return true;
+
+        case QEvent::MouseMove:
+            if(!m_windowLevelDrag)
+                break;
+            viewer->dragWindowLevel(mouseEvent->x() - m_dragOrigin.x(), mouseEvent->y() - m_dragOrigin.y());
+            return true;
+
+        case QEvent::MouseButtonRelease:
+            if(!m_windowLevelDrag || mouseEvent->button() != Qt::RightButton)
+                break;
+            m_windowLevelDrag = false;
+            emit windowLevelChanged(viewer->finishWindowLevel());
+            return true;
+
+        default:
+            break;
+    }
+
+    return SubInterface::eventFilter(object, event);
+}
@@ -35,8 +35,16 @@
 #ifndef SLICESUBINTERFACE_H
 #define SLICESUBINTERFACE_H
 
+#include <iostream>
+
+#include <QTime>
+#include <QTimer>
+
 #include "View/Qt/customwidget/Label.h"
 #include "View/Qt/customwidget/PushButton.h"
+#include "View/Qt/customwidget/ComboBox.h"
+#include "View/Qt/customwidget/DoubleSpinBox.h"
+#include "View/Qt/customwidget/SpinBox.h"
 
 #include "View/Qt/DoubleSlider.h"
 #include "View/VTK/SeriesSliceViewer.h"
@@ -98,6 +106,57 @@ class SliceSubInterface : public SubInterface
         //!
         void resetSlider();
 
+        //!
+        //! \brief The toggleCine slot starts or stops the cine playback of the
+        //!        slices, at the frame rate of the frame rate box.
+        //!
+        //! When the playback stops, the number of shown and dropped frames is
+        //! printed on the standard output.
+        //!
+        //! \param play True to start the playback.
+        //!
+        //! \return Nothing
+        //!
+        void toggleCine(bool play);
+
+    signals:
+        //!
+        //! \brief The windowLevelChanged signal, once emitted, indicates the
+        //!        hounsfield window chosen by a drag on the slice.
+        //!
+        //! \param hounsfield The new hounsfield window.
+        //!
+        void windowLevelChanged(Range const& hounsfield);
+
+    protected:
+        //!
+        //! \brief The eventFilter method changes the hounsfield window while
+        //!        the right button of the mouse is dragged on the viewer.
+        //!
+        //! During the drag, only the slice of this viewer is colored again. The
+        //! window is given to the other views by the windowLevelChanged()
+        //! signal when the button is released.
+        //!
+        //! \param object The object which receives the event.
+        //! \param event The event.
+        //!
+        //! \return True if the event is stopped, false otherwise.
+        //!
+        bool eventFilter(QObject* object, QEvent* event);
+
+    private slots:
+        //!
+        //! \brief The cineTick slot shows the slice due at the current time of
+        //!        the cine playback.
+        //!
+        //! When the previous frames took too long, the slices which should
+        //! have been shown meanwhile are skipped and counted as dropped, so
+        //! that the playback keeps its frame rate.
+        //!
+        //! \return Nothing
+        //!
+        void cineTick();
+
     private:
         //!
         //! \brief The initInterface private method initializes the interface
@@ -109,6 +168,23 @@ class SliceSubInterface : public SubInterface
 
         DoubleSlider* m_sliceSlider; // The slider to control the reslice action
         customwidget::PushButton* m_resetSliderButton;
+        customwidget::PushButton* m_obliqueButton;
+        customwidget::ComboBox* m_slabModeComboBox;      // The SlabMode
+        customwidget::DoubleSpinBox* m_slabThicknessBox; // In mm
+
+        // The cine playback
+        customwidget::PushButton* m_cineButton;
+        customwidget::SpinBox* m_frameRateBox; // In images per second
+        customwidget::Label* m_cineLabel;      // The shown and dropped frames
+        QTimer m_cineTimer;
+        QTime m_cineClock;  // Started with the playback
+        double m_cineValue; // The slice position of the playback
+        int m_cineFrame;    // The index of the last frame due
+        int m_shownFrames, m_droppedFrames;
+
+        // The drag of the hounsfield window
+        bool m_windowLevelDrag;
+        QPoint m_dragOrigin;
         SliceOrientation m_orientation;
 };
 
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SnapshotBatch.cpp
+//! \brief The SnapshotBatch.cpp file contains the definition of non-inline
+//!        methods of the SnapshotBatch class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SnapshotBatch.h"
+using namespace std;
+
+// The 'run' static method
+int SnapshotBatch::run(string const& directory, ostream& out)
+{
+    Viewer::setOffScreen(true);
+
+    vtkSmartPointer<SeriesData> series;
+    series.TakeReference(createPhantom());
+
+    // A gray scale on the soft tissue window
+    Colormap colormap;
+    colormap.addColor(0, QColor(0, 0, 0));
+    colormap.addColor(1, QColor(255, 255, 255));
+
+    ViewConfiguration config;
+    config.setHounsfield(series->getBasicHounsfield(), series->computeBasicHounsfieldRanges().at(0));
+    config.setColormap(colormap);
+
+    SeriesSliceViewer sliceViewer(series, TRANSVERSE);
+    sliceViewer.updateView(config, ViewConfiguration::ALL);
+    sliceViewer.changeCurrentSlice((sliceViewer.minSlice() + sliceViewer.maxSlice()) / 2);
+    sliceViewer.saveSnapshot(directory + "/slice.png");
+    measure(&sliceViewer, "slice", out);
+
+    sliceViewer.setSlabThickness(40);
+    sliceViewer.setSlabMode(SLAB_MAXIMUM);
+    sliceViewer.saveSnapshot(directory + "/mip.png");
+    measure(&sliceViewer, "MIP slab", out);
+
+    SeriesVolumeViewer volumeViewer(series);
+    volumeViewer.updateView(config, ViewConfiguration::ALL);
+    volumeViewer.saveSnapshot(directory + "/volume.png");
+    measure(&volumeViewer, "volume", out);
+
+    Viewer::setOffScreen(false);
+    return 0;
+}
+
+// The 'createPhantom' private static method
+SeriesData* SnapshotBatch::createPhantom()
+{
+    int const dims[3] = { 256, 256, 128 };
+    double const spacing[3] = { 1, 1, 2 };
+
+    SeriesData* series = new SeriesData();
+    series->setPatientName("Phantom");
+    series->setModality("CT");
+    series->SetDimensions(dims[0], dims[1], dims[2]);
+    series->SetSpacing(spacing[0], spacing[1], spacing[2]);
+    series->SetOrigin(0, 0, 0);
+    series->SetScalarTypeToShort();
+    series->AllocateScalars();
+
+    // Air around a sphere of soft tissue which contains a sphere of bone
+    short* voxel = static_cast<short*>(series->GetScalarPointer());
+    for(int z = 0 ; z < dims[2] ; z++)
+        for(int y = 0 ; y < dims[1] ; y++)
+            for(int x = 0 ; x < dims[0] ; x++, voxel++)
+            {
+                double dx = (x - dims[0] / 2) * spacing[0];
+                double dy = (y - dims[1] / 2) * spacing[1];
+                double dz = (z - dims[2] / 2) * spacing[2];
+                double distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+                if(distance < 30)
+                    *voxel = 700;
+                else if(distance < 100)
+                    *voxel = 40;
+                else
+                    *voxel = -1000;
+            }
+
+    series->addBasicWindow();
+    series->addBasicWindow(40, 400);
+    return series;
+}
+
+// The 'measure' private static method
+void SnapshotBatch::measure(Viewer* viewer, string const& name, ostream& out)
+{
+    QTime clock;
+    clock.start();
+    for(int i = 0 ; i < s_renderCount ; i++)
+        viewer->render();
+
+    out << name << ": " << static_cast<double>(clock.elapsed()) / s_renderCount
+        << " ms per render" << endl;
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SnapshotBatch.h
+//! \brief The SnapshotBatch.h file contains the interface of the
+//!        SnapshotBatch class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SNAPSHOTBATCH_H
+#define SNAPSHOTBATCH_H
+
+#include <iostream>
+#include <string>
+#include <cmath>
+
+#include <QTime>
+
+#include <vtkSmartPointer.h>
+
+#include "Model/Colormap.h"
+#include "Model/SeriesData.h"
+#include "Model/ViewConfiguration.h"
+
+#include "View/VTK/SeriesSliceViewer.h"
+#include "View/VTK/SeriesVolumeViewer.h"
+
+//!
+//! \brief The SnapshotBatch class renders snapshots of a series without any
+//!        display, and measures the render times.
+//!
+//! The viewers are created off-screen and show a synthetic phantom, so that
+//! the batch gives the same images on every machine. A slice, a MIP slab and
+//! a volume rendering are written in PNG files, and the mean render time of
+//! each of them is printed.
+//!
+class SnapshotBatch
+{
+    public:
+        //!
+        //! \brief The run static method renders the snapshots.
+        //!
+        //! \param directory The directory where the PNG files are written.
+        //! \param out The stream where the render times are printed.
+        //!
+        //! \return Zero if the snapshots have been written.
+        //!
+        static int run(std::string const& directory, std::ostream& out);
+
+    private:
+        //!
+        //! \brief The createPhantom private static method creates a series of
+        //!        spheres of soft tissue and bone in the air.
+        //!
+        //! \return A pointer to a new SeriesData object.
+        //!
+        static SeriesData* createPhantom();
+
+        //!
+        //! \brief The measure private static method renders a viewer several
+        //!        times and prints the mean render time.
+        //!
+        //! \param viewer The viewer to render.
+        //! \param name The name of the rendering.
+        //! \param out The stream where the render time is printed.
+        //!
+        //! \return Nothing.
+        //!
+        static void measure(Viewer* viewer, std::string const& name, std::ostream& out);
+
+        static int const s_renderCount = 20; // The renders of each measure
+};
+
+#endif
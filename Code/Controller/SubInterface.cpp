@@ -48,7 +48,10 @@ SubInterface::SubInterface() : Widget()
 
 // Destructor
 SubInterface::~SubInterface()
-{}
+{
+    // The viewer is not a widget, it is not destroyed with the children
+    delete m_viewer;
+}
 
 // The 'setViewer' method
 void SubInterface::setViewer(Viewer* viewer)
@@ -58,19 +61,19 @@ void SubInterface::setViewer(Viewer* viewer)
     // Create the central layout
     QHBoxLayout* centralLayout = new QHBoxLayout();
 
-    centralLayout->addWidget(m_viewer);
+    centralLayout->addWidget(m_viewer->widget());
 
     m_gridLayout->addLayout(centralLayout, 1, 1); // Permits to add components in subclasses
 
     // To check event from the viewer
-    m_viewer->installEventFilter(this);
+    m_viewer->widget()->installEventFilter(this);
 }
 
 // The 'eventFilter' method
 bool SubInterface::eventFilter(QObject* object, QEvent* event)
 {
     // If the event is from the viewer
-    if(object == m_viewer)
+    if(m_viewer && object == m_viewer->widget())
     {
         // Simulate a double click if the viewer was double clicked
         if(event->type() == QEvent::MouseButtonDblClick)
@@ -101,6 +101,9 @@ class SubInterface : public customwidget::Widget
         //!
         //! \brief The setViewer method sets the viewer the SubInterface controls.
         //!
+        //! The widget of the viewer is shown at the center of the layout, and
+        //! the SubInterface takes the ownership of the viewer.
+        //!
         //! \param viewer A pointer to the Viewer object the SubInterface controls.
         //!
         //! \return Nothing.
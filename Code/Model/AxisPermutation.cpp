@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file AxisPermutation.cpp
+//! \brief The AxisPermutation.cpp file contains the definition of
+//!        non-inline methods of the AxisPermutation class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "AxisPermutation.h"
+using namespace std;
+
+// Constructor
+AxisPermutation::AxisPermutation() : m_aligned(true)
+{
+    for(int i = 0 ; i < 3 ; i++)
+    {
+        m_axes[i] = i;
+        m_flips[i] = false;
+    }
+}
+
+// Constructor
+AxisPermutation::AxisPermutation(Vector3D const& row, Vector3D const& column,
+                                 Vector3D const& normal)
+    : m_aligned(true)
+{
+    Vector3D directions[3] = { row, column, normal };
+    bool used[3] = { false, false, false };
+
+    // The stack axis b is sent on the volume axis whose direction is along b
+    for(int b = 0 ; b < 3 && m_aligned ; b++)
+    {
+        m_aligned = false;
+        for(int a = 0 ; a < 3 ; a++)
+        {
+            double component = (b == 0) ? directions[a].x() : ((b == 1) ? directions[a].y() : directions[a].z());
+            if(!used[a] && fabs(component) > 0.999)
+            {
+                m_axes[b] = a;
+                m_flips[b] = (component < 0);
+                used[a] = true;
+                m_aligned = true;
+            }
+        }
+    }
+
+    // Oblique stacks are kept as they are
+    if(!m_aligned)
+    {
+        for(int i = 0 ; i < 3 ; i++)
+        {
+            m_axes[i] = i;
+            m_flips[i] = false;
+        }
+    }
+}
+
+// Destructor
+AxisPermutation::~AxisPermutation()
+{}
+
+// The 'isIdentity' method
+bool AxisPermutation::isIdentity() const
+{
+    for(int i = 0 ; i < 3 ; i++)
+    {
+        if(m_axes[i] != i || m_flips[i])
+            return false;
+    }
+
+    return true;
+}
+
+// The 'outputGeometry' method
+void AxisPermutation::outputGeometry(int const inputDims[3], double const inputSpacing[3],
+                                     int outputDims[3], double outputSpacing[3],
+                                     double outputOrigin[3]) const
+{
+    for(int b = 0 ; b < 3 ; b++)
+    {
+        int a = m_axes[b];
+        outputDims[a] = inputDims[b];
+        outputSpacing[a] = inputSpacing[b];
+        outputOrigin[a] = m_flips[b] ? -(inputDims[b] - 1) * inputSpacing[b] : 0.0;
+    }
+}
+
+// The 'computeStrides' private method
+long AxisPermutation::computeStrides(int const inputDims[3], long strides[3]) const
+{
+    int outputDims[3];
+    for(int b = 0 ; b < 3 ; b++)
+        outputDims[m_axes[b]] = inputDims[b];
+
+    long outputStrides[3] = { 1, outputDims[0], static_cast<long>(outputDims[0]) * outputDims[1] };
+
+    // Step in the volume for each stack axis (negative if flipped)
+    long base = 0;
+    for(int b = 0 ; b < 3 ; b++)
+    {
+        int a = m_axes[b];
+        strides[b] = m_flips[b] ? -outputStrides[a] : outputStrides[a];
+        if(m_flips[b])
+            base += (outputDims[a] - 1) * outputStrides[a];
+    }
+
+    return base;
+}
@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file AxisPermutation.h
+//! \brief The AxisPermutation.h file contains the interface of the
+//!        AxisPermutation class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef AXISPERMUTATION_H
+#define AXISPERMUTATION_H
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Model/Vector3D.h"
+
+//!
+//! \brief The AxisPermutation class describes how the voxels of a stack of
+//!        slices are reordered when the slice directions are aligned with the
+//!        volume axes.
+//!
+//! Each axis of the stack (row, column and slice normal) is sent to an axis
+//! of the volume, possibly flipped. This gives the same volume as a
+//! vtkImageReslice with the same direction cosines, but the slices can be
+//! written directly at their final position, without any intermediate copy.
+//!
+class AxisPermutation
+{
+    public:
+        //!
+        //! \brief The AxisPermutation constructor initializes the identity
+        //!        permutation.
+        //!
+        AxisPermutation();
+
+        //!
+        //! \brief The AxisPermutation constructor computes the permutation
+        //!        given by the directions of a stack of slices.
+        //!
+        //! If the directions are oblique, the permutation is the identity and
+        //! isAxisAligned returns false.
+        //!
+        //! \param row The direction of the slice rows.
+        //! \param column The direction of the slice columns.
+        //! \param normal The direction along which the slices are stacked.
+        //!
+        AxisPermutation(Vector3D const& row, Vector3D const& column, Vector3D const& normal);
+
+        //!
+        //! \brief The AxisPermutation destructor.
+        //!
+        ~AxisPermutation();
+
+        //!
+        //! \brief The isAxisAligned method indicates if the directions given
+        //!        at construction are aligned with the volume axes.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A boolean which is true if the directions are not oblique.
+        //!
+        inline bool isAxisAligned() const;
+
+        //!
+        //! \brief The isIdentity method indicates if the slices are stored
+        //!        as they are.
+        //!
+        //! \return A boolean which is true if no axis is moved nor flipped.
+        //!
+        bool isIdentity() const;
+
+        //!
+        //! \brief The outputAxis method returns the volume axis on which an
+        //!        axis of the stack is sent.
+        //!
+        //! The method is inline.
+        //!
+        //! \param inputAxis The axis of the stack (0 for the rows, 1 for the
+        //!                  columns and 2 for the slices).
+        //!
+        //! \return The axis of the volume (0, 1 or 2).
+        //!
+        inline int outputAxis(int inputAxis) const;
+
+        //!
+        //! \brief The isFlipped method indicates if an axis of the stack is
+        //!        reversed in the volume.
+        //!
+        //! The method is inline.
+        //!
+        //! \param inputAxis The axis of the stack.
+        //!
+        //! \return A boolean which is true if the axis is reversed.
+        //!
+        inline bool isFlipped(int inputAxis) const;
+
+        //!
+        //! \brief The outputGeometry method computes the geometry of the volume
+        //!        from the geometry of the stack.
+        //!
+        //! The origin is the one chosen by vtkImageReslice, so that the
+        //! volume bounds do not depend on the way it is computed.
+        //!
+        //! \param inputDims The dimensions of the stack.
+        //! \param inputSpacing The spacing of the stack.
+        //! \param outputDims The dimensions of the volume (filled).
+        //! \param outputSpacing The spacing of the volume (filled).
+        //! \param outputOrigin The origin of the volume (filled).
+        //!
+        //! \return Nothing.
+        //!
+        void outputGeometry(int const inputDims[3], double const inputSpacing[3],
+                            int outputDims[3], double outputSpacing[3],
+                            double outputOrigin[3]) const;
+
+        //!
+        //! \brief The copySlice method writes the pixels of a slice of the
+        //!        stack at their position in the volume.
+        //!
+        //! When the rows are not sent on the first volume axis, the slice is
+        //! copied by square blocks, so that neither the reads nor the writes
+        //! leave the processor cache. Several slices can be copied at the same
+        //! time by different threads.
+        //!
+        //! The method is a template on the voxel type of the series.
+        //!
+        //! \param rows The pointers to the rows of the slice.
+        //! \param inputDims The dimensions of the stack.
+        //! \param slice The index of the slice in the stack.
+        //! \param output A pointer to the first voxel of the volume.
+        //!
+        //! \return Nothing.
+        //!
+        template <class T>
+        void copySlice(std::vector<T const*> const& rows,
+                       int const inputDims[3], unsigned int slice,
+                       T* output) const;
+
+    private:
+        //!
+        //! \brief The computeStrides private method computes the steps, in the
+        //!        volume, along each axis of the stack.
+        //!
+        //! \param inputDims The dimensions of the stack.
+        //! \param strides The step of each stack axis (negative if flipped).
+        //!
+        //! \return The offset of the first voxel of the stack in the volume.
+        //!
+        long computeStrides(int const inputDims[3], long strides[3]) const;
+
+        static int const s_blockSize = 64; // Side of the copied blocks
+
+        int m_axes[3];      // The volume axis of each stack axis
+        bool m_flips[3];    // True if the stack axis is reversed
+        bool m_aligned;     // False for oblique directions
+};
+
+// The 'isAxisAligned' inline method
+inline bool AxisPermutation::isAxisAligned() const
+{ return m_aligned; }
+
+// The 'outputAxis' inline method
+inline int AxisPermutation::outputAxis(int inputAxis) const
+{ return m_axes[inputAxis]; }
+
+// The 'isFlipped' inline method
+inline bool AxisPermutation::isFlipped(int inputAxis) const
+{ return m_flips[inputAxis]; }
+
+// The 'copySlice' template method
+template <class T>
+void AxisPermutation::copySlice(std::vector<T const*> const& rows,
+                                int const inputDims[3], unsigned int slice,
+                                T* output) const
+{
+    long strides[3];
+    long base = computeStrides(inputDims, strides);
+    T* target = output + base + strides[2] * static_cast<long>(slice);
+
+    int width = inputDims[0], height = inputDims[1];
+    if(strides[0] == 1)
+    {
+        // The rows stay contiguous
+        for(int y = 0 ; y < height ; y++)
+            memcpy(target + strides[1] * y, rows.at(y), width * sizeof(T));
+        return;
+    }
+
+    // The slice is transposed block by block
+    for(int y0 = 0 ; y0 < height ; y0 += s_blockSize)
+    {
+        int y1 = (y0 + s_blockSize < height) ? y0 + s_blockSize : height;
+        for(int x0 = 0 ; x0 < width ; x0 += s_blockSize)
+        {
+            int x1 = (x0 + s_blockSize < width) ? x0 + s_blockSize : width;
+            for(int y = y0 ; y < y1 ; y++)
+            {
+                T const* row = rows[y];
+                T* voxel = target + strides[1] * y + strides[0] * x0;
+                for(int x = x0 ; x < x1 ; x++, voxel += strides[0])
+                    *voxel = row[x];
+            }
+        }
+    }
+}
+
+#endif
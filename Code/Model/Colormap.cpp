@@ -32,12 +32,21 @@
 //! \author Quentin Smetz
 //!
 
+#include <cmath>
+
+#include <vtkSmartPointer.h>
+
 #include "Colormap.h"
 using namespace std;
 
+// Static attributes
+unsigned int Colormap::s_lastVersion = 0;
+
 // Constructor
 Colormap::Colormap() : QObject(), m_interpolationMode(Colormap::LINEAR)
-{}
+{
+    updateVersion();
+}
 
 // Copy constructor
 Colormap::Colormap(Colormap const& copy) : QObject()
@@ -54,6 +63,7 @@ Colormap& Colormap::operator=(Colormap const& copy)
 {
     m_colors = copy.m_colors;
     m_interpolationMode = copy.m_interpolationMode;
+    m_version = copy.m_version;
     emit modified();
 
     return *this;
@@ -66,6 +76,7 @@ void Colormap::setStartAt(unsigned int index, double start)
         return;
 
     m_colors.at(index).first = start;
+    updateVersion();
     emit colorModified(index, start, m_colors.at(index).second);
 }
 
@@ -73,6 +84,7 @@ void Colormap::setStartAt(unsigned int index, double start)
 void Colormap::setColorAt(unsigned int index, QColor const& color)
 {
     m_colors.at(index).second = color;
+    updateVersion();
     emit colorModified(index, m_colors.at(index).first, color);
 }
 
@@ -80,6 +92,7 @@ void Colormap::setColorAt(unsigned int index, QColor const& color)
 void Colormap::setInterpolationMode(InterpolationMode const& interpolationMode)
 {
     m_interpolationMode = interpolationMode;
+    updateVersion();
     emit interpolationModeModified(interpolationMode);
 }
 
@@ -97,6 +110,7 @@ void Colormap::addColor(double start, QColor const& color)
         if(start < it->first)
         {
             m_colors.insert(it, pair<double, QColor>(start, color));
+            updateVersion();
             emit colorAdded(i, start, color);
             return;
         }
@@ -105,6 +119,7 @@ void Colormap::addColor(double start, QColor const& color)
     }
 
     m_colors.push_back(pair<double, QColor>(start, color));
+    updateVersion();
     emit colorAdded(m_colors.size()-1, start, color);
 }
 
@@ -283,6 +298,30 @@ vtkColorTransferFunction* Colormap::computeVTKColorTransferFunction
     return func;
 }
 
+// The 'computeTable' method
+void Colormap::computeTable(Range const& onRange, Range const& onRangeWindow,
+                            int firstValue, vector<unsigned int>& table) const
+{
+    if(table.empty())
+        return;
+
+    vtkSmartPointer<vtkColorTransferFunction> func;
+    func.TakeReference(computeVTKColorTransferFunction(onRange, onRangeWindow));
+
+    // Sample the function on each stored value
+    int count = table.size();
+    vector<double> rgb(3 * count);
+    func->GetTable(firstValue, firstValue + count - 1, count, &rgb[0]);
+
+    for(int i = 0 ; i < count ; i++)
+    {
+        unsigned char* color = reinterpret_cast<unsigned char*>(&table[i]);
+        for(int c = 0 ; c < 3 ; c++)
+            color[c] = static_cast<unsigned char>(floor(0.5 + 255 * rgb[3*i + c]));
+        color[3] = 255;
+    }
+}
+
 // The 'changeValue' static method
 QColor Colormap::changeValue(QColor const& color, double value)
 {
@@ -294,6 +333,7 @@ QColor Colormap::changeValue(QColor const& color, double value)
 void Colormap::clear()
 {
     m_colors.clear();
+    updateVersion();
     emit modified();
 }
 
@@ -304,4 +344,11 @@ void Colormap::addColorToEnd(double start, QColor const& color)
         return;
 
     m_colors.push_back(pair<double, QColor>(start, color));
+    updateVersion();
+}
+
+// The 'updateVersion' private method
+void Colormap::updateVersion()
+{
+    m_version = ++s_lastVersion;
 }
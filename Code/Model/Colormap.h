@@ -114,6 +114,19 @@ class Colormap : public QObject
         //!
         inline unsigned int count() const;
 
+        //!
+        //! \brief The version method returns a number which identifies the
+        //!        content of the colormap.
+        //!
+        //! The version changes on each modification and is kept by the
+        //! copies, so that two colormaps with the same version are equal.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The version of the colormap.
+        //!
+        inline unsigned int version() const;
+
         //!
         //! \brief The startAt method returns the starting position of a color.
         //!
@@ -258,6 +271,28 @@ class Colormap : public QObject
         vtkColorTransferFunction* computeVTKColorTransferFunction
                        (Range const& onRange, Range const& onRangeWindow) const;
 
+        //!
+        //! \brief The computeTable method compiles the colormap into a dense
+        //!        table of RGBA colors, with one entry per stored value.
+        //!
+        //! The entries are sampled from the function returned by the
+        //! computeVTKColorTransferFunction method, so that both give the same
+        //! colors. Each entry holds the red, green, blue and alpha bytes in
+        //! this order in memory, the alpha being always opaque.
+        //!
+        //! \param onRange The 'range' parameter (see
+        //!                computeVTKColorTransferFunction).
+        //! \param onRangeWindow The 'range window' parameter (see
+        //!                      computeVTKColorTransferFunction).
+        //! \param firstValue The stored value of the first entry.
+        //! \param table The table to fill (its size gives the number of
+        //!              entries).
+        //!
+        //! \return Nothing.
+        //!
+        void computeTable(Range const& onRange, Range const& onRangeWindow,
+                          int firstValue, std::vector<unsigned int>& table) const;
+
         //!
         //! \brief The changeValue static method convert the copy color in
         //!        parameter in the HSV colorspace and change its value with
@@ -330,15 +365,29 @@ class Colormap : public QObject
         //!
         void addColorToEnd(double start, QColor const& color);
 
+        //!
+        //! \brief The updateVersion method gives a new version to the
+        //!        colormap, after a modification.
+        //!
+        //! \return Nothing.
+        //!
+        void updateVersion();
+
+        static unsigned int s_lastVersion; // The last given version
+
         std::vector< std::pair<double, QColor> > m_colors; // The list of starting
                                                          // points and colors
         InterpolationMode m_interpolationMode; // The way the colormap
                                                // interpolates its colors
+        unsigned int m_version;                // Identifies the content
 };
 
 // The 'count' method
 inline unsigned int Colormap::count() const { return m_colors.size(); }
 
+// The 'version' method
+inline unsigned int Colormap::version() const { return m_version; }
+
 // The 'startAt' method
 inline double Colormap::startAt(unsigned int index) const
 { return m_colors.at(index).first; }
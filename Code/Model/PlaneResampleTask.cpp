@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file PlaneResampleTask.cpp
+//! \brief The PlaneResampleTask.cpp file contains the definition of non-inline
+//!        methods of the PlaneResampleTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "PlaneResampleTask.h"
+#include "PlaneResampler.h"
+using namespace std;
+
+// Constructor
+PlaneResampleTask::PlaneResampleTask(PlaneResampler const& resampler,
+                                     int firstRow, int endRow, int width,
+                                     WindowLevelKernel const* kernel, unsigned char* out,
+                                     QSemaphore& done)
+    : QRunnable(), m_resampler(resampler), m_firstRow(firstRow),
+      m_endRow(endRow), m_width(width), m_kernel(kernel), m_out(out), m_done(done)
+{}
+
+// Destructor
+PlaneResampleTask::~PlaneResampleTask()
+{}
+
+// The 'run' method
+void PlaneResampleTask::run()
+{
+    if(m_kernel)
+        m_resampler.resampleRows(m_firstRow, m_endRow, m_width, *m_kernel, m_out);
+    else
+        m_resampler.resampleValueRows(m_firstRow, m_endRow, m_width);
+    m_done.release();
+}
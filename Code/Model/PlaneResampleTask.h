@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file PlaneResampleTask.h
+//! \brief The PlaneResampleTask.h file contains the interface of the
+//!        PlaneResampleTask class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef PLANERESAMPLETASK_H
+#define PLANERESAMPLETASK_H
+
+#include <iostream>
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include "WindowLevelKernel.h"
+
+class PlaneResampler;
+
+//!
+//! \brief The PlaneResampleTask class computes a band of rows of a plane for
+//!        the PlaneResampler which launched it.
+//!
+class PlaneResampleTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The PlaneResampleTask constructor prepares the computation of
+        //!        some rows of the plane.
+        //!
+        //! \param resampler The resampler which defines the plane.
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param width The number of pixels of a row.
+        //! \param kernel The kernel which colors the rows, or null to compute
+        //!               the values of the pixels (see
+        //!               PlaneResampler::resampleValues()).
+        //! \param out The output buffer of the whole plane (unused for the
+        //!            values).
+        //! \param done The semaphore released when the rows are computed.
+        //!
+        PlaneResampleTask(PlaneResampler const& resampler,
+                          int firstRow, int endRow, int width,
+                          WindowLevelKernel const* kernel, unsigned char* out,
+                          QSemaphore& done);
+
+        //!
+        //! \brief The PlaneResampleTask destructor.
+        //!
+        ~PlaneResampleTask();
+
+        //!
+        //! \brief The run method computes the rows.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        PlaneResampler const& m_resampler;
+        int m_firstRow, m_endRow, m_width;
+        WindowLevelKernel const* m_kernel; // Null for the values
+        unsigned char* m_out;
+        QSemaphore& m_done;
+};
+
+#endif
@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file PlaneResampler.cpp
+//! \brief The PlaneResampler.cpp file contains the definition of non-inline
+//!        methods of the PlaneResampler class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <cmath>
+#include <limits>
+
+#include <QSemaphore>
+
+#include "PlaneResampler.h"
+#include "PlaneResampleTask.h"
+using namespace std;
+
+// The 'locate' function finds the voxel before a position along an axis and
+// the weight of the next voxel, it returns false outside the series
+static inline bool locate(double position, int dim, int& index, double& weight)
+{
+    if(dim == 1)
+    {
+        index = 0;
+        weight = 0;
+        return position > -0.5 && position < 0.5;
+    }
+
+    if(position < 0 || position > dim - 1)
+        return false;
+
+    index = static_cast<int>(position);
+    if(index > dim - 2)
+        index = dim - 2;
+    weight = position - index;
+    return true;
+}
+
+// The 'toVoxel' function converts an interpolated value to the voxel type
+template <class T>
+static inline T toVoxel(double value)
+{
+    if(numeric_limits<T>::is_integer)
+        return static_cast<T>(floor(value + 0.5));
+    return static_cast<T>(value);
+}
+
+// The 'interpolateRow' function interpolates a row of a plane, given in voxel
+// indexes, the values and the flags of the pixels are written every pixelStep
+template <class T>
+static void interpolateRow(T const* voxels, int const dims[3], vtkIdType const increments[3],
+                           double const start[3], double const step[3], int width,
+                           T* row, unsigned char* inside, vtkIdType pixelStep)
+{
+    // The offsets to the next voxels
+    vtkIdType next[3];
+    for(int a = 0 ; a < 3 ; a++)
+        next[a] = (dims[a] > 1) ? increments[a] : 0;
+
+    for(int i = 0 ; i < width ; i++, row += pixelStep, inside += pixelStep)
+    {
+        int ix, iy, iz;
+        double fx, fy, fz;
+        *inside = locate(start[0] + i * step[0], dims[0], ix, fx)
+               && locate(start[1] + i * step[1], dims[1], iy, fy)
+               && locate(start[2] + i * step[2], dims[2], iz, fz);
+        if(!*inside)
+        {
+            *row = 0;
+            continue;
+        }
+
+        // Trilinear interpolation between the eight surrounding voxels
+        T const* v = voxels + ix * increments[0] + iy * increments[1] + iz * increments[2];
+        double c00 = v[0] + fx * (static_cast<double>(v[next[0]]) - v[0]);
+        double c10 = v[next[1]] + fx * (static_cast<double>(v[next[1] + next[0]]) - v[next[1]]);
+        double c01 = v[next[2]] + fx * (static_cast<double>(v[next[2] + next[0]]) - v[next[2]]);
+        double c11 = v[next[2] + next[1]]
+                   + fx * (static_cast<double>(v[next[2] + next[1] + next[0]]) - v[next[2] + next[1]]);
+        double c0 = c00 + fy * (c10 - c00);
+        double c1 = c01 + fy * (c11 - c01);
+        *row = toVoxel<T>(c0 + fz * (c1 - c0));
+    }
+}
+
+// The 'resampleSeriesRows' function interpolates and colors rows of a plane,
+// given in voxel indexes
+template <class T>
+static void resampleSeriesRows(T const* voxels, int const dims[3],
+                               vtkIdType const increments[3], double const origin[3],
+                               double const step[3], double const columnStep[3],
+                               int firstRow, int endRow, int width,
+                               WindowLevelKernel const& kernel, unsigned char* out)
+{
+    vector<T> row(width);
+    vector<unsigned char> inside(width);
+    for(int j = firstRow ; j < endRow ; j++)
+    {
+        double start[3];
+        for(int a = 0 ; a < 3 ; a++)
+            start[a] = origin[a] + j * columnStep[a];
+        interpolateRow(voxels, dims, increments, start, step, width, &row[0], &inside[0], 1);
+
+        // Color the row, the pixels outside the series are transparent
+        unsigned char* rowOut = out + 4 * static_cast<long>(j) * width;
+        kernel.mapRow(&row[0], rowOut, width);
+        for(int i = 0 ; i < width ; i++)
+            if(!inside[i])
+                rowOut[4*i + 3] = 0;
+    }
+}
+
+// The 'resampleSeriesValues' function interpolates rows of a plane, given in
+// voxel indexes, without coloring them
+template <class T>
+static void resampleSeriesValues(T const* voxels, int const dims[3],
+                                 vtkIdType const increments[3], double const origin[3],
+                                 double const step[3], double const columnStep[3],
+                                 int firstRow, int endRow, int width, T* values,
+                                 unsigned char* inside, vtkIdType pixelStep, vtkIdType rowStep)
+{
+    for(int j = firstRow ; j < endRow ; j++)
+    {
+        double start[3];
+        for(int a = 0 ; a < 3 ; a++)
+            start[a] = origin[a] + j * columnStep[a];
+        interpolateRow(voxels, dims, increments, start, step, width,
+                       values + j * rowStep, inside + j * rowStep, pixelStep);
+    }
+}
+
+// Constructor
+PlaneResampler::PlaneResampler()
+    : m_voxels(0), m_scalarType(VTK_VOID), m_values(0), m_inside(0),
+      m_pixelStep(1), m_valueRowStep(0), m_pool()
+{
+    for(int a = 0 ; a < 3 ; a++)
+    {
+        m_origin[a] = m_rowStep[a] = m_columnStep[a] = 0;
+        m_indexOrigin[a] = m_indexRowStep[a] = m_indexColumnStep[a] = 0;
+        m_dims[a] = 1;
+        m_increments[a] = 0;
+    }
+}
+
+// Destructor
+PlaneResampler::~PlaneResampler()
+{
+    m_pool.waitForDone();
+}
+
+// The 'setPlane' method
+void PlaneResampler::setPlane(double const origin[3], double const rowStep[3],
+                              double const columnStep[3])
+{
+    for(int a = 0 ; a < 3 ; a++)
+    {
+        m_origin[a] = origin[a];
+        m_rowStep[a] = rowStep[a];
+        m_columnStep[a] = columnStep[a];
+    }
+}
+
+// The 'resample' method
+void PlaneResampler::resample(vtkImageData* series, int width, int height,
+                              WindowLevelKernel const& kernel, unsigned char* out)
+{
+    readSeries(series);
+
+    // Share the rows among the threads and wait for all of them
+    QSemaphore done;
+    int taskCount = 0;
+    for(int first = 0 ; first < height ; first += s_rowsPerTask, taskCount++)
+    {
+        int end = (first + s_rowsPerTask < height) ? first + s_rowsPerTask : height;
+        m_pool.start(new PlaneResampleTask(*this, first, end, width, &kernel, out, done));
+    }
+
+    done.acquire(taskCount);
+}
+
+// The 'resampleValues' method
+void PlaneResampler::resampleValues(vtkImageData* series, int width, int height,
+                                    void* values, unsigned char* inside,
+                                    vtkIdType pixelStep, vtkIdType rowStep)
+{
+    readSeries(series);
+    m_values = values;
+    m_inside = inside;
+    m_pixelStep = pixelStep;
+    m_valueRowStep = rowStep;
+
+    // Share the rows among the threads and wait for all of them
+    QSemaphore done;
+    int taskCount = 0;
+    for(int first = 0 ; first < height ; first += s_rowsPerTask, taskCount++)
+    {
+        int end = (first + s_rowsPerTask < height) ? first + s_rowsPerTask : height;
+        m_pool.start(new PlaneResampleTask(*this, first, end, width, 0, 0, done));
+    }
+
+    done.acquire(taskCount);
+}
+
+// The 'resampleRows' method
+void PlaneResampler::resampleRows(int firstRow, int endRow, int width,
+                                  WindowLevelKernel const& kernel, unsigned char* out) const
+{
+    switch(m_scalarType)
+    {
+        vtkTemplateMacro(resampleSeriesRows(static_cast<VTK_TT const*>(m_voxels), m_dims,
+                                            m_increments, m_indexOrigin, m_indexRowStep,
+                                            m_indexColumnStep, firstRow, endRow,
+                                            width, kernel, out));
+    }
+}
+
+// The 'resampleValueRows' method
+void PlaneResampler::resampleValueRows(int firstRow, int endRow, int width) const
+{
+    switch(m_scalarType)
+    {
+        vtkTemplateMacro(resampleSeriesValues(static_cast<VTK_TT const*>(m_voxels), m_dims,
+                                              m_increments, m_indexOrigin, m_indexRowStep,
+                                              m_indexColumnStep, firstRow, endRow, width,
+                                              static_cast<VTK_TT*>(m_values), m_inside,
+                                              m_pixelStep, m_valueRowStep));
+    }
+}
+
+// The 'readSeries' private method
+void PlaneResampler::readSeries(vtkImageData* series)
+{
+    // The geometry of the series is read once, before the threads start
+    series->GetDimensions(m_dims);
+    vtkIdType* increments = series->GetIncrements();
+    int* extent = series->GetExtent();
+    double* origin = series->GetOrigin();
+    double* spacing = series->GetSpacing();
+    for(int a = 0 ; a < 3 ; a++)
+    {
+        m_increments[a] = increments[a];
+        m_indexOrigin[a] = (m_origin[a] - origin[a]) / spacing[a] - extent[2*a];
+        m_indexRowStep[a] = m_rowStep[a] / spacing[a];
+        m_indexColumnStep[a] = m_columnStep[a] / spacing[a];
+    }
+    m_voxels = series->GetScalarPointer();
+    m_scalarType = series->GetScalarType();
+}
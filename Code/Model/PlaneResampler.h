@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file PlaneResampler.h
+//! \brief The PlaneResampler.h file contains the interface of the
+//!        PlaneResampler class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef PLANERESAMPLER_H
+#define PLANERESAMPLER_H
+
+#include <iostream>
+#include <vector>
+
+#include <QThreadPool>
+
+#include <vtkImageData.h>
+
+#include "WindowLevelKernel.h"
+
+//!
+//! \brief The PlaneResampler class computes the colored image of an arbitrary
+//!        plane which cuts a series.
+//!
+//! Each pixel of the plane is interpolated trilinearly from the eight voxels
+//! which surround it, then the rows are colored by a WindowLevelKernel. Only
+//! the pixels of the plane are computed, and the rows are shared among the
+//! threads of a pool. The pixels outside the series are transparent.
+//!
+class PlaneResampler
+{
+    public:
+        //!
+        //! \brief The PlaneResampler constructor.
+        //!
+        PlaneResampler();
+
+        //!
+        //! \brief The PlaneResampler destructor.
+        //!
+        ~PlaneResampler();
+
+        //!
+        //! \brief The setPlane method defines the resampled plane, in the
+        //!        physical coordinates of the series.
+        //!
+        //! The pixel (i, j) of the plane is at origin + i*rowStep + j*columnStep.
+        //!
+        //! \param origin The position of the first pixel.
+        //! \param rowStep The step between two pixels of a row.
+        //! \param columnStep The step between two rows.
+        //!
+        //! \return Nothing.
+        //!
+        void setPlane(double const origin[3], double const rowStep[3],
+                      double const columnStep[3]);
+
+        //!
+        //! \brief The resample method computes the colored pixels of the plane
+        //!        with all the threads of the pool.
+        //!
+        //! The method returns when every row is computed.
+        //!
+        //! \param series The resampled series.
+        //! \param width The number of pixels of a row.
+        //! \param height The number of rows.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer (4 bytes per pixel).
+        //!
+        //! \return Nothing.
+        //!
+        void resample(vtkImageData* series, int width, int height,
+                      WindowLevelKernel const& kernel, unsigned char* out);
+
+        //!
+        //! \brief The resampleRows method computes the colored pixels of some
+        //!        rows of the plane.
+        //!
+        //! The method is called by the tasks of the pool, during a call to the
+        //! resample method, and can be called by several threads at the same
+        //! time.
+        //!
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param width The number of pixels of a row.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer of the whole plane.
+        //!
+        //! \return Nothing.
+        //!
+        void resampleRows(int firstRow, int endRow, int width,
+                          WindowLevelKernel const& kernel, unsigned char* out) const;
+
+        //!
+        //! \brief The resampleValues method computes the interpolated values of
+        //!        the pixels of the plane, without coloring them, with all the
+        //!        threads of the pool.
+        //!
+        //! The value of the pixel (i, j) is written at values + i*pixelStep +
+        //! j*rowStep, in the scalar type of the series, so that the plane can be
+        //! written in a volume. The inside buffer has the same layout and tells
+        //! if each pixel is in the series (the pixels outside are 0).
+        //!
+        //! \param series The resampled series.
+        //! \param width The number of pixels of a row.
+        //! \param height The number of rows.
+        //! \param values The output values.
+        //! \param inside The output flags (1 byte per pixel).
+        //! \param pixelStep The step between two pixels of a row in the buffers.
+        //! \param rowStep The step between two rows in the buffers.
+        //!
+        //! \return Nothing.
+        //!
+        void resampleValues(vtkImageData* series, int width, int height,
+                            void* values, unsigned char* inside,
+                            vtkIdType pixelStep, vtkIdType rowStep);
+
+        //!
+        //! \brief The resampleValueRows method computes the values of some rows
+        //!        of the plane.
+        //!
+        //! The method is called by the tasks of the pool, during a call to the
+        //! resampleValues method, and can be called by several threads at the
+        //! same time.
+        //!
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param width The number of pixels of a row.
+        //!
+        //! \return Nothing.
+        //!
+        void resampleValueRows(int firstRow, int endRow, int width) const;
+
+    private:
+        //!
+        //! \brief The readSeries method keeps the geometry and the voxels of
+        //!        the resampled series, and the plane in voxel indexes.
+        //!
+        //! \param series The resampled series.
+        //!
+        //! \return Nothing.
+        //!
+        void readSeries(vtkImageData* series);
+
+        static int const s_rowsPerTask = 16; // The rows computed by a task
+
+        double m_origin[3], m_rowStep[3], m_columnStep[3]; // The plane
+
+        // The plane in voxel indexes and the voxels of the resampled series
+        double m_indexOrigin[3], m_indexRowStep[3], m_indexColumnStep[3];
+        void* m_voxels;
+        int m_dims[3];
+        vtkIdType m_increments[3];
+        int m_scalarType;
+
+        // The buffers of the values, during a call to resampleValues
+        void* m_values;
+        unsigned char* m_inside;
+        vtkIdType m_pixelStep, m_valueRowStep;
+
+        QThreadPool m_pool; // The resampling threads
+};
+
+#endif
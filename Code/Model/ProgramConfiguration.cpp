@@ -59,7 +59,9 @@ void ProgramConfiguration::free()
 
 // Constructor
 ProgramConfiguration::ProgramConfiguration(string configFileName)
-    : m_imageDirectory(""), m_defaultHost(""), m_defaultPort(1), m_lutDirectory("")
+    : m_imageDirectory(""), m_defaultHost(""), m_defaultPort(1), m_lutDirectory(""),
+      m_loadingThreadCount(4), m_concurrentLoadCount(2), m_progressiveLoading(true),
+      m_cacheDirectory(""), m_cacheSize(4096)
 {
     ifstream file(configFileName.c_str(), ios::in);
 
@@ -121,6 +123,33 @@ ProgramConfiguration::ProgramConfiguration(string configFileName)
             {
                 m_lutDirectory = paramContent;
             }
+            else if(paramName == "LOADING_THREADS")
+            {
+                istringstream iss(paramContent);
+                iss >> m_loadingThreadCount;
+                if(m_loadingThreadCount == 0)
+                    m_loadingThreadCount = 1;
+            }
+            else if(paramName == "CONCURRENT_LOADS")
+            {
+                istringstream iss(paramContent);
+                iss >> m_concurrentLoadCount;
+                if(m_concurrentLoadCount == 0)
+                    m_concurrentLoadCount = 1;
+            }
+            else if(paramName == "PROGRESSIVE_LOADING")
+            {
+                m_progressiveLoading = (paramContent != "0");
+            }
+            else if(paramName == "CACHE_DIRECTORY")
+            {
+                m_cacheDirectory = paramContent;
+            }
+            else if(paramName == "CACHE_SIZE")
+            {
+                istringstream iss(paramContent);
+                iss >> m_cacheSize;
+            }
         }
 
         file.close();
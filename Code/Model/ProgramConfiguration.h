@@ -128,6 +128,61 @@ class ProgramConfiguration
         //!
         inline std::string const& lutDirectory() const;
 
+        //!
+        //! \brief The loadingThreadCount method returns the number of slices
+        //!        which can be downloaded concurrently from the Orthanc server
+        //!        when a series is loaded.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The number of concurrent slice downloads.
+        //!
+        inline unsigned int loadingThreadCount() const;
+
+        //!
+        //! \brief The concurrentLoadCount method returns the number of series
+        //!        which can be loaded at the same time.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The number of concurrent series loads.
+        //!
+        inline unsigned int concurrentLoadCount() const;
+
+        //!
+        //! \brief The progressiveLoading method indicates if a series must be
+        //!        displayed while its slices are still being downloaded.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A boolean which is true if the series are displayed
+        //!         progressively.
+        //!
+        inline bool progressiveLoading() const;
+
+        //!
+        //! \brief The cacheDirectory method returns the path to the directory
+        //!        where the loaded series are cached.
+        //!
+        //! The method is inline.
+        //! The cache is disabled if the path is empty.
+        //!
+        //! \return A string object which contains the path to the cache
+        //!         directory.
+        //!
+        inline std::string const& cacheDirectory() const;
+
+        //!
+        //! \brief The cacheSize method returns the maximum size of the cache
+        //!        directory (in megabytes).
+        //!
+        //! The method is inline.
+        //! The size of the cache is not limited if it is equal to zero.
+        //!
+        //! \return The maximum size of the cache.
+        //!
+        inline unsigned int cacheSize() const;
+
         //!
         //! \brief The ProgramConfiguration destructor.
         //!
@@ -143,6 +198,11 @@ class ProgramConfiguration
         unsigned short m_defaultPort;
         std::map<std::string, Range> m_hounsfieldPresets;
         std::string m_lutDirectory;
+        unsigned int m_loadingThreadCount;
+        unsigned int m_concurrentLoadCount;
+        bool m_progressiveLoading;
+        std::string m_cacheDirectory;
+        unsigned int m_cacheSize;
 };
 
 // The 'imageDirectory' method
@@ -161,4 +221,21 @@ inline std::map<std::string, Range> const& ProgramConfiguration::huPresets() con
 // The 'lutDirectory' method
 inline std::string const& ProgramConfiguration::lutDirectory() const { return m_lutDirectory; }
 
+// The 'loadingThreadCount' method
+inline unsigned int ProgramConfiguration::loadingThreadCount() const
+{ return m_loadingThreadCount; }
+
+// The 'concurrentLoadCount' method
+inline unsigned int ProgramConfiguration::concurrentLoadCount() const
+{ return m_concurrentLoadCount; }
+
+// The 'progressiveLoading' method
+inline bool ProgramConfiguration::progressiveLoading() const { return m_progressiveLoading; }
+
+// The 'cacheDirectory' method
+inline std::string const& ProgramConfiguration::cacheDirectory() const { return m_cacheDirectory; }
+
+// The 'cacheSize' method
+inline unsigned int ProgramConfiguration::cacheSize() const { return m_cacheSize; }
+
 #endif
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RegistrationTask.cpp
+//! \brief The RegistrationTask.cpp file contains the definition of non-inline
+//!        methods of the RegistrationTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "RegistrationTask.h"
+#include "RigidRegistration.h"
+using namespace std;
+
+// Constructor
+RegistrationTask::RegistrationTask(RigidRegistration const& registration,
+                                   int firstSample, int endSample, double const* transform,
+                                   int* histogram, QSemaphore& done)
+    : QRunnable(), m_registration(registration), m_firstSample(firstSample),
+      m_endSample(endSample), m_transform(transform), m_histogram(histogram), m_done(done)
+{}
+
+// Destructor
+RegistrationTask::~RegistrationTask()
+{}
+
+// The 'run' method
+void RegistrationTask::run()
+{
+    m_registration.accumulateSamples(m_firstSample, m_endSample, m_transform, m_histogram);
+    m_done.release();
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RegistrationTask.h
+//! \brief The RegistrationTask.h file contains the interface of the
+//!        RegistrationTask class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef REGISTRATIONTASK_H
+#define REGISTRATIONTASK_H
+
+#include <iostream>
+
+#include <QRunnable>
+#include <QSemaphore>
+
+class RigidRegistration;
+
+//!
+//! \brief The RegistrationTask class adds a band of samples to a joint
+//!        histogram for the RigidRegistration which launched it.
+//!
+class RegistrationTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The RegistrationTask constructor prepares the accumulation
+        //!        of some samples.
+        //!
+        //! \param registration The registration which holds the samples.
+        //! \param firstSample The first sample.
+        //! \param endSample The sample after the last one.
+        //! \param transform The transform from the scene to the voxel indexes
+        //!                  of the moving series.
+        //! \param histogram The joint histogram of the task.
+        //! \param done The semaphore released when the samples are added.
+        //!
+        RegistrationTask(RigidRegistration const& registration,
+                         int firstSample, int endSample, double const* transform,
+                         int* histogram, QSemaphore& done);
+
+        //!
+        //! \brief The RegistrationTask destructor.
+        //!
+        ~RegistrationTask();
+
+        //!
+        //! \brief The run method adds the samples.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        RigidRegistration const& m_registration;
+        int m_firstSample, m_endSample;
+        double const* m_transform;
+        int* m_histogram;
+        QSemaphore& m_done;
+};
+
+#endif
@@ -0,0 +1,399 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RigidRegistration.cpp
+//! \brief The RigidRegistration.cpp file contains the definition of non-inline
+//!        methods of the RigidRegistration class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <cmath>
+#include <algorithm>
+
+#include <QSemaphore>
+
+#include "RigidRegistration.h"
+#include "RegistrationTask.h"
+using namespace std;
+
+// The sizes of the voxels of the levels of the pyramid (in mm)
+static double const levelSizes[] = { 8, 4, 2 };
+static int const levelCount = sizeof(levelSizes) / sizeof(levelSizes[0]);
+
+// The 'rotationCenter' function returns the point around which the viewers
+// rotate a series (the origin of their props)
+static void rotationCenter(vtkImageData* series, double center[3])
+{
+    double* bounds = series->GetBounds();
+    for(int a = 0 ; a < 3 ; a++)
+        center[a] = (bounds[2*a+1] - bounds[2*a]) / 2;
+}
+
+// The 'downsampleVoxels' function averages the blocks of voxels of a series
+template <class T>
+static void downsampleVoxels(T const* voxels, vtkIdType const increments[3],
+                             int const factors[3], int const dims[3], float* out)
+{
+    double blockSize = factors[0] * factors[1] * factors[2];
+    for(int k = 0 ; k < dims[2] ; k++)
+    {
+        for(int j = 0 ; j < dims[1] ; j++)
+        {
+            for(int i = 0 ; i < dims[0] ; i++, out++)
+            {
+                T const* block = voxels + i * factors[0] * increments[0]
+                               + j * factors[1] * increments[1] + k * factors[2] * increments[2];
+                double sum = 0;
+                for(int z = 0 ; z < factors[2] ; z++)
+                    for(int y = 0 ; y < factors[1] ; y++)
+                        for(int x = 0 ; x < factors[0] ; x++)
+                            sum += block[x * increments[0] + y * increments[1] + z * increments[2]];
+                *out = static_cast<float>(sum / blockSize);
+            }
+        }
+    }
+}
+
+// The 'locate' function finds the voxel before a position along an axis and
+// the weight of the next voxel, it returns false outside the volume
+static inline bool locate(double position, int dim, int& index, double& weight)
+{
+    if(dim == 1)
+    {
+        index = 0;
+        weight = 0;
+        return position > -0.5 && position < 0.5;
+    }
+
+    if(position < 0 || position > dim - 1)
+        return false;
+
+    index = static_cast<int>(position);
+    if(index > dim - 2)
+        index = dim - 2;
+    weight = position - index;
+    return true;
+}
+
+// The 'entropy' function computes the entropy of a histogram
+static double entropy(vector<double> const& histogram, double total)
+{
+    double sum = 0;
+    for(unsigned int i = 0 ; i < histogram.size() ; i++)
+    {
+        if(histogram[i] > 0)
+        {
+            double p = histogram[i] / total;
+            sum -= p * log(p);
+        }
+    }
+    return sum;
+}
+
+// Constructor
+RigidRegistration::RigidRegistration()
+    : m_fixedSeries(0), m_movingSeries(0), m_movingScale(0), m_pool()
+{
+    for(int a = 0 ; a < 3 ; a++)
+        m_movingCenter[a] = 0;
+}
+
+// Destructor
+RigidRegistration::~RigidRegistration()
+{
+    m_pool.waitForDone();
+}
+
+// The 'setFixed' method
+void RigidRegistration::setFixed(vtkImageData* series, Vector3D const& translation,
+                                 Vector3D const& rotation)
+{
+    m_fixedSeries = series;
+    m_fixedTranslation = translation;
+    m_fixedRotation = rotation;
+}
+
+// The 'setMoving' method
+void RigidRegistration::setMoving(vtkImageData* series)
+{
+    m_movingSeries = series;
+    rotationCenter(series, m_movingCenter);
+}
+
+// The 'run' method
+double RigidRegistration::run(Vector3D& translation, Vector3D& rotation)
+{
+    double parameters[6] = { translation.x(), translation.y(), translation.z(),
+                             rotation.x(), rotation.y(), rotation.z() };
+    double best = 0;
+
+    for(int level = 0 ; level < levelCount ; level++)
+    {
+        double size = levelSizes[level];
+        prepareLevel(size);
+
+        // The steps of the translation (in mm) and of the rotation (in
+        // degrees) start with the size of the voxels, and are halved when no
+        // move improves the similarity
+        double steps[2] = { size, size / 2 };
+        best = similarity(parameters);
+        for(int iteration = 0 ; iteration < s_maxIterations && steps[0] >= size / 8 ; iteration++)
+        {
+            double candidate[6], bestCandidate[6];
+            double bestValue = best;
+            for(int p = 0 ; p < 6 ; p++)
+            {
+                for(int sign = -1 ; sign <= 1 ; sign += 2)
+                {
+                    copy(parameters, parameters + 6, candidate);
+                    candidate[p] += sign * steps[p < 3 ? 0 : 1];
+                    double value = similarity(candidate);
+                    if(value > bestValue)
+                    {
+                        bestValue = value;
+                        copy(candidate, candidate + 6, bestCandidate);
+                    }
+                }
+            }
+
+            if(bestValue > best)
+            {
+                best = bestValue;
+                copy(bestCandidate, bestCandidate + 6, parameters);
+            }
+            else
+            {
+                steps[0] /= 2;
+                steps[1] /= 2;
+            }
+        }
+    }
+
+    translation = Vector3D(parameters[0], parameters[1], parameters[2]);
+    rotation = Vector3D(parameters[3], parameters[4], parameters[5]);
+    return best;
+}
+
+// The 'accumulateSamples' method
+void RigidRegistration::accumulateSamples(int firstSample, int endSample,
+                                          double const transform[12], int* histogram) const
+{
+    int const* dims = m_moving.dims;
+    float const* values = &m_moving.values[0];
+    vtkIdType increments[3] = { 1, dims[0], static_cast<vtkIdType>(dims[0]) * dims[1] };
+    vtkIdType next[3];
+    for(int a = 0 ; a < 3 ; a++)
+        next[a] = (dims[a] > 1) ? increments[a] : 0;
+
+    for(int s = firstSample ; s < endSample ; s++)
+    {
+        // The place of the sample in the voxel indexes of the moving series
+        double const* point = &m_samplePoints[3*s];
+        double position[3];
+        for(int a = 0 ; a < 3 ; a++)
+            position[a] = transform[4*a] * point[0] + transform[4*a+1] * point[1]
+                        + transform[4*a+2] * point[2] + transform[4*a+3];
+
+        int ix, iy, iz;
+        double fx, fy, fz;
+        if(!locate(position[0], dims[0], ix, fx) || !locate(position[1], dims[1], iy, fy)
+           || !locate(position[2], dims[2], iz, fz))
+            continue;
+
+        // Trilinear interpolation between the eight surrounding voxels
+        float const* v = values + ix * increments[0] + iy * increments[1] + iz * increments[2];
+        double c00 = v[0] + fx * (v[next[0]] - v[0]);
+        double c10 = v[next[1]] + fx * (v[next[1] + next[0]] - v[next[1]]);
+        double c01 = v[next[2]] + fx * (v[next[2] + next[0]] - v[next[2]]);
+        double c11 = v[next[2] + next[1]] + fx * (v[next[2] + next[1] + next[0]] - v[next[2] + next[1]]);
+        double c0 = c00 + fy * (c10 - c00);
+        double c1 = c01 + fy * (c11 - c01);
+        double value = c0 + fz * (c1 - c0);
+
+        int bin = static_cast<int>((value - m_moving.low) * m_movingScale);
+        bin = max(0, min(s_binCount - 1, bin));
+        histogram[m_sampleBins[s] * s_binCount + bin]++;
+    }
+}
+
+// The 'downsample' private static method
+void RigidRegistration::downsample(vtkImageData* series, double size, Volume& volume)
+{
+    int dims[3], factors[3];
+    series->GetDimensions(dims);
+    double* origin = series->GetOrigin();
+    double* spacing = series->GetSpacing();
+    int* extent = series->GetExtent();
+    for(int a = 0 ; a < 3 ; a++)
+    {
+        factors[a] = max(1, static_cast<int>(floor(size / spacing[a] + 0.5)));
+        volume.dims[a] = max(1, dims[a] / factors[a]);
+        factors[a] = min(factors[a], dims[a]);
+        volume.spacing[a] = spacing[a] * factors[a];
+        volume.origin[a] = origin[a] + spacing[a] * (extent[2*a] + (factors[a] - 1) / 2.0);
+    }
+
+    volume.values.resize(static_cast<vtkIdType>(volume.dims[0]) * volume.dims[1] * volume.dims[2]);
+    switch(series->GetScalarType())
+    {
+        vtkTemplateMacro(downsampleVoxels(static_cast<VTK_TT const*>(series->GetScalarPointer()),
+                                          series->GetIncrements(), factors, volume.dims,
+                                          &volume.values[0]));
+    }
+
+    volume.low = *min_element(volume.values.begin(), volume.values.end());
+    volume.high = *max_element(volume.values.begin(), volume.values.end());
+}
+
+// The 'rotationMatrix' private static method
+void RigidRegistration::rotationMatrix(Vector3D const& rotation, double matrix[9])
+{
+    // The viewers rotate around Y, then X, then Z
+    double const toRadians = 3.14159265358979323846 / 180;
+    double cx = cos(rotation.x() * toRadians), sx = sin(rotation.x() * toRadians);
+    double cy = cos(rotation.y() * toRadians), sy = sin(rotation.y() * toRadians);
+    double cz = cos(rotation.z() * toRadians), sz = sin(rotation.z() * toRadians);
+
+    double x[9] = { 1, 0, 0,  0, cx, -sx,  0, sx, cx };
+    double y[9] = { cy, 0, sy,  0, 1, 0,  -sy, 0, cy };
+    double z[9] = { cz, -sz, 0,  sz, cz, 0,  0, 0, 1 };
+
+    double xy[9];
+    for(int i = 0 ; i < 3 ; i++)
+        for(int j = 0 ; j < 3 ; j++)
+            xy[3*i+j] = x[3*i] * y[j] + x[3*i+1] * y[3+j] + x[3*i+2] * y[6+j];
+    for(int i = 0 ; i < 3 ; i++)
+        for(int j = 0 ; j < 3 ; j++)
+            matrix[3*i+j] = z[3*i] * xy[j] + z[3*i+1] * xy[3+j] + z[3*i+2] * xy[6+j];
+}
+
+// The 'prepareLevel' private method
+void RigidRegistration::prepareLevel(double size)
+{
+    Volume fixed;
+    downsample(m_fixedSeries, size, fixed);
+    downsample(m_movingSeries, size, m_moving);
+    m_movingScale = (m_moving.high > m_moving.low) ? s_binCount / (m_moving.high - m_moving.low) : 0;
+    double fixedScale = (fixed.high > fixed.low) ? s_binCount / (fixed.high - fixed.low) : 0;
+
+    // The samples are a regular subset of the voxels of the fixed series
+    double count = static_cast<double>(fixed.dims[0]) * fixed.dims[1] * fixed.dims[2];
+    int stride = max(1, static_cast<int>(ceil(pow(count / s_maxSamples, 1.0 / 3))));
+
+    // They are placed in the scene like the viewers place the fixed series
+    double rotation[9], center[3];
+    rotationMatrix(m_fixedRotation, rotation);
+    rotationCenter(m_fixedSeries, center);
+    double translation[3] = { m_fixedTranslation.x(), m_fixedTranslation.y(),
+                              m_fixedTranslation.z() };
+
+    m_samplePoints.clear();
+    m_sampleBins.clear();
+    for(int k = 0 ; k < fixed.dims[2] ; k += stride)
+    {
+        for(int j = 0 ; j < fixed.dims[1] ; j += stride)
+        {
+            for(int i = 0 ; i < fixed.dims[0] ; i += stride)
+            {
+                int index[3] = { i, j, k };
+                double offset[3];
+                for(int a = 0 ; a < 3 ; a++)
+                    offset[a] = fixed.origin[a] + index[a] * fixed.spacing[a] - center[a];
+                for(int a = 0 ; a < 3 ; a++)
+                    m_samplePoints.push_back(rotation[3*a] * offset[0] + rotation[3*a+1] * offset[1]
+                                             + rotation[3*a+2] * offset[2]
+                                             + center[a] + translation[a]);
+
+                float value = fixed.values[i + fixed.dims[0] * (j + fixed.dims[1] * k)];
+                int bin = static_cast<int>((value - fixed.low) * fixedScale);
+                m_sampleBins.push_back(static_cast<unsigned char>(max(0, min(s_binCount - 1, bin))));
+            }
+        }
+    }
+}
+
+// The 'similarity' private method
+double RigidRegistration::similarity(double const parameters[6])
+{
+    int sampleCount = m_sampleBins.size();
+    if(sampleCount == 0 || m_moving.values.empty())
+        return 0;
+
+    // The transform from the scene to the voxel indexes of the moving series:
+    // the inverse rotation around its center after the inverse translation
+    double rotation[9];
+    rotationMatrix(Vector3D(parameters[3], parameters[4], parameters[5]), rotation);
+    double transform[12];
+    for(int a = 0 ; a < 3 ; a++)
+    {
+        double shift = m_movingCenter[a] - m_moving.origin[a];
+        for(int j = 0 ; j < 3 ; j++)
+        {
+            transform[4*a+j] = rotation[3*j+a] / m_moving.spacing[a];
+            shift -= rotation[3*j+a] * (m_movingCenter[j] + parameters[j]);
+        }
+        transform[4*a+3] = shift / m_moving.spacing[a];
+    }
+
+    // Each task fills its own histogram
+    int binCount = s_binCount * s_binCount;
+    vector<int> histograms;
+    QSemaphore done;
+    int taskCount = 0;
+    histograms.resize(((sampleCount + s_samplesPerTask - 1) / s_samplesPerTask) * binCount, 0);
+    for(int first = 0 ; first < sampleCount ; first += s_samplesPerTask, taskCount++)
+    {
+        int end = (first + s_samplesPerTask < sampleCount) ? first + s_samplesPerTask : sampleCount;
+        m_pool.start(new RegistrationTask(*this, first, end, transform,
+                                          &histograms[taskCount * binCount], done));
+    }
+    done.acquire(taskCount);
+
+    vector<double> joint(binCount, 0), fixed(s_binCount, 0), moving(s_binCount, 0);
+    double total = 0;
+    for(int t = 0 ; t < taskCount ; t++)
+    {
+        for(int b = 0 ; b < binCount ; b++)
+        {
+            double count = histograms[t * binCount + b];
+            joint[b] += count;
+            fixed[b / s_binCount] += count;
+            moving[b % s_binCount] += count;
+            total += count;
+        }
+    }
+
+    // The series must overlap on an eighth of the samples at least
+    if(total < sampleCount / 8.0 || total == 0)
+        return 0;
+
+    double jointEntropy = entropy(joint, total);
+    if(jointEntropy <= 0)
+        return 0;
+    return (entropy(fixed, total) + entropy(moving, total)) / jointEntropy;
+}
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RigidRegistration.h
+//! \brief The RigidRegistration.h file contains the interface of the
+//!        RigidRegistration class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef RIGIDREGISTRATION_H
+#define RIGIDREGISTRATION_H
+
+#include <iostream>
+#include <vector>
+
+#include <QThreadPool>
+
+#include <vtkImageData.h>
+
+#include "Vector3D.h"
+
+//!
+//! \brief The RigidRegistration class finds the translation and the rotation
+//!        of a moving series which align it on a fixed series.
+//!
+//! The series are placed like in the viewers: a series is rotated around the
+//! middle of its bounds, by the angles of its ViewConfiguration (around Y,
+//! then X, then Z), and then translated.
+//!
+//! The similarity of the series is their normalized mutual information, which
+//! does not depend on the modalities and does not favour small overlaps. It
+//! is computed from the joint histogram of a regular subset of the voxels of
+//! the fixed series and of the moving values interpolated at their place. The
+//! samples are shared among the threads of a pool.
+//!
+//! The search goes from coarse to fine on a pyramid of downsampled series.
+//! On each level, the six parameters are moved by steps as long as the
+//! similarity improves, then the steps are halved.
+//!
+class RigidRegistration
+{
+    public:
+        //!
+        //! \brief The RigidRegistration constructor.
+        //!
+        RigidRegistration();
+
+        //!
+        //! \brief The RigidRegistration destructor.
+        //!
+        ~RigidRegistration();
+
+        //!
+        //! \brief The setFixed method defines the fixed series and its place.
+        //!
+        //! \param series The fixed series.
+        //! \param translation The translation of the fixed series (in mm).
+        //! \param rotation The rotation of the fixed series (in degrees).
+        //!
+        //! \return Nothing.
+        //!
+        void setFixed(vtkImageData* series, Vector3D const& translation,
+                      Vector3D const& rotation);
+
+        //!
+        //! \brief The setMoving method defines the moving series.
+        //!
+        //! \param series The moving series.
+        //!
+        //! \return Nothing.
+        //!
+        void setMoving(vtkImageData* series);
+
+        //!
+        //! \brief The run method searches the place of the moving series which
+        //!        aligns it on the fixed series.
+        //!
+        //! \param translation The translation of the moving series (in mm),
+        //!                    where the search starts and which receives the
+        //!                    result.
+        //! \param rotation The rotation of the moving series (in degrees),
+        //!                 where the search starts and which receives the
+        //!                 result.
+        //!
+        //! \return The similarity of the series at the found place.
+        //!
+        double run(Vector3D& translation, Vector3D& rotation);
+
+        //!
+        //! \brief The accumulateSamples method adds some samples of the fixed
+        //!        series to a joint histogram.
+        //!
+        //! The method is called by the tasks of the pool, during a computation
+        //! of the similarity, and can be called by several threads at the same
+        //! time. The samples outside the moving series are not counted.
+        //!
+        //! \param firstSample The first sample.
+        //! \param endSample The sample after the last one.
+        //! \param transform The transform from the scene to the voxel indexes
+        //!                  of the moving series (3 rows of 4 values).
+        //! \param histogram The joint histogram (the fixed bins are the rows).
+        //!
+        //! \return Nothing.
+        //!
+        void accumulateSamples(int firstSample, int endSample, double const transform[12],
+                               int* histogram) const;
+
+    private:
+        //!
+        //! \brief The Volume struct holds a downsampled series.
+        //!
+        struct Volume
+        {
+            std::vector<float> values;
+            int dims[3];
+            double origin[3], spacing[3];
+            float low, high; // The range of the values
+        };
+
+        //!
+        //! \brief The downsample method averages blocks of voxels of a series,
+        //!        so that its voxels are about as large as a given size.
+        //!
+        //! \param series The downsampled series.
+        //! \param size The size of the voxels (in mm).
+        //! \param volume The volume which receives the result.
+        //!
+        //! \return Nothing.
+        //!
+        static void downsample(vtkImageData* series, double size, Volume& volume);
+
+        //!
+        //! \brief The rotationMatrix method computes the rotation of the
+        //!        viewers for some angles.
+        //!
+        //! \param rotation The angles (in degrees).
+        //! \param matrix The rotation (3 rows of 3 values).
+        //!
+        //! \return Nothing.
+        //!
+        static void rotationMatrix(Vector3D const& rotation, double matrix[9]);
+
+        //!
+        //! \brief The prepareLevel method downsamples the series for a level of
+        //!        the pyramid, and places the samples of the fixed series.
+        //!
+        //! \param size The size of the voxels of the level (in mm).
+        //!
+        //! \return Nothing.
+        //!
+        void prepareLevel(double size);
+
+        //!
+        //! \brief The similarity method computes the normalized mutual
+        //!        information of the series, with all the threads of the pool.
+        //!
+        //! \param parameters The translation (in mm) and the rotation (in
+        //!                   degrees) of the moving series.
+        //!
+        //! \return The similarity, between 1 and 2, or 0 if the series hardly
+        //!         overlap.
+        //!
+        double similarity(double const parameters[6]);
+
+        static int const s_binCount = 32;          // The bins of each series
+        static int const s_maxSamples = 262144;    // The samples of a level
+        static int const s_samplesPerTask = 4096;  // The samples of a task
+        static int const s_maxIterations = 100;    // The moves on a level
+
+        // The series and the place of the fixed one
+        vtkImageData* m_fixedSeries;
+        vtkImageData* m_movingSeries;
+        Vector3D m_fixedTranslation, m_fixedRotation;
+        double m_movingCenter[3]; // The center of the rotation
+
+        // The current level: the samples of the fixed series in the scene
+        // with their bins, and the downsampled moving series
+        std::vector<double> m_samplePoints;
+        std::vector<unsigned char> m_sampleBins;
+        Volume m_moving;
+        double m_movingScale; // The bins per unit of the moving values
+
+        QThreadPool m_pool; // The threads of the similarity
+};
+
+#endif
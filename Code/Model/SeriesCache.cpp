@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesCache.cpp
+//! \brief The SeriesCache.cpp file contains the definition of non-inline
+//!        methods of the SeriesCache class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SeriesCache.h"
+using namespace std;
+
+// The 'isEnabled' static method
+bool SeriesCache::isEnabled()
+{
+    return !ProgramConfiguration::instance()->cacheDirectory().empty();
+}
+
+// The 'filePath' private static method
+QString SeriesCache::filePath(QString const& seriesId)
+{
+    QDir dir(ProgramConfiguration::instance()->cacheDirectory().c_str());
+    return dir.filePath(seriesId + ".cache");
+}
+
+// The 'load' static method
+SeriesData* SeriesCache::load(QString const& seriesId, QString const& stamp)
+{
+    if(!isEnabled() || stamp.isEmpty())
+        return 0;
+
+    QFile file(filePath(seriesId));
+    if(!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    // Read the header
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic;
+    QString fileStamp;
+    in >> magic >> fileStamp;
+    if(magic != s_magic || fileStamp != stamp)
+        return 0;
+
+    qint32 scalarType, dims[3];
+    double spacing[3], origin[3];
+    QByteArray patientName, studyDesc, seriesDesc, modality;
+    double intercept, slope;
+    quint32 windowCount;
+    in >> scalarType >> dims[0] >> dims[1] >> dims[2];
+    in >> spacing[0] >> spacing[1] >> spacing[2] >> origin[0] >> origin[1] >> origin[2];
+    in >> patientName >> studyDesc >> seriesDesc >> modality >> intercept >> slope;
+    in >> windowCount;
+
+    vtkSmartPointer<SeriesData> series;
+    series.TakeReference(new SeriesData());
+    series->setPatientName(string(patientName.constData(), patientName.size()));
+    series->setStudyDescription(string(studyDesc.constData(), studyDesc.size()));
+    series->setSeriesDescription(string(seriesDesc.constData(), seriesDesc.size()));
+    series->setModality(string(modality.constData(), modality.size()));
+    series->setRescaleInterceptAndSlope(intercept, slope);
+    for(quint32 i = 0 ; i < windowCount && in.status() == QDataStream::Ok ; i++)
+    {
+        double center, width;
+        in >> center >> width;
+        series->addBasicWindow(center, width);
+    }
+
+    quint64 voxelOffset, voxelSize;
+    in >> voxelOffset >> voxelSize;
+
+    // Check the voxel buffer before mapping it
+    vtkDataArray* scalars = vtkDataArray::CreateDataArray(scalarType);
+    vtkIdType voxelCount = static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2];
+    if(in.status() != QDataStream::Ok || scalars == 0 || voxelCount <= 0
+       || voxelSize != static_cast<quint64>(voxelCount * scalars->GetDataTypeSize())
+       || static_cast<quint64>(file.size()) < voxelOffset + voxelSize)
+    {
+        cerr << "Invalid cache file for series " << seriesId.toStdString() << endl;
+        if(scalars != 0)
+            scalars->Delete();
+        return 0;
+    }
+
+    // The mapping is private: the pages are read from the file when they are
+    // first accessed, and copied if they are modified, so the series can be
+    // changed like a downloaded one while the cache file stays untouched
+    quint64 pageSize = sysconf(_SC_PAGESIZE);
+    quint64 mappingOffset = (voxelOffset / pageSize) * pageSize;
+    size_t mappingSize = voxelOffset - mappingOffset + voxelSize;
+    void* mapping = mmap(0, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                         file.handle(), mappingOffset);
+    if(mapping == MAP_FAILED)
+    {
+        scalars->Delete();
+        return 0;
+    }
+
+    // The mapping is used as the scalars of the series, without any copy
+    char* voxels = static_cast<char*>(mapping) + (voxelOffset - mappingOffset);
+    scalars->SetVoidArray(voxels, voxelCount, 1);
+    series->SetDimensions(dims[0], dims[1], dims[2]);
+    series->SetSpacing(spacing);
+    series->SetOrigin(origin);
+    series->SetScalarType(scalarType);
+    series->GetPointData()->SetScalars(scalars);
+    scalars->Delete();
+    series->setMapping(mapping, mappingSize);
+
+    // The file becomes the most recently used one
+    utime(file.fileName().toLocal8Bit().constData(), 0);
+
+    series->Register(0);
+    return series.GetPointer();
+}
+
+// The 'store' static method
+bool SeriesCache::store(QString const& seriesId, QString const& stamp, SeriesData* series)
+{
+    if(!isEnabled() || stamp.isEmpty())
+        return false;
+
+    QDir().mkpath(ProgramConfiguration::instance()->cacheDirectory().c_str());
+
+    // The file is written aside and renamed once complete
+    QString path = filePath(seriesId);
+    QFile file(path + ".tmp");
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    int* dims = series->GetDimensions();
+    double* spacing = series->GetSpacing();
+    double* origin = series->GetOrigin();
+    vtkDataArray* scalars = series->GetPointData()->GetScalars();
+    quint64 voxelSize = static_cast<quint64>(scalars->GetNumberOfTuples())
+            * scalars->GetDataTypeSize();
+
+    // Write the header
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_4_6);
+
+    out << s_magic << stamp;
+    out << static_cast<qint32>(series->GetScalarType());
+    out << static_cast<qint32>(dims[0]) << static_cast<qint32>(dims[1])
+        << static_cast<qint32>(dims[2]);
+    out << spacing[0] << spacing[1] << spacing[2] << origin[0] << origin[1] << origin[2];
+    out << QByteArray(series->patientName().c_str(), series->patientName().size())
+        << QByteArray(series->studyDescription().c_str(), series->studyDescription().size())
+        << QByteArray(series->seriesDescription().c_str(), series->seriesDescription().size())
+        << QByteArray(series->modality().c_str(), series->modality().size());
+    out << series->rescaleIntercept() << series->rescaleSlope();
+
+    vector<double> const& centers = series->basicWindowCenters();
+    vector<double> const& widths = series->basicWindowWidths();
+    out << static_cast<quint32>(centers.size());
+    for(unsigned int i = 0 ; i < centers.size() ; i++)
+        out << centers.at(i) << widths.at(i);
+
+    // Write the voxels on an aligned offset
+    qint64 headerEnd = file.pos() + 2 * sizeof(quint64);
+    quint64 voxelOffset = ((headerEnd + s_alignment - 1) / s_alignment) * s_alignment;
+    out << voxelOffset << voxelSize;
+
+    bool written = file.seek(voxelOffset)
+            && file.write(static_cast<char const*>(scalars->GetVoidPointer(0)), voxelSize)
+               == static_cast<qint64>(voxelSize);
+    file.close();
+
+    if(!written || out.status() != QDataStream::Ok)
+    {
+        file.remove();
+        return false;
+    }
+
+    QFile::remove(path);
+    if(!file.rename(path))
+        return false;
+
+    prune(path);
+    return true;
+}
+
+// The 'prune' private static method
+void SeriesCache::prune(QString const& keptPath)
+{
+    qint64 maxSize = static_cast<qint64>(ProgramConfiguration::instance()->cacheSize()) << 20;
+    if(maxSize == 0)
+        return;
+
+    // The files are listed from the least recently used one
+    QDir dir(ProgramConfiguration::instance()->cacheDirectory().c_str());
+    QFileInfoList files = dir.entryInfoList(QStringList("*.cache"), QDir::Files,
+                                            QDir::Time | QDir::Reversed);
+
+    qint64 size = 0;
+    for(int i = 0 ; i < files.size() ; i++)
+        size += files.at(i).size();
+
+    for(int i = 0 ; i < files.size() && size > maxSize ; i++)
+    {
+        if(files.at(i).absoluteFilePath() == QFileInfo(keptPath).absoluteFilePath())
+            continue;
+
+        // A series still opened keeps its mapping after the removal
+        if(QFile::remove(files.at(i).absoluteFilePath()))
+            size -= files.at(i).size();
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesCache.h
+//! \brief The SeriesCache.h file contains the interface of the SeriesCache
+//!        class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SERIESCACHE_H
+#define SERIESCACHE_H
+
+#include <iostream>
+#include <string>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <vtkSmartPointer.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+
+#include "Model/ProgramConfiguration.h"
+#include "Model/SeriesData.h"
+
+//!
+//! \brief The SeriesCache class stores the loaded series on the disk, so that
+//!        they can be reopened without being downloaded again.
+//!
+//! Each series is stored in a flat file named after its Orthanc id, in the
+//! cache directory given by the program configuration. The file starts with
+//! the series information and is followed by the final voxel buffer, which is
+//! memory mapped (copy-on-write) when the series is reopened.
+//!
+//! A cached series is only used if the modification stamp it was stored with
+//! is equal to the current one.
+//!
+//! The size of the cache directory is bounded by the program configuration:
+//! when a series is stored, the least recently used files are removed until
+//! the cache fits again. The modification time of a file is updated each time
+//! it is reopened, so that it tells when the series was used last.
+//!
+class SeriesCache
+{
+    public:
+        //!
+        //! \brief The isEnabled static method indicates if a cache directory
+        //!        is configured.
+        //!
+        //! \return A boolean which is true if the cache can be used.
+        //!
+        static bool isEnabled();
+
+        //!
+        //! \brief The load static method reopens a cached series.
+        //!
+        //! The voxels of the returned series are memory mapped from the cache
+        //! file. The mapping is private: the modified voxels are copied in
+        //! memory and never written back to the file.
+        //!
+        //! \param seriesId The Orthanc id of the series.
+        //! \param stamp The current modification stamp of the series.
+        //!
+        //! \return A pointer to a new SeriesData object, or a null pointer if
+        //!         the series is not in the cache or if it is outdated.
+        //!
+        static SeriesData* load(QString const& seriesId, QString const& stamp);
+
+        //!
+        //! \brief The store static method writes a loaded series in the cache.
+        //!
+        //! \param seriesId The Orthanc id of the series.
+        //! \param stamp The modification stamp of the series.
+        //! \param series A pointer to the series data to store.
+        //!
+        //! \return A boolean which is true if the series has been stored.
+        //!
+        static bool store(QString const& seriesId, QString const& stamp, SeriesData* series);
+
+    private:
+        //!
+        //! \brief The filePath private static method returns the path of the
+        //!        cache file of a series.
+        //!
+        //! \param seriesId The Orthanc id of the series.
+        //!
+        //! \return A QString object which contains the file path.
+        //!
+        static QString filePath(QString const& seriesId);
+
+        //!
+        //! \brief The prune private static method removes the least recently
+        //!        used files until the cache fits in its maximum size.
+        //!
+        //! \param keptPath The path of a file which must not be removed (the
+        //!                 series just stored).
+        //!
+        //! \return Nothing.
+        //!
+        static void prune(QString const& keptPath);
+
+        static quint32 const s_magic = 0x4F564331; // File signature ("OVC1")
+        static qint64 const s_alignment = 4096;    // Alignment of the voxels
+};
+
+#endif
@@ -35,16 +35,61 @@
 #include "SeriesData.h"
 using namespace std;
 
+//!
+//! \brief The computeValueRange function computes the minimum and the maximum
+//!        of a buffer of voxels of type T.
+//!
+//! \param voxels A pointer to the first voxel.
+//! \param count The number of voxels.
+//! \param min The minimum value (filled).
+//! \param max The maximum value (filled).
+//!
+//! \return Nothing.
+//!
+template <class T>
+static void computeValueRange(T const* voxels, vtkIdType count, double& min, double& max)
+{
+    T low = voxels[0], high = voxels[0];
+    for(vtkIdType i = 1 ; i < count ; i++)
+    {
+        if(voxels[i] < low)
+            low = voxels[i];
+        else if(voxels[i] > high)
+            high = voxels[i];
+    }
+
+    min = low;
+    max = high;
+}
+
 // Constructor
 SeriesData::SeriesData() : vtkImageData(), m_patientName(""), m_studyDesc(""),
-    m_seriesDesc(""), m_modality("?")
+    m_seriesDesc(""), m_modality("?"), m_loading(false), m_loadedSliceCount(0), m_fillCount(0),
+    m_mapping(0), m_mappingSize(0)
 {
     setRescaleInterceptAndSlope(0, 1);
 }
 
 // Destructor
 SeriesData::~SeriesData()
-{}
+{
+    if(m_mapping != 0)
+    {
+        // The scalars must not point to the mapping anymore
+        GetPointData()->SetScalars(0);
+        munmap(m_mapping, m_mappingSize);
+    }
+}
+
+// The 'setMapping' method
+void SeriesData::setMapping(void* mapping, size_t size)
+{
+    if(m_mapping != 0)
+        munmap(m_mapping, m_mappingSize);
+
+    m_mapping = mapping;
+    m_mappingSize = size;
+}
 
 // The 'setRescaleInterceptAndSlope' method
 void SeriesData::setRescaleInterceptAndSlope(double intercept, double slope)
@@ -85,6 +130,118 @@ void SeriesData::addBasicWindow(double center, double width)
     m_basicWindowWidths.push_back(width);
 }
 
+// The 'addSliceBasicWindow' method
+void SeriesData::addSliceBasicWindow(int slice)
+{
+    // The z-plane is read in the native type of the series
+    int* dims = GetDimensions();
+    double min = 0, max = 0;
+    switch(GetScalarType())
+    {
+        vtkTemplateMacro(computeValueRange(static_cast<VTK_TT const*>(GetScalarPointer(0, 0, slice)),
+                                           static_cast<vtkIdType>(dims[0]) * dims[1], min, max));
+    }
+
+    addBasicWindow(convertToHU((max+min)/2), convertToHU(max-min, true));
+}
+
+// The 'startLoading' method
+void SeriesData::startLoading()
+{
+    QMutexLocker locker(&m_loadingMutex);
+    m_loading = true;
+    m_loadedSlices.assign(GetDimensions()[2], false);
+    m_loadedSliceCount = 0;
+}
+
+// The 'markSliceLoaded' method
+void SeriesData::markSliceLoaded(int slice)
+{
+    QMutexLocker locker(&m_loadingMutex);
+    if(slice < 0 || slice >= static_cast<int>(m_loadedSlices.size()) || m_loadedSlices.at(slice))
+        return;
+
+    m_loadedSlices.at(slice) = true;
+    m_loadedSliceCount++;
+}
+
+// The 'finishLoading' method
+void SeriesData::finishLoading()
+{
+    QMutexLocker locker(&m_loadingMutex);
+    m_loading = false;
+}
+
+// The 'isLoading' method
+bool SeriesData::isLoading() const
+{
+    QMutexLocker locker(&m_loadingMutex);
+    return m_loading;
+}
+
+// The 'isSliceLoaded' method
+bool SeriesData::isSliceLoaded(int slice) const
+{
+    QMutexLocker locker(&m_loadingMutex);
+    if(m_loadedSlices.empty())
+        return true; // The series was loaded at once
+
+    return slice >= 0 && slice < static_cast<int>(m_loadedSlices.size())
+            && m_loadedSlices.at(slice);
+}
+
+// The 'loadedSliceCount' method
+int SeriesData::loadedSliceCount() const
+{
+    QMutexLocker locker(&m_loadingMutex);
+    if(m_loadedSlices.empty())
+        return const_cast<SeriesData*>(this)->GetDimensions()[2];
+
+    return m_loadedSliceCount;
+}
+
+// The 'fillMissingSlices' method
+void SeriesData::fillMissingSlices()
+{
+    QMutexLocker locker(&m_loadingMutex);
+    if(m_loadedSliceCount == 0)
+        return;
+
+    int* dims = GetDimensions();
+    size_t planeSize = static_cast<size_t>(dims[0]) * dims[1] * GetScalarSize();
+    char* voxels = static_cast<char*>(GetScalarPointer(0, 0, 0));
+
+    // Each missing plane takes the nearest loaded one (the lower one on ties)
+    int count = static_cast<int>(m_loadedSlices.size());
+    int previous = -1;
+    for(int z = 0 ; z < count ; z++)
+    {
+        if(m_loadedSlices.at(z))
+        {
+            previous = z;
+            continue;
+        }
+
+        int next = z + 1;
+        while(next < count && !m_loadedSlices.at(next))
+            next++;
+
+        int source = previous;
+        if(source < 0 || (next < count && next - z < z - previous))
+            source = next;
+        memcpy(voxels + z * planeSize, voxels + source * planeSize, planeSize);
+    }
+
+    m_fillCount++;
+}
+
+// The 'fillCount' method
+int SeriesData::fillCount() const
+{
+    QMutexLocker locker(&m_loadingMutex);
+    return m_fillCount;
+}
+
 // The 'convertToHU' method
 double SeriesData::convertToHU(double value, bool isSize) const
 {
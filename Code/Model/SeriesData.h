@@ -37,8 +37,14 @@
 
 #include <vector>
 #include <string>
+#include <cstring>
+
+#include <QMutex>
+
+#include <sys/mman.h>
 
 #include <vtkImageData.h>
+#include <vtkPointData.h>
 
 #include "Range.h"
 
@@ -46,7 +52,10 @@
 //! \brief The SeriesData class acts as a vtkImageData on which some information
 //!        can be added or computed.
 //!
-//! This is an extension of the vtkImageData for a DICOM series.
+//! This is an extension of the vtkImageData for a DICOM series. The voxels
+//! keep the type in which the series is stored (unsigned char, short or
+//! unsigned short), the hounsfield values are given by the rescale
+//! intercept and slope.
 //!
 class SeriesData : public vtkImageData
 {
@@ -165,6 +174,60 @@ class SeriesData : public vtkImageData
         //!
         void setRescaleInterceptAndSlope(double intercept, double slope);
 
+        //!
+        //! \brief The rescaleIntercept method returns the rescale intercept
+        //!        of the series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The rescale intercept.
+        //!
+        inline double rescaleIntercept() const;
+
+        //!
+        //! \brief The rescaleSlope method returns the rescale slope of the
+        //!        series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The rescale slope.
+        //!
+        inline double rescaleSlope() const;
+
+        //!
+        //! \brief The basicWindowCenters method returns the centers (in
+        //!        hounsfield units) of the windows added to the series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A reference to read the window centers.
+        //!
+        inline std::vector<double> const& basicWindowCenters() const;
+
+        //!
+        //! \brief The basicWindowWidths method returns the widths (in
+        //!        hounsfield units) of the windows added to the series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A reference to read the window widths.
+        //!
+        inline std::vector<double> const& basicWindowWidths() const;
+
+        //!
+        //! \brief The setMapping method gives to the series the memory mapping
+        //!        which holds its voxels.
+        //!
+        //! The series takes the ownership of the mapping, which is unmapped
+        //! when the series is destroyed.
+        //!
+        //! \param mapping The start of the mapping.
+        //! \param size The size of the mapping (in bytes).
+        //!
+        //! \return Nothing.
+        //!
+        void setMapping(void* mapping, size_t size);
+
         //!
         //! \brief The addBasicWindow method checks the scalar range of the 3D
         //!        image and adds a hounsfield window that covers it.
@@ -184,6 +247,100 @@ class SeriesData : public vtkImageData
         //!
         void addBasicWindow(double center, double width);
 
+        //!
+        //! \brief The addSliceBasicWindow method checks the scalar range of a
+        //!        single slice of the 3D image and adds a hounsfield window
+        //!        that covers it.
+        //!
+        //! It is used when the series is displayed before all its slices
+        //! have been loaded.
+        //!
+        //! \param slice The index of the z-plane to check.
+        //!
+        //! \return Nothing.
+        //!
+        void addSliceBasicWindow(int slice);
+
+        //!
+        //! \brief The startLoading method indicates that the slices of the
+        //!        series are going to be loaded while it is already displayed.
+        //!
+        //! All the slices are marked as missing until markSliceLoaded is
+        //! called for them.
+        //!
+        //! \return Nothing.
+        //!
+        void startLoading();
+
+        //!
+        //! \brief The markSliceLoaded method indicates that a slice of the
+        //!        series has been written in the image.
+        //!
+        //! The method is thread-safe.
+        //!
+        //! \param slice The index of the loaded z-plane.
+        //!
+        //! \return Nothing.
+        //!
+        void markSliceLoaded(int slice);
+
+        //!
+        //! \brief The finishLoading method indicates that no other slice will
+        //!        be loaded for the series.
+        //!
+        //! The slices which were never loaded are still reported as missing.
+        //!
+        //! \return Nothing.
+        //!
+        void finishLoading();
+
+        //!
+        //! \brief The isLoading method indicates if slices of the series are
+        //!        still being loaded.
+        //!
+        //! \return A boolean which is true if the loading is in progress.
+        //!
+        bool isLoading() const;
+
+        //!
+        //! \brief The isSliceLoaded method indicates if a slice of the series
+        //!        is available.
+        //!
+        //! \param slice The index of the z-plane to check.
+        //!
+        //! \return A boolean which is true if the slice has been loaded.
+        //!
+        bool isSliceLoaded(int slice) const;
+
+        //!
+        //! \brief The loadedSliceCount method returns the number of slices
+        //!        of the series which are available.
+        //!
+        //! \return The number of loaded slices.
+        //!
+        int loadedSliceCount() const;
+
+        //!
+        //! \brief The fillMissingSlices method copies, in each missing
+        //!        z-plane, the nearest loaded z-plane.
+        //!
+        //! It gives a coarse but complete view of the series while its slices
+        //! are loaded. The filled planes are still reported as missing and
+        //! are overwritten once loaded. No slice must be written during the
+        //! call.
+        //!
+        //! \return Nothing.
+        //!
+        void fillMissingSlices();
+
+        //!
+        //! \brief The fillCount method returns the number of times the
+        //!        missing slices have been filled.
+        //!
+        //! \return The number of calls of fillMissingSlices.
+        //!
+        int fillCount() const;
+
         //!
         //! \brief The convertToHU method converts an internal series value in
         //!        hounsfield value by using the stored intercept and slope
@@ -254,6 +411,16 @@ class SeriesData : public vtkImageData
         std::string m_patientName, m_studyDesc, m_seriesDesc, m_modality;
         double m_rescaleIntercept, m_rescaleSlope;
         std::vector<double> m_basicWindowCenters, m_basicWindowWidths;
+
+        // Progressive loading state (shared with the loading threads)
+        mutable QMutex m_loadingMutex;
+        bool m_loading;
+        std::vector<bool> m_loadedSlices;
+        int m_loadedSliceCount;
+        int m_fillCount;
+
+        void* m_mapping;     // The mapping which holds the voxels, if any
+        size_t m_mappingSize;
 };
 
 // The 'patientName' method
@@ -263,6 +430,20 @@ inline std::string SeriesData::patientName() const { return m_patientName; }
 inline void SeriesData::setPatientName(std::string const& patientName)
 { m_patientName = patientName; }
 
+// The 'rescaleIntercept' method
+inline double SeriesData::rescaleIntercept() const { return m_rescaleIntercept; }
+
+// The 'rescaleSlope' method
+inline double SeriesData::rescaleSlope() const { return m_rescaleSlope; }
+
+// The 'basicWindowCenters' method
+inline std::vector<double> const& SeriesData::basicWindowCenters() const
+{ return m_basicWindowCenters; }
+
+// The 'basicWindowWidths' method
+inline std::vector<double> const& SeriesData::basicWindowWidths() const
+{ return m_basicWindowWidths; }
+
 // The 'studyDescription' method
 inline std::string SeriesData::studyDescription() const { return m_studyDesc; }
 
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesRegridder.cpp
+//! \brief The SeriesRegridder.cpp file contains the definition of non-inline
+//!        methods of the SeriesRegridder class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <algorithm>
+
+#include "SeriesRegridder.h"
+using namespace std;
+
+// Constructor
+SeriesRegridder::SeriesRegridder()
+    : m_axis(2), m_useCount(0), m_version(0), m_slab(vtkSmartPointer<vtkImageData>::New()),
+      m_moving(0), m_movingTime(0), m_resampler()
+{
+    for(int i = 0 ; i < 6 ; i++)
+        m_extent[i] = 0;
+    for(int i = 0 ; i < 3 ; i++)
+    {
+        m_spacing[i] = 1;
+        m_origin[i] = 0;
+    }
+    vtkMatrix4x4::Identity(m_transform);
+}
+
+// Destructor
+SeriesRegridder::~SeriesRegridder()
+{}
+
+// The 'setGrid' method
+void SeriesRegridder::setGrid(vtkImageData* reference, int axis)
+{
+    int* extent = reference->GetExtent();
+    double* spacing = reference->GetSpacing();
+    double* origin = reference->GetOrigin();
+    if(axis == m_axis && equal(extent, extent + 6, m_extent)
+       && equal(spacing, spacing + 3, m_spacing) && equal(origin, origin + 3, m_origin))
+        return;
+
+    copy(extent, extent + 6, m_extent);
+    copy(spacing, spacing + 3, m_spacing);
+    copy(origin, origin + 3, m_origin);
+    m_axis = axis;
+    clear();
+}
+
+// The 'setTransform' method
+void SeriesRegridder::setTransform(vtkMatrix4x4* referenceToMoving)
+{
+    double transform[16];
+    vtkMatrix4x4::DeepCopy(transform, referenceToMoving);
+    if(equal(transform, transform + 16, m_transform))
+        return;
+
+    copy(transform, transform + 16, m_transform);
+    clear();
+}
+
+// The 'regrid' method
+vtkImageData* SeriesRegridder::regrid(vtkImageData* moving, int first, int last)
+{
+    int* extent = m_extent;
+    int a = m_axis;                    // The axis of the planes
+    int p = (a == 0) ? 1 : 0;          // The axis of the rows
+    int q = (a == 2) ? 1 : 2;          // The axis of the columns
+
+    // The planes follow the scalar type of the moving series, and are dropped
+    // when the voxels of the moving series change
+    if(moving != m_moving || moving->GetMTime() != m_movingTime)
+        clear();
+    m_moving = moving;
+    m_movingTime = moving->GetMTime();
+
+    first = max(first, extent[2*a]);
+    last = min(last, extent[2*a+1]);
+
+    vtkSmartPointer<vtkMatrix4x4> transform = vtkSmartPointer<vtkMatrix4x4>::New();
+    transform->DeepCopy(m_transform);
+    int width = extent[2*p+1] - extent[2*p] + 1;
+    int height = extent[2*q+1] - extent[2*q] + 1;
+    int scalarSize = moving->GetScalarSize();
+
+    for(int k = first ; k <= last ; k++)
+    {
+        map<int, Plane>::iterator it = m_planes.find(k);
+        if(it != m_planes.end())
+        {
+            it->second.lastUse = ++m_useCount;
+            continue;
+        }
+
+        // The plane of the reference, in the physical coordinates of the
+        // moving series
+        int index[3];
+        index[a] = k;
+        index[p] = extent[2*p];
+        index[q] = extent[2*q];
+
+        double start[4], row[4] = { 0, 0, 0, 0 }, column[4] = { 0, 0, 0, 0 };
+        for(int i = 0 ; i < 3 ; i++)
+            start[i] = m_origin[i] + index[i] * m_spacing[i];
+        start[3] = 1;
+        row[p] = m_spacing[p];
+        column[q] = m_spacing[q];
+        transform->MultiplyPoint(start, start);
+        transform->MultiplyPoint(row, row);
+        transform->MultiplyPoint(column, column);
+
+        Plane& plane = m_planes[k];
+        plane.values.resize(static_cast<size_t>(width) * height * scalarSize);
+        plane.inside.resize(static_cast<size_t>(width) * height);
+        plane.lastUse = ++m_useCount;
+        m_resampler.setPlane(start, row, column);
+        m_resampler.resampleValues(moving, width, height, &plane.values[0], &plane.inside[0],
+                                   1, width);
+    }
+    dropUnusedPlanes(first, last);
+
+    // The slab only holds the asked planes
+    int slabExtent[6];
+    copy(extent, extent + 6, slabExtent);
+    slabExtent[2*a] = first;
+    slabExtent[2*a+1] = max(first, last);
+    m_slab->SetExtent(slabExtent);
+    m_slab->SetSpacing(m_spacing);
+    m_slab->SetOrigin(m_origin);
+    m_slab->SetScalarType(moving->GetScalarType());
+    m_slab->SetNumberOfScalarComponents(1);
+    m_slab->AllocateScalars();
+
+    vtkIdType* increments = m_slab->GetIncrements();
+    for(int k = first ; k <= last ; k++)
+    {
+        char const* in = &m_planes[k].values[0];
+        char* out = static_cast<char*>(m_slab->GetScalarPointer()) + (k - first) * increments[a] * scalarSize;
+        if(p == 0)
+        {
+            // The rows of the plane are contiguous in the slab
+            for(int j = 0 ; j < height ; j++)
+                memcpy(out + j * increments[q] * scalarSize, in + j * width * scalarSize,
+                       width * scalarSize);
+        }
+        else
+        {
+            for(int j = 0 ; j < height ; j++)
+                for(int i = 0 ; i < width ; i++)
+                    memcpy(out + (i * increments[p] + j * increments[q]) * scalarSize,
+                           in + (j * width + i) * scalarSize, scalarSize);
+        }
+    }
+
+    m_slab->Modified();
+    return m_slab;
+}
+
+// The 'maskOutside' method
+void SeriesRegridder::maskOutside(int first, int last, unsigned char* out) const
+{
+    int const* extent = m_extent;
+    int a = m_axis;
+    int p = (a == 0) ? 1 : 0;
+    int q = (a == 2) ? 1 : 2;
+
+    // Only the kept planes of the slab cover pixels
+    vector<unsigned char const*> planes;
+    for(int k = max(first, extent[2*a]) ; k <= min(last, extent[2*a+1]) ; k++)
+    {
+        map<int, Plane>::const_iterator it = m_planes.find(k);
+        if(it != m_planes.end())
+            planes.push_back(&it->second.inside[0]);
+    }
+    if(planes.empty())
+        return;
+
+    long size = static_cast<long>(extent[2*p+1] - extent[2*p] + 1) * (extent[2*q+1] - extent[2*q] + 1);
+    for(long i = 0 ; i < size ; i++)
+    {
+        bool covered = false;
+        for(unsigned int k = 0 ; k < planes.size() && !covered ; k++)
+            covered = planes[k][i] != 0;
+
+        if(!covered)
+            out[4*i + 3] = 0;
+    }
+}
+
+// The 'clear' private method
+void SeriesRegridder::clear()
+{
+    m_planes.clear();
+    m_version++;
+}
+
+// The 'dropUnusedPlanes' private method
+void SeriesRegridder::dropUnusedPlanes(int first, int last)
+{
+    while(m_planes.size() > s_maxPlanes)
+    {
+        map<int, Plane>::iterator oldest = m_planes.end();
+        for(map<int, Plane>::iterator it = m_planes.begin() ; it != m_planes.end() ; ++it)
+            if((it->first < first || it->first > last)
+               && (oldest == m_planes.end() || it->second.lastUse < oldest->second.lastUse))
+                oldest = it;
+
+        // The planes of the slab are all kept
+        if(oldest == m_planes.end())
+            return;
+        m_planes.erase(oldest);
+    }
+}
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesRegridder.h
+//! \brief The SeriesRegridder.h file contains the interface of the
+//!        SeriesRegridder class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SERIESREGRIDDER_H
+#define SERIESREGRIDDER_H
+
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include "PlaneResampler.h"
+
+//!
+//! \brief The SeriesRegridder class resamples a moving series on the grid of
+//!        a reference series, under the rigid transform between them.
+//!
+//! The resampled series has the geometry of the reference and the scalar type
+//! of the moving series. Its planes along the axis of the regridder are only
+//! resampled when they are asked, and the last used ones are kept until the
+//! transform, the reference grid or the voxels of the moving series change,
+//! so that a slice or a slab is cheap to show again, and that a change of the
+//! colormap does not resample anything. The pixels of a plane are shared
+//! among the threads of a PlaneResampler.
+//!
+//! The whole grid of the reference is never allocated: at most s_maxPlanes
+//! planes are kept (or the planes of the current slab if it is thicker), and
+//! the regrid method only returns the planes of the asked slab.
+//!
+class SeriesRegridder
+{
+    public:
+        //!
+        //! \brief The SeriesRegridder constructor.
+        //!
+        SeriesRegridder();
+
+        //!
+        //! \brief The SeriesRegridder destructor.
+        //!
+        ~SeriesRegridder();
+
+        //!
+        //! \brief The setGrid method defines the grid of the resampled series
+        //!        and the axis of its planes.
+        //!
+        //! The resampled planes are only dropped if the grid or the axis
+        //! changed.
+        //!
+        //! \param reference The series which gives the grid.
+        //! \param axis The axis along which the planes are resampled.
+        //!
+        //! \return Nothing.
+        //!
+        void setGrid(vtkImageData* reference, int axis);
+
+        //!
+        //! \brief The setTransform method defines the rigid transform from the
+        //!        physical coordinates of the reference series to the ones of
+        //!        the moving series.
+        //!
+        //! The resampled planes are only dropped if the transform changed.
+        //!
+        //! \param referenceToMoving The transform.
+        //!
+        //! \return Nothing.
+        //!
+        void setTransform(vtkMatrix4x4* referenceToMoving);
+
+        //!
+        //! \brief The regrid method resamples the planes of a slab which are
+        //!        not resampled yet.
+        //!
+        //! The planes are clamped to the grid, and all of them are dropped
+        //! first if the voxels of the moving series changed. The least
+        //! recently used planes are dropped when more than s_maxPlanes are
+        //! kept.
+        //!
+        //! \param moving The moving series.
+        //! \param first The index of the first plane of the slab.
+        //! \param last The index of the last plane of the slab.
+        //!
+        //! \return The resampled slab, with the grid of the reference and only
+        //!         the asked planes along the axis of the regridder.
+        //!
+        vtkImageData* regrid(vtkImageData* moving, int first, int last);
+
+        //!
+        //! \brief The maskOutside method makes transparent the pixels of a
+        //!        colored plane of the resampled series which are outside the
+        //!        moving series in every plane of a slab.
+        //!
+        //! \param first The index of the first plane of the slab.
+        //! \param last The index of the last plane of the slab.
+        //! \param out The colored plane (4 bytes per pixel).
+        //!
+        //! \return Nothing.
+        //!
+        void maskOutside(int first, int last, unsigned char* out) const;
+
+        //!
+        //! \brief The version method returns a number which changes each time
+        //!        the resampled planes are dropped.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The version of the resampled series.
+        //!
+        inline unsigned int version() const;
+
+    private:
+        //!
+        //! \brief The clear method drops all the resampled planes.
+        //!
+        //! \return Nothing.
+        //!
+        void clear();
+
+        //!
+        //! \brief The dropUnusedPlanes method drops the least recently used
+        //!        planes which are outside a slab, until at most s_maxPlanes
+        //!        planes are kept.
+        //!
+        //! \param first The index of the first plane of the slab.
+        //! \param last The index of the last plane of the slab.
+        //!
+        //! \return Nothing.
+        //!
+        void dropUnusedPlanes(int first, int last);
+
+        //!
+        //! \brief The Plane struct holds a resampled plane.
+        //!
+        struct Plane
+        {
+            std::vector<char> values;          // In the scalar type of the moving series
+            std::vector<unsigned char> inside; // The pixels inside the moving series
+            unsigned long lastUse;
+        };
+
+        static unsigned int const s_maxPlanes = 32; // The kept planes
+
+        // The grid of the reference
+        int m_extent[6];
+        double m_spacing[3], m_origin[3];
+        int m_axis;
+
+        // The resampled planes, by index along the axis
+        std::map<int, Plane> m_planes;
+        unsigned long m_useCount;
+        unsigned int m_version;
+
+        vtkSmartPointer<vtkImageData> m_slab; // The planes of the last regrid
+
+        // The state of the planes
+        double m_transform[16];
+        vtkImageData* m_moving;
+        unsigned long m_movingTime; // The modification time of the voxels
+
+        PlaneResampler m_resampler;
+};
+
+inline unsigned int SeriesRegridder::version() const
+{ return m_version; }
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlabReduceTask.cpp
+//! \brief The SlabReduceTask.cpp file contains the definition of non-inline
+//!        methods of the SlabReduceTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SlabReduceTask.h"
+#include "SlabReducer.h"
+using namespace std;
+
+// Constructor
+SlabReduceTask::SlabReduceTask(SlabReducer& reducer, int firstRow, int endRow,
+                               WindowLevelKernel const& kernel, unsigned char* out,
+                               QSemaphore& done)
+    : QRunnable(), m_reducer(reducer), m_firstRow(firstRow), m_endRow(endRow),
+      m_kernel(kernel), m_out(out), m_done(done)
+{}
+
+// Destructor
+SlabReduceTask::~SlabReduceTask()
+{}
+
+// The 'run' method
+void SlabReduceTask::run()
+{
+    m_reducer.reduceRows(m_firstRow, m_endRow, m_kernel, m_out);
+    m_done.release();
+}
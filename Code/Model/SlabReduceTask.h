@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlabReduceTask.h
+//! \brief The SlabReduceTask.h file contains the interface of the
+//!        SlabReduceTask class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SLABREDUCETASK_H
+#define SLABREDUCETASK_H
+
+#include <iostream>
+
+#include <QRunnable>
+#include <QSemaphore>
+
+#include "WindowLevelKernel.h"
+
+class SlabReducer;
+
+//!
+//! \brief The SlabReduceTask class combines a band of rows of a slab for the
+//!        SlabReducer which launched it.
+//!
+class SlabReduceTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The SlabReduceTask constructor prepares the combination of
+        //!        some rows of the slab.
+        //!
+        //! \param reducer The reducer which defines the slab.
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer of the whole result.
+        //! \param done The semaphore released when the rows are computed.
+        //!
+        SlabReduceTask(SlabReducer& reducer, int firstRow, int endRow,
+                       WindowLevelKernel const& kernel, unsigned char* out,
+                       QSemaphore& done);
+
+        //!
+        //! \brief The SlabReduceTask destructor.
+        //!
+        ~SlabReduceTask();
+
+        //!
+        //! \brief The run method computes the rows.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        SlabReducer& m_reducer;
+        int m_firstRow, m_endRow;
+        WindowLevelKernel const& m_kernel;
+        unsigned char* m_out;
+        QSemaphore& m_done;
+};
+
+#endif
@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlabReducer.cpp
+//! \brief The SlabReducer.cpp file contains the definition of non-inline
+//!        methods of the SlabReducer class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <cmath>
+#include <limits>
+
+#include <QSemaphore>
+
+#include "SlabReducer.h"
+#include "SlabReduceTask.h"
+using namespace std;
+
+// The 'toVoxel' function converts a combined value to the voxel type
+template <class T>
+static inline T toVoxel(double value)
+{
+    if(numeric_limits<T>::is_integer)
+        return static_cast<T>(floor(value + 0.5));
+    return static_cast<T>(value);
+}
+
+// The 'addPlane' function adds the pixels of a plane to a row of the result
+template <class T>
+static void addPlane(T const* plane, vtkIdType step, int width, SlabMode mode,
+                     int index, double* values, int* planes)
+{
+    switch(mode)
+    {
+        case SLAB_MEAN:
+            for(int i = 0 ; i < width ; i++)
+                values[i] += plane[i * step];
+            break;
+
+        // On equal values, the last added plane is kept, so that it is not the
+        // first to leave the slab
+        case SLAB_MAXIMUM:
+            for(int i = 0 ; i < width ; i++)
+            {
+                double value = plane[i * step];
+                if(value >= values[i])
+                {
+                    values[i] = value;
+                    planes[i] = index;
+                }
+            }
+            break;
+
+        case SLAB_MINIMUM:
+            for(int i = 0 ; i < width ; i++)
+            {
+                double value = plane[i * step];
+                if(value <= values[i])
+                {
+                    values[i] = value;
+                    planes[i] = index;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// The 'removePlane' function removes the pixels of a plane from a row of sums
+template <class T>
+static void removePlane(T const* plane, vtkIdType step, int width, double* values)
+{
+    for(int i = 0 ; i < width ; i++)
+        values[i] -= plane[i * step];
+}
+
+// Constructor
+SlabReducer::SlabReducer()
+    : m_voxels(0), m_scalarType(VTK_VOID), m_axis(2), m_rowAxis(0), m_columnAxis(1),
+      m_width(0), m_height(0), m_mode(SLAB_NONE), m_first(0), m_last(-1),
+      m_newFirst(0), m_newLast(-1), m_valid(false), m_full(true), m_values(),
+      m_planes(), m_pool()
+{
+    for(int a = 0 ; a < 3 ; a++)
+        m_increments[a] = 0;
+}
+
+// Destructor
+SlabReducer::~SlabReducer()
+{
+    m_pool.waitForDone();
+}
+
+// The 'invalidate' method
+void SlabReducer::invalidate()
+{
+    m_valid = false;
+}
+
+// The 'reduce' method
+void SlabReducer::reduce(vtkImageData* series, int axis, SlabMode mode, int first, int last,
+                         WindowLevelKernel const& kernel, unsigned char* out)
+{
+    if(mode == SLAB_NONE)
+        return;
+
+    int dims[3];
+    series->GetDimensions(dims);
+    int* extent = series->GetExtent();
+    vtkIdType* increments = series->GetIncrements();
+    void* voxels = series->GetScalarPointer();
+    int scalarType = series->GetScalarType();
+    int rowAxis = (axis == 0) ? 1 : 0;
+    int columnAxis = (axis == 2) ? 1 : 2;
+
+    // The planes are counted from the start of the series
+    first -= extent[2*axis];
+    last -= extent[2*axis];
+    if(first < 0)
+        first = 0;
+    if(last > dims[axis] - 1)
+        last = dims[axis] - 1;
+    if(last < first)
+        return;
+
+    // The last slab is only reused if it overlaps the new one
+    bool reusable = m_valid && voxels == m_voxels && scalarType == m_scalarType
+                    && axis == m_axis && mode == m_mode
+                    && dims[rowAxis] == m_width && dims[columnAxis] == m_height
+                    && first <= m_last && last >= m_first;
+
+    m_voxels = voxels;
+    m_scalarType = scalarType;
+    m_axis = axis;
+    m_rowAxis = rowAxis;
+    m_columnAxis = columnAxis;
+    m_width = dims[rowAxis];
+    m_height = dims[columnAxis];
+    for(int a = 0 ; a < 3 ; a++)
+        m_increments[a] = increments[a];
+    m_mode = mode;
+    m_newFirst = first;
+    m_newLast = last;
+    m_full = !reusable;
+
+    if(m_full)
+    {
+        m_values.resize(m_width * m_height);
+        m_planes.resize(m_width * m_height);
+    }
+
+    // Share the rows among the threads and wait for all of them
+    QSemaphore done;
+    int taskCount = 0;
+    for(int row = 0 ; row < m_height ; row += s_rowsPerTask, taskCount++)
+    {
+        int end = (row + s_rowsPerTask < m_height) ? row + s_rowsPerTask : m_height;
+        m_pool.start(new SlabReduceTask(*this, row, end, kernel, out, done));
+    }
+    done.acquire(taskCount);
+
+    m_first = first;
+    m_last = last;
+    m_valid = true;
+}
+
+// The 'reduceRows' method
+void SlabReducer::reduceRows(int firstRow, int endRow, WindowLevelKernel const& kernel,
+                             unsigned char* out)
+{
+    switch(m_scalarType)
+    {
+        vtkTemplateMacro(reduceRowsOf<VTK_TT>(firstRow, endRow, kernel, out));
+    }
+}
+
+// The 'reduceRowsOf' private template method
+template <class T>
+void SlabReducer::reduceRowsOf(int firstRow, int endRow, WindowLevelKernel const& kernel,
+                               unsigned char* out)
+{
+    vtkIdType planeStep = m_increments[m_axis];
+    vtkIdType step = m_increments[m_rowAxis];
+    int count = m_newLast - m_newFirst + 1;
+    bool mean = (m_mode == SLAB_MEAN);
+
+    vector<T> row(m_width);
+    for(int j = firstRow ; j < endRow ; j++)
+    {
+        T const* voxels = static_cast<T const*>(m_voxels) + j * m_increments[m_columnAxis];
+        double* values = &m_values[j * m_width];
+        int* planes = &m_planes[j * m_width];
+
+        if(m_full)
+        {
+            // Start with the first plane (or nothing for the sum)
+            T const* plane = voxels + m_newFirst * planeStep;
+            for(int i = 0 ; i < m_width ; i++)
+            {
+                values[i] = mean ? 0 : plane[i * step];
+                planes[i] = m_newFirst;
+            }
+
+            for(int k = mean ? m_newFirst : m_newFirst + 1 ; k <= m_newLast ; k++)
+                addPlane(voxels + k * planeStep, step, m_width, m_mode, k, values, planes);
+        }
+        else
+        {
+            // Add the planes which enter the slab
+            for(int k = m_newFirst ; k <= m_newLast ; k++)
+                if(k < m_first || k > m_last)
+                    addPlane(voxels + k * planeStep, step, m_width, m_mode, k, values, planes);
+
+            if(mean)
+            {
+                // Remove the planes which leave the slab
+                for(int k = m_first ; k <= m_last ; k++)
+                    if(k < m_newFirst || k > m_newLast)
+                        removePlane(voxels + k * planeStep, step, m_width, values);
+            }
+            else
+            {
+                // Compute again the pixels whose plane left the slab
+                bool maximum = (m_mode == SLAB_MAXIMUM);
+                for(int i = 0 ; i < m_width ; i++)
+                {
+                    if(planes[i] >= m_newFirst && planes[i] <= m_newLast)
+                        continue;
+
+                    T const* pixel = voxels + i * step;
+                    values[i] = pixel[m_newFirst * planeStep];
+                    planes[i] = m_newFirst;
+                    for(int k = m_newFirst + 1 ; k <= m_newLast ; k++)
+                    {
+                        double value = pixel[k * planeStep];
+                        if(maximum ? value >= values[i] : value <= values[i])
+                        {
+                            values[i] = value;
+                            planes[i] = k;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Color the combined row
+        for(int i = 0 ; i < m_width ; i++)
+            row[i] = toVoxel<T>(mean ? values[i] / count : values[i]);
+        kernel.mapRow(&row[0], out + 4 * static_cast<long>(j) * m_width, m_width);
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlabReducer.h
+//! \brief The SlabReducer.h file contains the interface of the SlabReducer
+//!        class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SLABREDUCER_H
+#define SLABREDUCER_H
+
+#include <iostream>
+#include <vector>
+
+#include <QThreadPool>
+
+#include <vtkImageData.h>
+
+#include "WindowLevelKernel.h"
+
+//!
+//! \brief The SlabMode enum lists the ways the planes of a slab are combined.
+//!
+//! The values follow the choices offered by the slice interfaces.
+//!
+enum SlabMode
+{
+    SLAB_NONE, SLAB_MAXIMUM, SLAB_MINIMUM, SLAB_MEAN
+};
+
+//!
+//! \brief The SlabReducer class combines several adjacent planes of a series
+//!        into the maximum, the minimum or the mean along an axis, and colors
+//!        the result.
+//!
+//! The reducer keeps the combination of the last slab. When the slab slides,
+//! only the planes which enter and leave it are read: they are added to and
+//! removed from the sum for the mean, and for the maximum and the minimum the
+//! pixels are only computed again when the plane which gave their value
+//! leaves the slab.
+//!
+//! The rows of the result are shared among the threads of a pool, and each
+//! row reads the planes along the contiguous axis of the series.
+//!
+class SlabReducer
+{
+    public:
+        //!
+        //! \brief The SlabReducer constructor.
+        //!
+        SlabReducer();
+
+        //!
+        //! \brief The SlabReducer destructor.
+        //!
+        ~SlabReducer();
+
+        //!
+        //! \brief The invalidate method forgets the last slab, so that the next
+        //!        one is entirely computed.
+        //!
+        //! It must be called when the voxels of the series change.
+        //!
+        //! \return Nothing.
+        //!
+        void invalidate();
+
+        //!
+        //! \brief The reduce method combines the planes of a slab and colors
+        //!        the result with all the threads of the pool.
+        //!
+        //! The result covers the whole series on the two other axes. Its rows
+        //! follow the first of them and are stacked along the second one.
+        //!
+        //! \param series The reduced series.
+        //! \param axis The axis along which the planes are combined.
+        //! \param mode The combination (not SLAB_NONE).
+        //! \param first The index of the first plane of the slab.
+        //! \param last The index of the last plane of the slab.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer (4 bytes per pixel).
+        //!
+        //! \return Nothing.
+        //!
+        void reduce(vtkImageData* series, int axis, SlabMode mode, int first, int last,
+                    WindowLevelKernel const& kernel, unsigned char* out);
+
+        //!
+        //! \brief The reduceRows method combines and colors some rows of the
+        //!        result.
+        //!
+        //! The method is called by the tasks of the pool, during a call to the
+        //! reduce method, on distinct rows.
+        //!
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer of the whole result.
+        //!
+        //! \return Nothing.
+        //!
+        void reduceRows(int firstRow, int endRow, WindowLevelKernel const& kernel,
+                        unsigned char* out);
+
+    private:
+        //!
+        //! \brief The reduceRowsOf private method combines and colors some
+        //!        rows of the result.
+        //!
+        //! The method is a template on the voxel type of the series.
+        //!
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param kernel The kernel which colors the rows.
+        //! \param out The output buffer of the whole result.
+        //!
+        //! \return Nothing.
+        //!
+        template <class T>
+        void reduceRowsOf(int firstRow, int endRow, WindowLevelKernel const& kernel,
+                          unsigned char* out);
+
+        static int const s_rowsPerTask = 16; // The rows computed by a task
+
+        // The reduced series and the geometry of the result
+        void* m_voxels;
+        int m_scalarType;
+        int m_axis, m_rowAxis, m_columnAxis;
+        int m_width, m_height;
+        vtkIdType m_increments[3];
+
+        // The last slab and the one being computed
+        SlabMode m_mode;
+        int m_first, m_last;
+        int m_newFirst, m_newLast;
+        bool m_valid, m_full;
+
+        std::vector<double> m_values; // The maximum, minimum or sum of each pixel
+        std::vector<int> m_planes;    // The plane of the maximum or minimum
+
+        QThreadPool m_pool; // The reduction threads
+};
+
+#endif
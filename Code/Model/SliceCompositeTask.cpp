@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SliceCompositeTask.cpp
+//! \brief The SliceCompositeTask.cpp file contains the definition of
+//!        non-inline methods of the SliceCompositeTask class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SliceCompositeTask.h"
+#include "SliceCompositor.h"
+using namespace std;
+
+// Constructor
+SliceCompositeTask::SliceCompositeTask(SliceCompositor const& compositor,
+                                       int firstRow, int endRow, int width,
+                                       unsigned char* out, QSemaphore& done)
+    : QRunnable(), m_compositor(compositor), m_firstRow(firstRow),
+      m_endRow(endRow), m_width(width), m_out(out), m_done(done)
+{}
+
+// Destructor
+SliceCompositeTask::~SliceCompositeTask()
+{}
+
+// The 'run' method
+void SliceCompositeTask::run()
+{
+    m_compositor.compositeRows(m_firstRow, m_endRow, m_width, m_out);
+    m_done.release();
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SliceCompositeTask.h
+//! \brief The SliceCompositeTask.h file contains the interface of the
+//!        SliceCompositeTask class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SLICECOMPOSITETASK_H
+#define SLICECOMPOSITETASK_H
+
+#include <iostream>
+
+#include <QRunnable>
+#include <QSemaphore>
+
+class SliceCompositor;
+
+//!
+//! \brief The SliceCompositeTask class blends the layers of a SliceCompositor
+//!        on some rows of the output, in a thread of its pool.
+//!
+class SliceCompositeTask : public QRunnable
+{
+    public:
+        //!
+        //! \brief The SliceCompositeTask constructor.
+        //!
+        //! \param compositor The compositor which holds the layers.
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param width The number of pixels of an output row.
+        //! \param out The output buffer of the whole image.
+        //! \param done The semaphore released when the rows are computed.
+        //!
+        SliceCompositeTask(SliceCompositor const& compositor,
+                           int firstRow, int endRow, int width,
+                           unsigned char* out, QSemaphore& done);
+
+        //!
+        //! \brief The SliceCompositeTask destructor.
+        //!
+        ~SliceCompositeTask();
+
+        //!
+        //! \brief The run method computes the rows and releases the semaphore.
+        //!
+        //! This is an implementation of the QRunnable method.
+        //!
+        //! \see void QRunnable::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        SliceCompositor const& m_compositor;
+        int m_firstRow, m_endRow, m_width;
+        unsigned char* m_out;
+        QSemaphore& m_done;
+};
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SliceCompositor.cpp
+//! \brief The SliceCompositor.cpp file contains the definition of non-inline
+//!        methods of the SliceCompositor class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <QSemaphore>
+
+#include "SliceCompositor.h"
+#include "SliceCompositeTask.h"
+using namespace std;
+
+// The 'locatePixel' function finds the pixel before a position along a side
+// of a layer and the weight of the next pixel, it returns false outside the
+// layer (the pixels cover half a step around their center)
+static inline bool locatePixel(double position, int size, int& index, int& next, double& weight)
+{
+    if(position < -0.5 || position > size - 0.5)
+        return false;
+
+    index = static_cast<int>(floor(position));
+    weight = position - index;
+    next = index + 1;
+    if(index < 0)
+        index = 0;
+    if(next > size - 1)
+        next = size - 1;
+    return true;
+}
+
+// Constructor
+SliceCompositor::SliceCompositor() : m_layers(), m_pool()
+{}
+
+// Destructor
+SliceCompositor::~SliceCompositor()
+{
+    m_pool.waitForDone();
+}
+
+// The 'clearLayers' method
+void SliceCompositor::clearLayers()
+{
+    m_layers.clear();
+}
+
+// The 'addLayer' method
+void SliceCompositor::addLayer(unsigned char const* pixels, int width, int height,
+                               double const origin[2], double const rowStep[2],
+                               double const columnStep[2], double opacity)
+{
+    Layer layer;
+    layer.pixels = pixels;
+    layer.width = width;
+    layer.height = height;
+    for(int a = 0 ; a < 2 ; a++)
+    {
+        layer.origin[a] = origin[a];
+        layer.rowStep[a] = rowStep[a];
+        layer.columnStep[a] = columnStep[a];
+    }
+    layer.opacity = opacity;
+
+    m_layers.push_back(layer);
+}
+
+// The 'composite' method
+void SliceCompositor::composite(int width, int height, unsigned char* out)
+{
+    // Share the rows among the threads and wait for all of them
+    QSemaphore done;
+    int taskCount = 0;
+    for(int first = 0 ; first < height ; first += s_rowsPerTask, taskCount++)
+    {
+        int end = (first + s_rowsPerTask < height) ? first + s_rowsPerTask : height;
+        m_pool.start(new SliceCompositeTask(*this, first, end, width, out, done));
+    }
+
+    done.acquire(taskCount);
+}
+
+// The 'compositeRows' method
+void SliceCompositor::compositeRows(int firstRow, int endRow, int width, unsigned char* out) const
+{
+    vector<double> color(3 * width);
+    vector<unsigned char> covered(width);
+    for(int j = firstRow ; j < endRow ; j++)
+    {
+        fill(color.begin(), color.end(), 0.0);
+        fill(covered.begin(), covered.end(), 0);
+
+        // Blend each layer over the previous ones
+        for(unsigned int l = 0 ; l < m_layers.size() ; l++)
+        {
+            Layer const& layer = m_layers[l];
+            double u = layer.origin[0] + j * layer.columnStep[0];
+            double v = layer.origin[1] + j * layer.columnStep[1];
+            for(int i = 0 ; i < width ; i++, u += layer.rowStep[0], v += layer.rowStep[1])
+            {
+                int u0, u1, v0, v1;
+                double fu, fv;
+                if(!locatePixel(u, layer.width, u0, u1, fu) || !locatePixel(v, layer.height, v0, v1, fv))
+                    continue;
+
+                // Bilinear interpolation between the four surrounding pixels
+                unsigned char const* p00 = layer.pixels + 4 * (static_cast<long>(v0) * layer.width + u0);
+                unsigned char const* p10 = layer.pixels + 4 * (static_cast<long>(v0) * layer.width + u1);
+                unsigned char const* p01 = layer.pixels + 4 * (static_cast<long>(v1) * layer.width + u0);
+                unsigned char const* p11 = layer.pixels + 4 * (static_cast<long>(v1) * layer.width + u1);
+                double sample[4];
+                for(int c = 0 ; c < 4 ; c++)
+                {
+                    double c0 = p00[c] + fu * (p10[c] - p00[c]);
+                    double c1 = p01[c] + fu * (p11[c] - p01[c]);
+                    sample[c] = c0 + fv * (c1 - c0);
+                }
+
+                double alpha = sample[3] / 255.0 * layer.opacity;
+                if(alpha <= 0)
+                    continue;
+
+                double* pixel = &color[3*i];
+                for(int c = 0 ; c < 3 ; c++)
+                    pixel[c] += alpha * (sample[c] - pixel[c]);
+                covered[i] = 1;
+            }
+        }
+
+        unsigned char* rowOut = out + 4 * static_cast<long>(j) * width;
+        for(int i = 0 ; i < width ; i++, rowOut += 4)
+        {
+            for(int c = 0 ; c < 3 ; c++)
+                rowOut[c] = static_cast<unsigned char>(color[3*i + c] + 0.5);
+            rowOut[3] = covered[i] ? 255 : 0;
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SliceCompositor.h
+//! \brief The SliceCompositor.h file contains the interface of the
+//!        SliceCompositor class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SLICECOMPOSITOR_H
+#define SLICECOMPOSITOR_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include <QThreadPool>
+
+//!
+//! \brief The SliceCompositor class blends the colored slices of several
+//!        series into a single image.
+//!
+//! Each layer is a colored slice (RGBA, like the images of the slice viewers)
+//! placed on the output grid by an affine mapping. The output pixels are
+//! computed in one pass: each layer is interpolated bilinearly and blended over
+//! the previous ones with its opacity, the first layer being at the bottom.
+//! The rows are shared among the threads of a pool.
+//!
+class SliceCompositor
+{
+    public:
+        //!
+        //! \brief The SliceCompositor constructor.
+        //!
+        SliceCompositor();
+
+        //!
+        //! \brief The SliceCompositor destructor.
+        //!
+        ~SliceCompositor();
+
+        //!
+        //! \brief The clearLayers method removes all the layers.
+        //!
+        //! \return Nothing.
+        //!
+        void clearLayers();
+
+        //!
+        //! \brief The addLayer method adds a layer above the previous ones.
+        //!
+        //! The output pixel (i, j) takes the layer pixel at
+        //! origin + i*rowStep + j*columnStep (column, then row of the layer).
+        //! The pixels are only read during the composite method.
+        //!
+        //! \param pixels The RGBA pixels of the layer.
+        //! \param width The number of pixels of a row of the layer.
+        //! \param height The number of rows of the layer.
+        //! \param origin The position of the first output pixel in the layer.
+        //! \param rowStep The step between two output pixels of a row.
+        //! \param columnStep The step between two output rows.
+        //! \param opacity The opacity of the layer (between 0 and 1).
+        //!
+        //! \return Nothing.
+        //!
+        void addLayer(unsigned char const* pixels, int width, int height,
+                      double const origin[2], double const rowStep[2],
+                      double const columnStep[2], double opacity);
+
+        //!
+        //! \brief The composite method blends the layers with all the threads
+        //!        of the pool.
+        //!
+        //! The method returns when every row is computed. The pixels which no
+        //! layer covers are transparent.
+        //!
+        //! \param width The number of pixels of an output row.
+        //! \param height The number of output rows.
+        //! \param out The output buffer (4 bytes per pixel).
+        //!
+        //! \return Nothing.
+        //!
+        void composite(int width, int height, unsigned char* out);
+
+        //!
+        //! \brief The compositeRows method blends the layers on some rows of
+        //!        the output.
+        //!
+        //! The method is called by the tasks of the pool, during a call to the
+        //! composite method, and can be called by several threads at the same
+        //! time.
+        //!
+        //! \param firstRow The first computed row.
+        //! \param endRow The row after the last computed one.
+        //! \param width The number of pixels of an output row.
+        //! \param out The output buffer of the whole image.
+        //!
+        //! \return Nothing.
+        //!
+        void compositeRows(int firstRow, int endRow, int width, unsigned char* out) const;
+
+    private:
+        //!
+        //! \brief The Layer struct holds a layer and its place on the output.
+        //!
+        struct Layer
+        {
+            unsigned char const* pixels;
+            int width, height;
+            double origin[2], rowStep[2], columnStep[2];
+            double opacity;
+        };
+
+        static int const s_rowsPerTask = 16; // The rows computed by a task
+
+        std::vector<Layer> m_layers; // From the bottom to the top
+
+        QThreadPool m_pool; // The compositing threads
+};
+
+#endif
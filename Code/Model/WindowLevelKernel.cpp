@@ -0,0 +1,513 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file WindowLevelKernel.cpp
+//! \brief The WindowLevelKernel.cpp file contains the definition of non-inline
+//!        methods of the WindowLevelKernel class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include <cmath>
+#include <cstdlib>
+
+// The AVX2 instructions are chosen at run time, in functions compiled for
+// them alone, so that the program still runs on the processors without them
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define AVX2_AT_RUN_TIME
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <QTime>
+
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+#include <vtkImageMapToRGBA.h>
+
+#include "WindowLevelKernel.h"
+#include "Colormap.h"
+using namespace std;
+
+#if defined(AVX2_AT_RUN_TIME)
+// The 'hasAvx2' function indicates if the processor and the system support
+// the AVX2 instructions
+static bool hasAvx2()
+{
+    static bool const supported = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return supported;
+}
+
+// The parameters of the kernel, read by the AVX2 functions
+struct TableParameters
+{
+    float slope, intercept, windowMin, windowMax, last;
+    float base[3], origin[3], scale[3];
+    int const* table;
+};
+
+// The 'widenPixels' function widens 8 signed pixels to 32 bits
+__attribute__((target("avx2")))
+static inline __m256i widenPixels(short const* in)
+{
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)));
+}
+
+// The 'widenPixels' function widens 8 unsigned pixels to 32 bits
+__attribute__((target("avx2")))
+static inline __m256i widenPixels(unsigned short const* in)
+{
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)));
+}
+
+// The 'mapRowAvx2' function colors the beginning of a row through the table
+// of the three parts, 8 pixels at a time
+template <class T>
+__attribute__((target("avx2")))
+static int mapRowAvx2(T const* in, unsigned char* out, int count, TableParameters const& p)
+{
+    __m256 slope = _mm256_set1_ps(p.slope), intercept = _mm256_set1_ps(p.intercept);
+    __m256 windowMin = _mm256_set1_ps(p.windowMin), windowMax = _mm256_set1_ps(p.windowMax);
+    __m256 last = _mm256_set1_ps(p.last);
+    __m256 base[3], origin[3], scale[3];
+    for(int part = 0 ; part < 3 ; part++)
+    {
+        base[part] = _mm256_set1_ps(p.base[part]);
+        origin[part] = _mm256_set1_ps(p.origin[part]);
+        scale[part] = _mm256_set1_ps(p.scale[part]);
+    }
+
+    int i = 0;
+    for( ; i + 8 <= count ; i += 8)
+    {
+        __m256 hu = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(widenPixels(in + i)), slope), intercept);
+        __m256 below = _mm256_cmp_ps(hu, windowMin, _CMP_LT_OQ);
+        __m256 above = _mm256_cmp_ps(hu, windowMax, _CMP_GT_OQ);
+
+        __m256 b = _mm256_blendv_ps(_mm256_blendv_ps(base[1], base[0], below), base[2], above);
+        __m256 o = _mm256_blendv_ps(_mm256_blendv_ps(origin[1], origin[0], below), origin[2], above);
+        __m256 s = _mm256_blendv_ps(_mm256_blendv_ps(scale[1], scale[0], below), scale[2], above);
+
+        __m256 index = _mm256_add_ps(b, _mm256_mul_ps(_mm256_sub_ps(hu, o), s));
+        index = _mm256_min_ps(_mm256_max_ps(index, _mm256_setzero_ps()), last);
+
+        __m256i colors = _mm256_i32gather_epi32(p.table, _mm256_cvttps_epi32(index), 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4*i), colors);
+    }
+    return i;
+}
+
+// The 'mapRowDenseAvx2' function colors the beginning of a row through a table
+// which covers all the 16-bit values, with the reads gathered by 8
+template <class T>
+__attribute__((target("avx2")))
+static int mapRowDenseAvx2(T const* in, unsigned char* out, int count, int firstValue,
+                           int const* table)
+{
+    __m256i first = _mm256_set1_epi32(firstValue);
+    int i = 0;
+    for( ; i + 8 <= count ; i += 8)
+    {
+        __m256i index = _mm256_sub_epi32(widenPixels(in + i), first);
+        __m256i colors = _mm256_i32gather_epi32(table, index, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4*i), colors);
+    }
+    return i;
+}
+#endif
+
+#if defined(__SSE2__)
+// The 'loadPixels' function widens 8 signed pixels to two vectors of 32 bits
+static inline void loadPixels(short const* in, __m128i& low, __m128i& high)
+{
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    low = _mm_srai_epi32(_mm_unpacklo_epi16(pixels, pixels), 16);
+    high = _mm_srai_epi32(_mm_unpackhi_epi16(pixels, pixels), 16);
+}
+
+// The 'loadPixels' function widens 8 unsigned pixels to two vectors of 32 bits
+static inline void loadPixels(unsigned short const* in, __m128i& low, __m128i& high)
+{
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    low = _mm_unpacklo_epi16(pixels, _mm_setzero_si128());
+    high = _mm_unpackhi_epi16(pixels, _mm_setzero_si128());
+}
+
+// The 'selectVector' function takes 'b' where the mask is set and 'a' elsewhere
+static inline __m128 selectVector(__m128 a, __m128 b, __m128 mask)
+{
+    return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+}
+
+// The parameters of the kernel, broadcast in vectors
+struct VectorParameters
+{
+    __m128 slope, intercept, windowMin, windowMax, last;
+    __m128 base[3], origin[3], scale[3];
+};
+
+// The 'storeColors' function colors 4 pixels
+static inline void storeColors(__m128i pixels, VectorParameters const& p,
+                               unsigned int const* table, unsigned char* out)
+{
+    __m128 hu = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(pixels), p.slope), p.intercept);
+    __m128 below = _mm_cmplt_ps(hu, p.windowMin);
+    __m128 above = _mm_cmpgt_ps(hu, p.windowMax);
+
+    __m128 base = selectVector(selectVector(p.base[1], p.base[0], below), p.base[2], above);
+    __m128 origin = selectVector(selectVector(p.origin[1], p.origin[0], below), p.origin[2], above);
+    __m128 scale = selectVector(selectVector(p.scale[1], p.scale[0], below), p.scale[2], above);
+
+    __m128 index = _mm_add_ps(base, _mm_mul_ps(_mm_sub_ps(hu, origin), scale));
+    index = _mm_min_ps(_mm_max_ps(index, _mm_setzero_ps()), p.last);
+
+    int indexes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indexes), _mm_cvttps_epi32(index));
+    __m128i colors = _mm_set_epi32(static_cast<int>(table[indexes[3]]),
+                                   static_cast<int>(table[indexes[2]]),
+                                   static_cast<int>(table[indexes[1]]),
+                                   static_cast<int>(table[indexes[0]]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), colors);
+}
+#endif
+
+// The 'mapSeriesSlice' function colors the voxels of a slice of a series, row
+// by row
+template <class T>
+static void mapSeriesSlice(vtkImageData* series, T*, int const extent[6],
+                           WindowLevelKernel const& kernel, unsigned char* out)
+{
+    int width = extent[1] - extent[0] + 1;
+    int height = extent[3] - extent[2] + 1;
+    vtkIdType* increments = series->GetIncrements();
+
+    // The rows of the transverse and frontal slices are contiguous
+    if(width > 1)
+    {
+        for(int z = extent[4] ; z <= extent[5] ; z++)
+            for(int y = extent[2] ; y <= extent[3] ; y++, out += 4*width)
+                kernel.mapRow(static_cast<T*>(series->GetScalarPointer(extent[0], y, z)), out, width);
+        return;
+    }
+
+    // The sagittal rows are gathered first
+    vector<T> row(height);
+    for(int z = extent[4] ; z <= extent[5] ; z++, out += 4*height)
+    {
+        T const* in = static_cast<T*>(series->GetScalarPointer(extent[0], extent[2], z));
+        for(int y = 0 ; y < height ; y++)
+            row[y] = in[y * increments[1]];
+        kernel.mapRow(&row[0], out, height);
+    }
+}
+
+// Constructor
+WindowLevelKernel::WindowLevelKernel()
+    : m_slope(1), m_intercept(0), m_windowMin(0), m_windowMax(0), m_denseFirst(0)
+{
+    for(int i = 0 ; i < 3 ; i++)
+        m_base[i] = m_origin[i] = m_scale[i] = 0;
+}
+
+// Destructor
+WindowLevelKernel::~WindowLevelKernel()
+{}
+
+// The 'compile' method
+void WindowLevelKernel::compile(vtkColorTransferFunction* function, double slope,
+                                double intercept, Range const& window, Range const& maxRange)
+{
+    m_denseTable.clear();
+    m_slope = slope;
+    m_intercept = intercept;
+    m_windowMin = window.min();
+    m_windowMax = window.max();
+
+    // The boundaries and sizes of the three parts of the table
+    double bounds[4] = { maxRange.min(), window.min(), window.max(), maxRange.max() };
+    if(bounds[0] > bounds[1])
+        bounds[0] = bounds[1];
+    if(bounds[3] < bounds[2])
+        bounds[3] = bounds[2];
+    int sizes[3] = { s_outsideSize, s_windowSize, s_outsideSize };
+
+    m_table.resize(sizes[0] + sizes[1] + sizes[2]);
+    vector<double> rgb;
+    int base = 0;
+    for(int part = 0 ; part < 3 ; part++)
+    {
+        double width = bounds[part+1] - bounds[part];
+        m_base[part] = base;
+        m_origin[part] = bounds[part];
+        m_scale[part] = (width > 0) ? (sizes[part] - 1) / width : 0;
+
+        // The function is defined on the stored values
+        rgb.resize(3 * sizes[part]);
+        function->GetTable((bounds[part] - intercept) / slope,
+                           (bounds[part+1] - intercept) / slope,
+                           sizes[part], &rgb[0]);
+
+        for(int i = 0 ; i < sizes[part] ; i++)
+        {
+            unsigned char* color = reinterpret_cast<unsigned char*>(&m_table[base + i]);
+            for(int c = 0 ; c < 3 ; c++)
+                color[c] = static_cast<unsigned char>(floor(0.5 + 255 * rgb[3*i + c]));
+            color[3] = 255;
+        }
+
+        base += sizes[part];
+    }
+}
+
+// The 'compileDense' method
+void WindowLevelKernel::compileDense(Colormap const& colormap, Range const& onRange,
+                                     Range const& onRangeWindow, int firstValue, int count)
+{
+    m_denseFirst = firstValue;
+    m_denseTable.resize(count);
+    colormap.computeTable(onRange, onRangeWindow, firstValue, m_denseTable);
+}
+
+// The 'mapRow' method
+void WindowLevelKernel::mapRow(short const* in, unsigned char* out, int count) const
+{
+    int done = m_denseTable.empty() ? mapRowVector(in, out, count)
+                                    : mapRowDense(in, out, count);
+    mapRow<short>(in + done, out + 4*done, count - done);
+}
+
+// The 'mapRow' method
+void WindowLevelKernel::mapRow(unsigned short const* in, unsigned char* out, int count) const
+{
+    int done = m_denseTable.empty() ? mapRowVector(in, out, count)
+                                    : mapRowDense(in, out, count);
+    mapRow<unsigned short>(in + done, out + 4*done, count - done);
+}
+
+// The 'mapSlice' method
+void WindowLevelKernel::mapSlice(vtkImageData* series, int const extent[6],
+                                 unsigned char* out) const
+{
+    switch(series->GetScalarType())
+    {
+        vtkTemplateMacro(mapSeriesSlice(series, static_cast<VTK_TT*>(0), extent, *this, out));
+    }
+}
+
+// The 'mapRowVector' private template method
+template <class T>
+int WindowLevelKernel::mapRowVector(T const* in, unsigned char* out, int count) const
+{
+#if defined(AVX2_AT_RUN_TIME)
+    if(hasAvx2())
+    {
+        TableParameters p;
+        p.slope = m_slope;
+        p.intercept = m_intercept;
+        p.windowMin = m_windowMin;
+        p.windowMax = m_windowMax;
+        p.last = static_cast<float>(m_table.size() - 1);
+        for(int part = 0 ; part < 3 ; part++)
+        {
+            p.base[part] = m_base[part];
+            p.origin[part] = m_origin[part];
+            p.scale[part] = m_scale[part];
+        }
+        p.table = reinterpret_cast<int const*>(&m_table[0]);
+        return mapRowAvx2(in, out, count, p);
+    }
+#endif
+
+    int i = 0;
+
+#if defined(__SSE2__)
+    VectorParameters p;
+    p.slope = _mm_set1_ps(m_slope);
+    p.intercept = _mm_set1_ps(m_intercept);
+    p.windowMin = _mm_set1_ps(m_windowMin);
+    p.windowMax = _mm_set1_ps(m_windowMax);
+    p.last = _mm_set1_ps(static_cast<float>(m_table.size() - 1));
+    for(int part = 0 ; part < 3 ; part++)
+    {
+        p.base[part] = _mm_set1_ps(m_base[part]);
+        p.origin[part] = _mm_set1_ps(m_origin[part]);
+        p.scale[part] = _mm_set1_ps(m_scale[part]);
+    }
+
+    for( ; i + 8 <= count ; i += 8)
+    {
+        __m128i low, high;
+        loadPixels(in + i, low, high);
+        storeColors(low, p, &m_table[0], out + 4*i);
+        storeColors(high, p, &m_table[0], out + 4*i + 16);
+    }
+#else
+    (void)in;
+    (void)out;
+    (void)count;
+#endif
+
+    return i;
+}
+
+// The 'mapRowDense' private template method
+template <class T>
+int WindowLevelKernel::mapRowDense(T const* in, unsigned char* out, int count) const
+{
+    int i = 0;
+
+#if defined(AVX2_AT_RUN_TIME)
+    // The table covers all the 16-bit values, the reads are gathered by 8
+    if(hasAvx2() && m_denseTable.size() >= 65536)
+        i = mapRowDenseAvx2(in, out, count, m_denseFirst,
+                            reinterpret_cast<int const*>(&m_denseTable[0]));
+#else
+    // A single read per pixel, there is nothing to gain with SSE2
+    (void)in;
+    (void)out;
+    (void)count;
+#endif
+
+    return i;
+}
+
+// The 'instructionSet' static method
+char const* WindowLevelKernel::instructionSet()
+{
+#if defined(AVX2_AT_RUN_TIME)
+    if(hasAvx2())
+        return "AVX2";
+#endif
+
+#if defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// The 'denseInstructionSet' static method
+char const* WindowLevelKernel::denseInstructionSet()
+{
+#if defined(AVX2_AT_RUN_TIME)
+    if(hasAvx2())
+        return "AVX2";
+#endif
+
+    return "scalar";
+}
+
+// The 'benchmark' static method
+void WindowLevelKernel::benchmark(ostream& stream)
+{
+    int const repetitions = 20;
+    int const sizes[2] = { 512, 1024 };
+
+    // A CT-like window with a colored colormap
+    Range maxRange(-1024, 3071), window(-160, 240);
+    Colormap colormap;
+    colormap.addColor(0, QColor(0, 0, 0));
+    colormap.addColor(0.5, QColor(255, 0, 0));
+    colormap.addColor(1, QColor(255, 255, 0));
+
+    vtkSmartPointer<vtkColorTransferFunction> function;
+    function.TakeReference(colormap.computeVTKColorTransferFunction(maxRange, window));
+
+    WindowLevelKernel kernel;
+    kernel.compile(function, 1, 0, window, maxRange);
+
+    QTime clock;
+    clock.start();
+    WindowLevelKernel denseKernel;
+    denseKernel.compileDense(colormap, maxRange, window, -32768, 65536);
+    int denseCompileTime = clock.elapsed();
+
+    stream << "Window/level benchmark (" << instructionSet() << " rows, "
+           << denseInstructionSet() << " dense table, " << repetitions << " repetitions)"
+           << endl;
+    stream << "  Dense table compiled in " << denseCompileTime << " ms" << endl;
+
+    for(int s = 0 ; s < 2 ; s++)
+    {
+        int size = sizes[s];
+
+        // A slice of pseudo-random values
+        vtkSmartPointer<vtkImageData> slice = vtkSmartPointer<vtkImageData>::New();
+        slice->SetDimensions(size, size, 1);
+        slice->SetScalarTypeToShort();
+        slice->SetNumberOfScalarComponents(1);
+        slice->AllocateScalars();
+        short* pixels = static_cast<short*>(slice->GetScalarPointer());
+        srand(size);
+        for(int i = 0 ; i < size*size ; i++)
+            pixels[i] = static_cast<short>(-1024 + rand() % 4096);
+
+        // The current VTK path
+        vtkSmartPointer<vtkImageMapToRGBA> mapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
+        mapper->SetOutputFormatToRGBA();
+        mapper->PassAlphaToOutputOn();
+        mapper->SetLookupTable(function);
+        mapper->SetInput(slice);
+
+        clock.restart();
+        for(int r = 0 ; r < repetitions ; r++)
+        {
+            mapper->Modified();
+            mapper->Update();
+        }
+        double vtkTime = static_cast<double>(clock.elapsed()) / repetitions;
+
+        // The kernel, one pixel at a time and with vector instructions
+        vector<unsigned char> colors(4 * size * size);
+        clock.restart();
+        for(int r = 0 ; r < repetitions ; r++)
+            for(int y = 0 ; y < size ; y++)
+                kernel.mapRow<short>(pixels + y*size, &colors[4*y*size], size);
+        double scalarTime = static_cast<double>(clock.elapsed()) / repetitions;
+
+        clock.restart();
+        for(int r = 0 ; r < repetitions ; r++)
+            for(int y = 0 ; y < size ; y++)
+                kernel.mapRow(pixels + y*size, &colors[4*y*size], size);
+        double vectorTime = static_cast<double>(clock.elapsed()) / repetitions;
+
+        clock.restart();
+        for(int r = 0 ; r < repetitions ; r++)
+            for(int y = 0 ; y < size ; y++)
+                denseKernel.mapRow(pixels + y*size, &colors[4*y*size], size);
+        double denseTime = static_cast<double>(clock.elapsed()) / repetitions;
+
+        stream << "  " << size << "x" << size << " : VTK " << vtkTime << " ms, scalar "
+               << scalarTime << " ms, " << instructionSet() << " " << vectorTime
+               << " ms, " << denseInstructionSet() << " dense table " << denseTime
+               << " ms" << endl;
+    }
+}
@@ -0,0 +1,299 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file WindowLevelKernel.h
+//! \brief The WindowLevelKernel.h file contains the interface of the
+//!        WindowLevelKernel class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef WINDOWLEVELKERNEL_H
+#define WINDOWLEVELKERNEL_H
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkImageData.h>
+
+#include "Range.h"
+#include "Colormap.h"
+
+//!
+//! \brief The WindowLevelKernel class converts rows of stored pixels into RGBA
+//!        colors.
+//!
+//! Each pixel is converted in hounsfield units with the rescale slope and
+//! intercept, placed relatively to the hounsfield window and the hounsfield
+//! range, and its color is read in a dense table sampled from a color
+//! transfer function. The table has three parts: below the window, inside the
+//! window and above the window, so that the window keeps a fine sampling
+//! whatever its width.
+//!
+//! For the series stored on 8 or 16 bits, a dense table can also be compiled
+//! from the colormap: it has one entry per stored value, so that the color of
+//! a pixel is a single read in the table.
+//!
+//! The rows of 16-bit pixels are converted with AVX2 instructions when the
+//! processor supports them, which is checked at run time, or else with SSE2
+//! instructions when the program is compiled for them. The other types and
+//! the end of the rows are converted one pixel at a time.
+//!
+class WindowLevelKernel
+{
+    public:
+        //!
+        //! \brief The WindowLevelKernel constructor.
+        //!
+        //! The kernel is not usable before a call to the compile() method.
+        //!
+        WindowLevelKernel();
+
+        //!
+        //! \brief The WindowLevelKernel destructor.
+        //!
+        ~WindowLevelKernel();
+
+        //!
+        //! \brief The isCompiled method indicates if the kernel can be used.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A boolean which is true if the compile or compileDense
+        //!         method was called.
+        //!
+        inline bool isCompiled() const;
+
+        //!
+        //! \brief The compile method samples a color transfer function and
+        //!        stores the parameters of the conversion.
+        //!
+        //! The dense table compiled before, if any, is dropped.
+        //!
+        //! \param function The color transfer function, on the stored values.
+        //! \param slope The rescale slope of the series.
+        //! \param intercept The rescale intercept of the series.
+        //! \param window The hounsfield window.
+        //! \param maxRange The range which contains all the hounsfield values.
+        //!
+        //! \return Nothing.
+        //!
+        void compile(vtkColorTransferFunction* function, double slope,
+                     double intercept, Range const& window, Range const& maxRange);
+
+        //!
+        //! \brief The compileDense method compiles a colormap into a table
+        //!        indexed by the stored values, which is then used instead of
+        //!        the hounsfield conversion.
+        //!
+        //! \param colormap The colormap to compile.
+        //! \param onRange The range of the colormap, on the stored values.
+        //! \param onRangeWindow The window of the colormap, on the stored
+        //!                      values.
+        //! \param firstValue The smallest stored value.
+        //! \param count The number of stored values (65536 for 16-bit series).
+        //!
+        //! \return Nothing.
+        //!
+        void compileDense(Colormap const& colormap, Range const& onRange,
+                          Range const& onRangeWindow, int firstValue, int count);
+
+        //!
+        //! \brief The mapRow method converts a row of pixels into RGBA colors.
+        //!
+        //! This version converts one pixel at a time and is used for the
+        //! types which have no vectorized version.
+        //!
+        //! The method is a template on the pixel type.
+        //!
+        //! \param in The first pixel of the row.
+        //! \param out The output buffer (4 bytes per pixel).
+        //! \param count The number of pixels of the row.
+        //!
+        //! \return Nothing.
+        //!
+        template <class T>
+        void mapRow(T const* in, unsigned char* out, int count) const;
+
+        //!
+        //! \brief The mapRow method converts a row of signed 16-bit pixels into
+        //!        RGBA colors with vector instructions.
+        //!
+        //! \param in The first pixel of the row.
+        //! \param out The output buffer (4 bytes per pixel).
+        //! \param count The number of pixels of the row.
+        //!
+        //! \return Nothing.
+        //!
+        void mapRow(short const* in, unsigned char* out, int count) const;
+
+        //!
+        //! \brief The mapRow method converts a row of unsigned 16-bit pixels
+        //!        into RGBA colors with vector instructions.
+        //!
+        //! \param in The first pixel of the row.
+        //! \param out The output buffer (4 bytes per pixel).
+        //! \param count The number of pixels of the row.
+        //!
+        //! \return Nothing.
+        //!
+        void mapRow(unsigned short const* in, unsigned char* out, int count) const;
+
+        //!
+        //! \brief The mapSlice method converts an axis-aligned slice of a
+        //!        series into RGBA colors.
+        //!
+        //! The output holds the pixels in the order of the VTK images: along
+        //! the first axis of the slice, then along the second one.
+        //!
+        //! \param series The series.
+        //! \param extent The extent of the slice (one of its axes is flat).
+        //! \param out The output buffer (4 bytes per pixel).
+        //!
+        //! \return Nothing.
+        //!
+        void mapSlice(vtkImageData* series, int const extent[6], unsigned char* out) const;
+
+        //!
+        //! \brief The instructionSet static method returns the name of the
+        //!        instructions used for the 16-bit rows on this processor.
+        //!
+        //! \return "AVX2", "SSE2" or "scalar".
+        //!
+        static char const* instructionSet();
+
+        //!
+        //! \brief The denseInstructionSet static method returns the name of
+        //!        the instructions used for the 16-bit rows with a dense table
+        //!        on this processor.
+        //!
+        //! \return "AVX2" or "scalar".
+        //!
+        static char const* denseInstructionSet();
+
+        //!
+        //! \brief The benchmark static method compares the time spent to color
+        //!        512x512 and 1024x1024 slices with the kernel and with VTK.
+        //!
+        //! \param stream The stream on which the results are printed.
+        //!
+        //! \return Nothing.
+        //!
+        static void benchmark(std::ostream& stream);
+
+    private:
+        //!
+        //! \brief The mapRowVector private method converts the beginning of a
+        //!        row of 16-bit pixels with vector instructions.
+        //!
+        //! The method is a template on the pixel type (short or unsigned
+        //! short).
+        //!
+        //! \param in The first pixel of the row.
+        //! \param out The output buffer (4 bytes per pixel).
+        //! \param count The number of pixels of the row.
+        //!
+        //! \return The number of converted pixels.
+        //!
+        template <class T>
+        int mapRowVector(T const* in, unsigned char* out, int count) const;
+
+        //!
+        //! \brief The mapRowDense private method converts the beginning of a
+        //!        row of 16-bit pixels with the dense table.
+        //!
+        //! The method is a template on the pixel type (short or unsigned
+        //! short).
+        //!
+        //! \param in The first pixel of the row.
+        //! \param out The output buffer (4 bytes per pixel).
+        //! \param count The number of pixels of the row.
+        //!
+        //! \return The number of converted pixels.
+        //!
+        template <class T>
+        int mapRowDense(T const* in, unsigned char* out, int count) const;
+
+        static int const s_outsideSize = 256;  // Entries below or above the window
+        static int const s_windowSize = 4096;  // Entries inside the window
+
+        std::vector<unsigned int> m_table; // The RGBA colors
+
+        float m_slope, m_intercept;        // From stored values to hounsfield
+        float m_windowMin, m_windowMax;    // The hounsfield window
+
+        // For each part of the table, the index of the entry of 'origin'
+        // is 'base', and the index grows of 'scale' per hounsfield unit
+        float m_base[3], m_origin[3], m_scale[3];
+
+        std::vector<unsigned int> m_denseTable; // One color per stored value
+        int m_denseFirst;                       // The stored value of entry 0
+};
+
+// The 'isCompiled' method
+inline bool WindowLevelKernel::isCompiled() const
+{ return !m_table.empty() || !m_denseTable.empty(); }
+
+// The 'mapRow' template method
+template <class T>
+void WindowLevelKernel::mapRow(T const* in, unsigned char* out, int count) const
+{
+    if(!m_denseTable.empty())
+    {
+        long lastEntry = static_cast<long>(m_denseTable.size()) - 1;
+        for(int i = 0 ; i < count ; i++)
+        {
+            long index = static_cast<long>(in[i]) - m_denseFirst;
+            if(index < 0)
+                index = 0;
+            else if(index > lastEntry)
+                index = lastEntry;
+
+            memcpy(out + 4*i, &m_denseTable[index], 4);
+        }
+        return;
+    }
+
+    float last = static_cast<float>(m_table.size() - 1);
+    for(int i = 0 ; i < count ; i++)
+    {
+        float hu = static_cast<float>(in[i]) * m_slope + m_intercept;
+        int part = (hu < m_windowMin) ? 0 : ((hu > m_windowMax) ? 2 : 1);
+
+        float index = m_base[part] + (hu - m_origin[part]) * m_scale[part];
+        if(index < 0)
+            index = 0;
+        else if(index > last)
+            index = last;
+
+        memcpy(out + 4*i, &m_table[static_cast<int>(index)], 4);
+    }
+}
+
+#endif
@@ -81,6 +81,17 @@ Range HounsfieldColormapDialog::getMaximumRange()
     return m_hounsfieldWidget->getMaximumRange();
 }
 
+// The 'setHounsfield' slot
+void HounsfieldColormapDialog::setHounsfield(Range const& hounsfield)
+{
+    m_currentConfig.setHounsfield(hounsfield, getMaximumRange());
+    updateComponentsFromCurrentConfiguration();
+    if(!isVisible())
+        m_previousConfig = m_currentConfig;
+
+    sendCurrentConfiguration(false, false);
+}
+
 // The 'updateComponentsFromCurrentConfiguration' method
 void HounsfieldColormapDialog::updateComponentsFromCurrentConfiguration()
 {
@@ -75,6 +75,20 @@ class HounsfieldColormapDialog : public ViewConfigurationDialog
         //!
         Range getMaximumRange();
 
+    public slots:
+        //!
+        //! \brief The setHounsfield slot applies a hounsfield window chosen
+        //!        outside the dialog, and sends the new configuration.
+        //!
+        //! When the dialog is hidden, the window is also kept as the window to
+        //! go back to on a cancel.
+        //!
+        //! \param hounsfield The new hounsfield window.
+        //!
+        //! \return Nothing.
+        //!
+        void setHounsfield(Range const& hounsfield);
+
     protected:
         //!
         //! \brief The updateComponentsFromCurrentConfiguration method updates
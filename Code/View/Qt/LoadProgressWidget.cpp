@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadProgressWidget.cpp
+//! \brief The LoadProgressWidget.cpp file contains the definition of
+//!        non-inline methods of the LoadProgressWidget class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "LoadProgressWidget.h"
+using namespace std;
+using namespace customwidget;
+
+// Constructor
+LoadProgressWidget::LoadProgressWidget(QString const& seriesId, QString const& title,
+                                       QWidget* parent)
+    : Widget(parent), m_seriesId(seriesId)
+{
+    QHBoxLayout* hLayout = new QHBoxLayout();
+    hLayout->setMargin(0);
+
+    m_titleLabel = new Label(title);
+    hLayout->addWidget(m_titleLabel, 1);
+
+    m_progressBar = new ProgressBar();
+    m_progressBar->setMinimum(0);
+    m_progressBar->setMaximum(100);
+    m_progressBar->setValue(0);
+    hLayout->addWidget(m_progressBar, 1);
+
+    m_summaryLabel = new Label("");
+    m_summaryLabel->setMinimumWidth(140);
+    hLayout->addWidget(m_summaryLabel);
+
+    m_prioritizeButton = new PushButton("Prioriser");
+    hLayout->addWidget(m_prioritizeButton);
+    m_cancelButton = new PushButton("Annuler");
+    hLayout->addWidget(m_cancelButton);
+
+    setLayout(hLayout);
+
+    // Event connections
+    connect(m_prioritizeButton, SIGNAL(clicked()), this, SLOT(emitPrioritized()));
+    connect(m_cancelButton, SIGNAL(clicked()), this, SLOT(emitCanceled()));
+}
+
+// Destructor
+LoadProgressWidget::~LoadProgressWidget()
+{}
+
+// The 'setProgress' method
+void LoadProgressWidget::setProgress(float progress, QString const& summary)
+{
+    m_progressBar->setValue(ceil(progress*100));
+    m_summaryLabel->setText(summary);
+}
+
+// The 'emitPrioritized' private slot
+void LoadProgressWidget::emitPrioritized()
+{
+    emit prioritized(m_seriesId);
+}
+
+// The 'emitCanceled' private slot
+void LoadProgressWidget::emitCanceled()
+{
+    m_cancelButton->setEnabled(false);
+    emit canceled(m_seriesId);
+}
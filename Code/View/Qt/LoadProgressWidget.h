@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file LoadProgressWidget.h
+//! \brief The LoadProgressWidget.h file contains the interface of the
+//!        LoadProgressWidget class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef LOADPROGRESSWIDGET_H
+#define LOADPROGRESSWIDGET_H
+
+#include <cmath>
+
+#include <QBoxLayout>
+
+#include "View/Qt/customwidget/Label.h"
+#include "View/Qt/customwidget/ProgressBar.h"
+#include "View/Qt/customwidget/PushButton.h"
+#include "View/Qt/customwidget/Widget.h"
+
+//!
+//! \brief The LoadProgressWidget class shows the loading progression of a
+//!        series and permits to the user to prioritize or cancel it.
+//!
+class LoadProgressWidget : public customwidget::Widget
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The LoadProgressWidget constructor builds the widget of a
+        //!        series load.
+        //!
+        //! \param seriesId The id of the loaded series.
+        //! \param title The text which describes the series.
+        //! \param parent The parent widget.
+        //!
+        LoadProgressWidget(QString const& seriesId, QString const& title,
+                           QWidget* parent = 0);
+
+        //!
+        //! \brief The LoadProgressWidget destructor.
+        //!
+        ~LoadProgressWidget();
+
+        //!
+        //! \brief The seriesId method returns the id of the loaded series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return A QString object which contains the series id.
+        //!
+        inline QString const& seriesId() const;
+
+        //!
+        //! \brief The setProgress method updates the progress bar and the
+        //!        loading description.
+        //!
+        //! \param progress A floating point value between 0 and 1.
+        //! \param summary A short description of the loading (transfer rate,
+        //!                remaining time).
+        //!
+        //! \return Nothing.
+        //!
+        void setProgress(float progress, QString const& summary);
+
+    private slots:
+        //!
+        //! \brief The emitPrioritized private slot signals that the user asked
+        //!        to load the series first.
+        //!
+        //! \section emit
+        //! The prioritized(QString) signal is emitted.
+        //!
+        //! \return Nothing.
+        //!
+        void emitPrioritized();
+
+        //!
+        //! \brief The emitCanceled private slot signals that the user asked
+        //!        to cancel the loading of the series.
+        //!
+        //! \section emit
+        //! The canceled(QString) signal is emitted.
+        //!
+        //! \return Nothing.
+        //!
+        void emitCanceled();
+
+    signals:
+        //!
+        //! \brief The prioritized signal, once emitted, indicates that the
+        //!        series must be loaded before the other ones.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        void prioritized(QString const& seriesId);
+
+        //!
+        //! \brief The canceled signal, once emitted, indicates that the
+        //!        loading of the series must be canceled.
+        //!
+        //! \param seriesId The id of the series.
+        //!
+        void canceled(QString const& seriesId);
+
+    private:
+        QString m_seriesId;
+
+        customwidget::Label *m_titleLabel, *m_summaryLabel;
+        customwidget::ProgressBar* m_progressBar;
+        customwidget::PushButton *m_prioritizeButton, *m_cancelButton;
+};
+
+// The 'seriesId' inline method
+inline QString const& LoadProgressWidget::seriesId() const
+{ return m_seriesId; }
+
+#endif
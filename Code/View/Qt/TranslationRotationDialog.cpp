@@ -121,6 +121,27 @@ TranslationRotationDialog::TranslationRotationDialog(QWidget* parent)
 TranslationRotationDialog::~TranslationRotationDialog()
 {}
 
+// The 'setTransform' slot
+void TranslationRotationDialog::setTransform(Vector3D const& translation, Vector3D const& rotation)
+{
+    // The angles are brought back in the range of the dials
+    double angles[3] = { rotation.x(), rotation.y(), rotation.z() };
+    for(int i = 0 ; i < 3 ; i++)
+    {
+        angles[i] = fmod(angles[i], 360);
+        if(angles[i] < 0)
+            angles[i] += 360;
+    }
+
+    m_currentConfig.setTranslation(translation);
+    m_currentConfig.setRotation(Vector3D(angles[0], angles[1], angles[2]));
+    updateComponentsFromCurrentConfiguration();
+    if(!isVisible())
+        m_previousConfig = m_currentConfig;
+
+    sendCurrentConfiguration(false, false);
+}
+
 // The 'updateComponentsFromCurrentConfiguration' method
 void TranslationRotationDialog::updateComponentsFromCurrentConfiguration()
 {
@@ -36,6 +36,8 @@
 #ifndef TRANSLATIONROTATIONDIALOG_H
 #define TRANSLATIONROTATIONDIALOG_H
 
+#include <cmath>
+
 #include <QFormLayout>
 
 #include "View/Qt/customwidget/Dial.h"
@@ -69,6 +71,21 @@ class TranslationRotationDialog : public ViewConfigurationDialog
         //!
         ~TranslationRotationDialog();
 
+    public slots:
+        //!
+        //! \brief The setTransform slot applies a translation and a rotation
+        //!        found outside the dialog, and sends the new configuration.
+        //!
+        //! When the dialog is hidden, they are also kept as the ones to go back
+        //! to on a cancel.
+        //!
+        //! \param translation The new translation (in mm).
+        //! \param rotation The new rotation (in degrees).
+        //!
+        //! \return Nothing.
+        //!
+        void setTransform(Vector3D const& translation, Vector3D const& rotation);
+
     protected:
         //!
         //! \brief The updateComponentsFromCurrentConfiguration method updates
@@ -98,6 +98,16 @@ class ViewConfigurationDialog : public OkCancelDialog
         //!
         virtual void setLayout(QLayout* layout);
 
+        //!
+        //! \brief The currentConfiguration method returns the configuration
+        //!        the dialog currently shows.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The current ViewConfiguration of the dialog.
+        //!
+        inline ViewConfiguration const& currentConfiguration() const;
+
     public slots:
         //!
         //! \brief The accept method saves the current configuration (so that
@@ -202,4 +212,7 @@ class ViewConfigurationDialog : public OkCancelDialog
         customwidget::PushButton* m_resetButton;
 };
 
+inline ViewConfiguration const& ViewConfigurationDialog::currentConfiguration() const
+{ return m_currentConfig; }
+
 #endif
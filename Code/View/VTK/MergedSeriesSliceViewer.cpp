@@ -37,10 +37,20 @@ using namespace std;
 
 // Constructor
 MergedSeriesSliceViewer::MergedSeriesSliceViewer(SliceOrientation orientation)
-    : MergedSeriesViewer(), m_orientation(orientation), m_currentSlice(0)
+    : MergedSeriesViewer(), m_orientation(orientation), m_currentSlice(0),
+      m_cameraPending(false)
 {
     renderWindow()->GetInteractor()->SetInteractorStyle(vtkSmartPointer<vtkInteractorStyleImage>::New());
 
+    // The single image which shows the blended slices
+    m_compositeImage = vtkSmartPointer<vtkImageData>::New();
+    m_compositeImage->SetScalarTypeToUnsignedChar();
+    m_compositeImage->SetNumberOfScalarComponents(4);
+    m_compositeActor = vtkSmartPointer<vtkImageActor>::New();
+    m_compositeActor->SetInput(m_compositeImage);
+    m_compositeActor->VisibilityOff();
+    renderer()->AddViewProp(m_compositeActor);
+
     vtkCamera* camera = renderer()->GetActiveCamera();
     camera->ParallelProjectionOn();
     switch(orientation)
@@ -67,7 +77,11 @@ MergedSeriesSliceViewer::MergedSeriesSliceViewer(SliceOrientation orientation)
 
 // Destructor
 MergedSeriesSliceViewer::~MergedSeriesSliceViewer()
-{}
+{
+    map<SeriesViewer*, FusedSeries*>::iterator it;
+    for(it = m_fusedSeries.begin() ; it != m_fusedSeries.end() ; ++it)
+        delete it->second;
+}
 
 // The 'changeCurrentSlice' slot
 void MergedSeriesSliceViewer::changeCurrentSlice(double value)
@@ -75,37 +89,306 @@ void MergedSeriesSliceViewer::changeCurrentSlice(double value)
     m_currentSlice = value;
 
     for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->changeCurrentSlice(value);
+
+    scheduleRender();
+}
+
+// The 'linkSeriesViewer' method
+void MergedSeriesSliceViewer::linkSeriesViewer(SeriesViewer* seriesViewer)
+{
+    m_seriesViewers.push_back(seriesViewer);
+
+    m_cameraPending = true;
+    scheduleRender();
+}
+
+// The 'unlinkSeriesViewer' method
+void MergedSeriesSliceViewer::unlinkSeriesViewer(SeriesViewer* seriesViewer)
+{
+    m_seriesViewers.erase(remove(m_seriesViewers.begin(), m_seriesViewers.end(), seriesViewer),
+                          m_seriesViewers.end());
+
+    map<SeriesViewer*, FusedSeries*>::iterator it = m_fusedSeries.find(seriesViewer);
+    if(it != m_fusedSeries.end())
     {
-        SeriesSliceViewer* ssv = dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i));
-        ssv->changeCurrentSlice(value);
+        delete it->second;
+        m_fusedSeries.erase(it);
+    }
+
+    m_cameraPending = true;
+    scheduleRender();
+}
+
+// The 'applyPendingUpdates' method
+void MergedSeriesSliceViewer::applyPendingUpdates()
+{
+    Viewer::applyPendingUpdates();
+
+    // The slices of the series must be up to date before the blend
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->applyPendingUpdates();
+
+    compositeSlices();
+
+    if(m_cameraPending && m_compositeActor->GetVisibility())
+    {
+        renderer()->ResetCamera();
+        m_cameraPending = false;
+    }
+    renderer()->ResetCameraClippingRange();
+}
+
+// The 'compositeSlices' method
+void MergedSeriesSliceViewer::compositeSlices()
+{
+    // The axes of the grid: p along the rows, q along the columns
+    int axis = m_orientation;
+    int p = (axis == 0) ? 1 : 0;
+    int q = (axis == 2) ? 1 : 2;
 
-        vtkImageActor* actor = dynamic_cast<vtkImageActor*>(ssv->getVtkProp3D());
-        double* display = actor->GetDisplayBounds();
-        double* position = actor->GetPosition();
+    // The other series are resampled on the grid of the first one, if its
+    // slice is made of planes of its series
+    SeriesSliceViewer* reference = m_seriesViewers.empty() ? 0
+                                 : dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(0));
+    int first = 0, last = 0;
+    bool regrid = reference && reference->displayedPlanes(first, last)
+                  && reference->sliceImage()->GetPointData()->GetScalars();
 
-        switch(m_orientation)
+    // Find the visible slices, and stop if none of them changed
+    vector<vtkImageData*> images;
+    vector<vtkProp3D*> placements; // The props which place the slices
+    vector<double> opacities;
+    vector<unsigned long> stamps;
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+    {
+        SeriesSliceViewer* ssv = dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i));
+        vtkImageData* image = ssv->sliceImage();
+        vtkProp3D* actor = ssv->getVtkProp3D();
+        if(!actor->GetVisibility() || !image->GetPointData()->GetScalars())
+            continue;
+
+        stamps.push_back(actor->GetMTime());
+        vtkImageData* regridded = (regrid && ssv != reference)
+                                ? regridSlice(reference, ssv, first, last) : 0;
+        if(regridded)
         {
-            case SAGITTAL:
-                actor->SetPosition(-display[0]+i, position[1], position[2]);
-                break;
+            image = regridded;
+            actor = reference->getVtkProp3D();
+            stamps.push_back(actor->GetMTime());
+        }
 
-            case FRONTAL:
-                actor->SetPosition(position[0], -display[2]-i, position[2]);
-                break;
+        images.push_back(image);
+        placements.push_back(actor);
+        opacities.push_back(ssv->getPropOpacity());
+        stamps.push_back(image->GetMTime());
+    }
+
+    if(images.empty())
+    {
+        m_compositeActor->VisibilityOff();
+        m_layerStamps.clear();
+        return;
+    }
+
+    if(stamps == m_layerStamps && m_compositeActor->GetVisibility())
+        return;
+    m_layerStamps = stamps;
 
-            case TRANSVERSE:
-                actor->SetPosition(position[0], position[1], -display[4]-i);
-                break;
+    // The grid covers all the slices, with their finest pixels
+    double bounds[4] = { numeric_limits<double>::max(), -numeric_limits<double>::max(),
+                         numeric_limits<double>::max(), -numeric_limits<double>::max() };
+    double pixel = numeric_limits<double>::max();
+    for(unsigned int l = 0 ; l < images.size() ; l++)
+    {
+        double* b = placements[l]->GetBounds();
+        bounds[0] = min(bounds[0], b[2*p]);
+        bounds[1] = max(bounds[1], b[2*p+1]);
+        bounds[2] = min(bounds[2], b[2*q]);
+        bounds[3] = max(bounds[3], b[2*q+1]);
+
+        double* spacing = images[l]->GetSpacing();
+        pixel = min(pixel, min(spacing[p], spacing[q]));
+    }
+
+    double side = max(bounds[1] - bounds[0], bounds[3] - bounds[2]);
+    if(side / pixel + 1 > s_maxCompositeSize)
+        pixel = side / (s_maxCompositeSize - 1);
+    int width = static_cast<int>(floor((bounds[1] - bounds[0]) / pixel)) + 1;
+    int height = static_cast<int>(floor((bounds[3] - bounds[2]) / pixel)) + 1;
+
+    // Place each slice on the grid: the pixel (i, j) of the grid is at the
+    // point of the slice seen along the axis of the viewer
+    m_compositor.clearLayers();
+    for(unsigned int l = 0 ; l < images.size() ; l++)
+    {
+        vtkImageData* image = images[l];
+        int* e = image->GetExtent();
+        double* s = image->GetSpacing();
+        double* o = image->GetOrigin();
+
+        double corners[3][4];
+        for(int c = 0 ; c < 3 ; c++)
+        {
+            for(int a = 0 ; a < 3 ; a++)
+                corners[c][a] = o[a] + s[a] * e[2*a];
+            corners[c][3] = 1;
         }
+        corners[1][p] += s[p];
+        corners[2][q] += s[q];
+
+        vtkMatrix4x4* matrix = placements[l]->GetMatrix();
+        double world[3][4];
+        for(int c = 0 ; c < 3 ; c++)
+            matrix->MultiplyPoint(corners[c], world[c]);
+
+        double ap = world[1][p] - world[0][p], aq = world[1][q] - world[0][q];
+        double bp = world[2][p] - world[0][p], bq = world[2][q] - world[0][q];
+        double det = ap * bq - bp * aq;
+        if(fabs(det) < 1e-9)
+            continue; // The slice is seen edge-on
+
+        double dp = bounds[0] - world[0][p], dq = bounds[2] - world[0][q];
+        double origin[2] = { (bq * dp - bp * dq) / det, (ap * dq - aq * dp) / det };
+        double rowStep[2] = { bq * pixel / det, -aq * pixel / det };
+        double columnStep[2] = { -bp * pixel / det, ap * pixel / det };
+
+        m_compositor.addLayer(static_cast<unsigned char*>(image->GetScalarPointer()),
+                              e[2*p+1] - e[2*p] + 1, e[2*q+1] - e[2*q] + 1,
+                              origin, rowStep, columnStep, opacities[l]);
     }
 
-    renderer()->ResetCameraClippingRange();
-    repaint();
+    // The image is only allocated again when its size changes
+    int extent[6] = { 0, 0, 0, 0, 0, 0 };
+    extent[2*p+1] = width - 1;
+    extent[2*q+1] = height - 1;
+    double spacing[3] = { 1, 1, 1 }, origin[3] = { 0, 0, 0 };
+    spacing[p] = spacing[q] = pixel;
+    origin[p] = bounds[0];
+    origin[q] = bounds[2];
+
+    vtkDataArray* scalars = m_compositeImage->GetPointData()->GetScalars();
+    m_compositeImage->SetSpacing(spacing);
+    m_compositeImage->SetOrigin(origin);
+    m_compositeImage->SetExtent(extent);
+    m_compositeImage->SetWholeExtent(extent);
+    if(!scalars || scalars->GetNumberOfTuples() != static_cast<vtkIdType>(width) * height)
+        m_compositeImage->AllocateScalars();
+
+    m_compositor.composite(width, height, static_cast<unsigned char*>(m_compositeImage->GetScalarPointer()));
+    m_compositeImage->Modified();
+
+    m_compositeActor->SetDisplayExtent(extent);
+    m_compositeActor->VisibilityOn();
+}
+
+// The 'regridSlice' private method
+vtkImageData* MergedSeriesSliceViewer::regridSlice(SeriesSliceViewer* reference,
+                                                   SeriesSliceViewer* viewer,
+                                                   int first, int last)
+{
+    WindowLevelKernel const& kernel = viewer->kernel();
+    if(!kernel.isCompiled())
+        return 0;
+
+    FusedSeries*& fused = m_fusedSeries[viewer];
+    if(!fused)
+    {
+        fused = new FusedSeries();
+        fused->image = vtkSmartPointer<vtkImageData>::New();
+        fused->image->SetScalarTypeToUnsignedChar();
+        fused->image->SetNumberOfScalarComponents(4);
+    }
+
+    // The transform from the reference to the series drops the resampled
+    // planes only when it changes
+    vtkSmartPointer<vtkMatrix4x4> referenceMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkSmartPointer<vtkMatrix4x4> movingMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkSmartPointer<vtkMatrix4x4> referenceToMoving = vtkSmartPointer<vtkMatrix4x4>::New();
+    reference->seriesTransform(referenceMatrix);
+    viewer->seriesTransform(movingMatrix);
+    movingMatrix->Invert();
+    vtkMatrix4x4::Multiply4x4(movingMatrix, referenceMatrix, referenceToMoving);
+
+    vtkImageData* grid = const_cast<SeriesData*>(reference->getSeries());
+    vtkImageData* moving = const_cast<SeriesData*>(viewer->getSeries());
+    fused->regridder.setGrid(grid, m_orientation);
+    fused->regridder.setTransform(referenceToMoving);
+
+    // Nothing to do if the planes, the transform and the colormap are the same
+    vtkImageData* slice = reference->sliceImage();
+    vector<unsigned long> stamps;
+    stamps.push_back(slice->GetMTime());
+    stamps.push_back(viewer->sliceImage()->GetMTime());
+    stamps.push_back(moving->GetMTime());
+    stamps.push_back(fused->regridder.version());
+    if(stamps == fused->stamps)
+        return fused->image;
+    fused->stamps = stamps;
+
+    // The slab only holds the planes asked, so its reduction always starts
+    // over
+    vtkImageData* volume = fused->regridder.regrid(moving, first, last);
+    fused->reducer.invalidate();
+
+    // The colored slice is placed like the slice of the reference
+    vtkImageData* image = fused->image;
+    int* extent = slice->GetExtent();
+    vtkDataArray* scalars = image->GetPointData()->GetScalars();
+    image->SetSpacing(slice->GetSpacing());
+    image->SetOrigin(slice->GetOrigin());
+    image->SetExtent(extent);
+    if(!scalars || scalars->GetNumberOfTuples() != slice->GetNumberOfPoints())
+        image->AllocateScalars();
+
+    unsigned char* out = static_cast<unsigned char*>(image->GetScalarPointer());
+    if(reference->slabMode() != SLAB_NONE)
+        fused->reducer.reduce(volume, m_orientation, reference->slabMode(), first, last, kernel, out);
+    else
+        kernel.mapSlice(volume, extent, out);
+    fused->regridder.maskOutside(first, last, out);
+
+    image->Modified();
+    return image;
+}
+
+// The 'enableOblique' slot
+void MergedSeriesSliceViewer::enableOblique(bool enable)
+{
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->enableOblique(enable);
+
+    changeCurrentSlice(m_currentSlice);
+}
+
+// The 'setSlabMode' slot
+void MergedSeriesSliceViewer::setSlabMode(int mode)
+{
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->setSlabMode(mode);
+
+    scheduleRender();
+}
+
+// The 'setSlabThickness' slot
+void MergedSeriesSliceViewer::setSlabThickness(double thickness)
+{
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->setSlabThickness(thickness);
+
+    scheduleRender();
+}
+
+// The 'enableCine' slot
+void MergedSeriesSliceViewer::enableCine(bool enable)
+{
+    for(unsigned int i = 0 ; i < m_seriesViewers.size() ; i++)
+        dynamic_cast<SeriesSliceViewer*>(m_seriesViewers.at(i))->enableCine(enable);
 }
 
 // The 'updateTranslation' method
 void MergedSeriesSliceViewer::updateTranslation(ViewConfiguration const& config)
 {
     changeCurrentSlice(m_currentSlice);
-    repaint();
+    scheduleRender();
 }
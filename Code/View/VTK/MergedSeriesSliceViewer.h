@@ -36,8 +36,21 @@
 #ifndef MERGEDSERIESSLICEVIEWER_H
 #define MERGEDSERIESSLICEVIEWER_H
 
+#include <map>
+#include <vector>
+#include <limits>
+
 #include <vtkCamera.h>
 #include <vtkInteractorStyleImage.h>
+#include <vtkImageActor.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include "Model/SeriesRegridder.h"
+#include "Model/SlabReducer.h"
+#include "Model/SliceCompositor.h"
 
 #include "MergedSeriesViewer.h"
 #include "SeriesSliceViewer.h"
@@ -46,6 +59,15 @@
 //! @brief The MergedSeriesSliceViewer class represents a specific widget to
 //!        visualize multiple SeriesData slice objects.
 //!
+//! The colored slices of the series viewers are not drawn one over the other:
+//! they are blended by a SliceCompositor into a single image, with the opacity
+//! of each series, so that the viewer only draws one slice.
+//!
+//! The first series is the reference: the other ones are resampled on its
+//! grid under their rigid transform, so that their slices match the planes of
+//! the reference. The last resampled planes are kept by a SeriesRegridder for
+//! each of them, until its transform changes.
+//!
 class MergedSeriesSliceViewer : public MergedSeriesViewer
 {
     Q_OBJECT
@@ -74,15 +96,95 @@ class MergedSeriesSliceViewer : public MergedSeriesViewer
         //!
         inline SliceOrientation orientation() const;
 
+        //!
+        //! \brief The linkSeriesViewer method adds the slices of a series
+        //!        viewer above the previous ones.
+        //!
+        //! This is a redefinition of the MergedSeriesViewer::linkSeriesViewer()
+        //! method: the prop of the series viewer is not added to the renderer,
+        //! its slice is blended in the composite image.
+        //!
+        //! \param seriesViewer A pointer to the series viewer to link.
+        //!
+        //! \return Nothing.
+        //!
+        void linkSeriesViewer(SeriesViewer* seriesViewer);
+
+        //!
+        //! \brief The unlinkSeriesViewer method removes the slices of a series
+        //!        viewer.
+        //!
+        //! This is a redefinition of the MergedSeriesViewer::unlinkSeriesViewer()
+        //! method.
+        //!
+        //! \param seriesViewer A pointer to the series viewer to unlink.
+        //!
+        //! \return Nothing.
+        //!
+        void unlinkSeriesViewer(SeriesViewer* seriesViewer);
+
+        //!
+        //! \brief The applyPendingUpdates method applies the updates kept since
+        //!        the last frame, lets the series viewers show the last position
+        //!        asked meanwhile, and blends their slices.
+        //!
+        //! This is a redefinition of the Viewer::applyPendingUpdates() method.
+        //!
+        //! \return Nothing.
+        //!
+        void applyPendingUpdates();
+
     public slots:
         //!
         //! \brief The changeCurrentSlice method update the slice which is
         //!        currently visualized.
         //!
+        //! The slices are shown at the next frame.
+        //!
         //! \return Nothing.
         //!
         void changeCurrentSlice(double value);
 
+        //!
+        //! \brief The enableOblique slot switches the merged slices between
+        //!        the axis-aligned and the oblique mode.
+        //!
+        //! \param enable True to show oblique slices.
+        //!
+        //! \return Nothing.
+        //!
+        void enableOblique(bool enable);
+
+        //!
+        //! \brief The setSlabMode slot chooses how the planes of the slabs of
+        //!        the merged slices are combined.
+        //!
+        //! \param mode The SlabMode of the slabs.
+        //!
+        //! \return Nothing.
+        //!
+        void setSlabMode(int mode);
+
+        //!
+        //! \brief The setSlabThickness slot changes the thickness of the slabs
+        //!        of the merged slices.
+        //!
+        //! \param thickness The thickness of the slabs (in mm).
+        //!
+        //! \return Nothing.
+        //!
+        void setSlabThickness(double thickness);
+
+        //!
+        //! \brief The enableCine slot starts or stops the coloring of the next
+        //!        slices of the merged series in advance.
+        //!
+        //! \param enable True to color the next slices in advance.
+        //!
+        //! \return Nothing.
+        //!
+        void enableCine(bool enable);
+
     protected:
         //!
         //! \brief The updateTranslation method updates the viewer according to
@@ -103,8 +205,63 @@ class MergedSeriesSliceViewer : public MergedSeriesViewer
         void updateTranslation(ViewConfiguration const& config);
 
     private:
+        //!
+        //! \brief The compositeSlices method blends the slices of the series
+        //!        viewers on a grid which covers all of them.
+        //!
+        //! Nothing is done if no slice, prop or opacity changed since the last
+        //! blend.
+        //!
+        //! \return Nothing.
+        //!
+        void compositeSlices();
+
+        //!
+        //! \brief The regridSlice method colors the slice of a series resampled
+        //!        on the grid of the reference, at the planes of the reference
+        //!        slice.
+        //!
+        //! Only the planes which are not resampled yet are computed, and the
+        //! slice is only colored again if the planes, the transform or the
+        //! colormap changed.
+        //!
+        //! \param reference The viewer of the reference series.
+        //! \param viewer The viewer of the resampled series.
+        //! \param first The index of the first plane of the reference slice.
+        //! \param last The index of the last plane of the reference slice.
+        //!
+        //! \return The colored slice (RGBA), placed like the reference slice,
+        //!         or null if the series cannot be colored yet.
+        //!
+        vtkImageData* regridSlice(SeriesSliceViewer* reference, SeriesSliceViewer* viewer,
+                                  int first, int last);
+
+        static int const s_maxCompositeSize = 2048; // In pixels, on each side
+
         SliceOrientation m_orientation;
         double m_currentSlice;
+
+        // The blended slices
+        vtkSmartPointer<vtkImageData> m_compositeImage;
+        vtkSmartPointer<vtkImageActor> m_compositeActor;
+        SliceCompositor m_compositor;
+        std::vector<unsigned long> m_layerStamps; // The state of the last blend
+        bool m_cameraPending; // True if the camera must fit the new slices
+
+        //!
+        //! \brief The FusedSeries struct holds a series resampled on the grid
+        //!        of the reference and its colored slice.
+        //!
+        struct FusedSeries
+        {
+            SeriesRegridder regridder;
+            SlabReducer reducer;
+            vtkSmartPointer<vtkImageData> image;
+            std::vector<unsigned long> stamps; // The state of the last coloring
+        };
+
+        // The series resampled on the grid of the reference
+        std::map<SeriesViewer*, FusedSeries*> m_fusedSeries;
 };
 
 // The 'orientation' method
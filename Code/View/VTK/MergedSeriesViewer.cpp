@@ -52,7 +52,7 @@ void MergedSeriesViewer::linkSeriesViewer(SeriesViewer* seriesViewer)
     renderer()->AddViewProp(newProp);
 
     renderer()->ResetCamera();
-    repaint();
+    scheduleRender();
 }
 
 // The 'unlinkSeriesViewer' method
@@ -72,7 +72,7 @@ void MergedSeriesViewer::unlinkSeriesViewer(SeriesViewer* seriesViewer)
     renderer()->RemoveViewProp(prevProp);
 
     renderer()->ResetCamera();
-    repaint();
+    scheduleRender();
 }
 
 // The 'minSlice' method
@@ -109,26 +109,43 @@ double MergedSeriesViewer::maxSlice() const
     return max;
 }
 
+// The 'sliceStep' method
+double MergedSeriesViewer::sliceStep() const
+{
+    if(m_seriesViewers.size() == 0)
+        return Viewer::sliceStep();
+
+    double step = dynamic_cast<SeriesViewer*>(m_seriesViewers.at(0))->sliceStep();
+    for(unsigned int i = 1 ; i < m_seriesViewers.size() ; i++)
+    {
+        double newStep = dynamic_cast<SeriesViewer*>(m_seriesViewers.at(i))->sliceStep();
+        if(newStep < step)
+            step = newStep;
+    }
+
+    return step;
+}
+
 // The 'updateHounsfield' method
 void MergedSeriesViewer::updateHounsfield(ViewConfiguration const& config)
 {
-    repaint();
+    scheduleRender();
 }
 
 // The 'updateColormap' method
 void MergedSeriesViewer::updateColormap(ViewConfiguration const& config)
 {
-    repaint();
+    scheduleRender();
 }
 
 // The 'updateTranslation' method
 void MergedSeriesViewer::updateTranslation(ViewConfiguration const& config)
 {
-    repaint();
+    scheduleRender();
 }
 
 // The 'updateRotation' method
 void MergedSeriesViewer::updateRotation(ViewConfiguration const& config)
 {
-    repaint();
+    scheduleRender();
 }
@@ -99,6 +99,14 @@ class MergedSeriesViewer : public Viewer
         //!
         virtual double maxSlice() const;
 
+        //!
+        //! \brief The sliceStep method returns the smallest distance between
+        //!        two consecutive slices of the series.
+        //!
+        //! \return The distance between two consecutive slices.
+        //!
+        virtual double sliceStep() const;
+
     protected:
         //!
         //! \brief The MergedSeriesViewer constructor initializes the viewer.
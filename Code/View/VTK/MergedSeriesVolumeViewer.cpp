@@ -37,12 +37,31 @@ using namespace std;
 
 // Constructor
 MergedSeriesVolumeViewer::MergedSeriesVolumeViewer() : MergedSeriesViewer()
-{}
+{
+    renderWindow()->GetInteractor()->SetInteractorStyle(vtkSmartPointer<vtkInteractorStyleTrackballCamera>::New());
+
+    // The quality of the volumes is lowered while the camera moves
+    m_levelOfDetail = new VolumeLevelOfDetail(renderWindow(), renderer(), this);
+}
 
 // Destructor
 MergedSeriesVolumeViewer::~MergedSeriesVolumeViewer()
 {}
 
+// The 'linkSeriesViewer' method
+void MergedSeriesVolumeViewer::linkSeriesViewer(SeriesViewer* seriesViewer)
+{
+    MergedSeriesViewer::linkSeriesViewer(seriesViewer);
+    m_levelOfDetail->addMapper(dynamic_cast<SeriesVolumeViewer*>(seriesViewer)->mapper());
+}
+
+// The 'unlinkSeriesViewer' method
+void MergedSeriesVolumeViewer::unlinkSeriesViewer(SeriesViewer* seriesViewer)
+{
+    m_levelOfDetail->removeMapper(dynamic_cast<SeriesVolumeViewer*>(seriesViewer)->mapper());
+    MergedSeriesViewer::unlinkSeriesViewer(seriesViewer);
+}
+
 // The 'enableMip' slot
 void MergedSeriesVolumeViewer::enableMip(bool enable)
 {
@@ -50,5 +69,5 @@ void MergedSeriesVolumeViewer::enableMip(bool enable)
         dynamic_cast<SeriesVolumeViewer*>(m_seriesViewers.at(i))->enableMip(enable);
 
     renderer()->ResetCameraClippingRange();
-    repaint();
+    scheduleRender();
 }
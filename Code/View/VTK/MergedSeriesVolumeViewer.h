@@ -36,13 +36,20 @@
 #ifndef MERGEDSERIESVOLUMEVIEWER_H
 #define MERGEDSERIESVOLUMEVIEWER_H
 
+#include <vtkSmartPointer.h>
+#include <vtkInteractorStyleTrackballCamera.h>
+
 #include "MergedSeriesViewer.h"
 #include "SeriesVolumeViewer.h"
+#include "VolumeLevelOfDetail.h"
 
 //!
 //! @brief The MergedSeriesVolumeViewer class represents a specific widget to
 //!        visualize multiple SeriesData volume objects.
 //!
+//! The viewer moves the camera like the SeriesVolumeViewer, and lowers the
+//! quality of all the volumes while the camera moves.
+//!
 class MergedSeriesVolumeViewer : public MergedSeriesViewer
 {
     Q_OBJECT
@@ -51,6 +58,32 @@ class MergedSeriesVolumeViewer : public MergedSeriesViewer
         MergedSeriesVolumeViewer();
         ~MergedSeriesVolumeViewer();
 
+        //!
+        //! \brief The linkSeriesViewer method adds the volume of a series
+        //!        viewer to the viewer.
+        //!
+        //! This is a redefinition of the MergedSeriesViewer::linkSeriesViewer()
+        //! method.
+        //!
+        //! \param seriesViewer The series viewer to link.
+        //!
+        //! \return Nothing.
+        //!
+        void linkSeriesViewer(SeriesViewer* seriesViewer);
+
+        //!
+        //! \brief The unlinkSeriesViewer method removes the volume of a series
+        //!        viewer from the viewer.
+        //!
+        //! This is a redefinition of the
+        //! MergedSeriesViewer::unlinkSeriesViewer() method.
+        //!
+        //! \param seriesViewer The series viewer to unlink.
+        //!
+        //! \return Nothing.
+        //!
+        void unlinkSeriesViewer(SeriesViewer* seriesViewer);
+
     public slots:
         //!
         //! \brief The enableMip slot enable or disable the maximum intensity
@@ -62,6 +95,9 @@ class MergedSeriesVolumeViewer : public MergedSeriesViewer
         //! \return Nothing.
         //!
         void enableMip(bool enable);
+
+    private:
+        VolumeLevelOfDetail* m_levelOfDetail; // Owned as a child
 };
 
 #endif
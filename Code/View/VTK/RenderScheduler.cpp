@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RenderScheduler.cpp
+//! \brief The RenderScheduler.cpp file contains the definition of non-inline
+//!        methods of the RenderScheduler class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "RenderScheduler.h"
+#include "Viewer.h"
+using namespace std;
+
+RenderScheduler* RenderScheduler::s_renderScheduler = 0;
+
+// Constructor
+RenderScheduler::RenderScheduler() : QObject()
+{
+    m_frameTimer.setSingleShot(true);
+    connect(&m_frameTimer, SIGNAL(timeout()), this, SLOT(renderFrame()));
+}
+
+// The 'instance' static method
+RenderScheduler* RenderScheduler::instance()
+{
+    if(s_renderScheduler == 0)
+        s_renderScheduler = new RenderScheduler();
+
+    return s_renderScheduler;
+}
+
+// The 'scheduleRender' method
+void RenderScheduler::scheduleRender(Viewer* viewer)
+{
+    m_dirtyViewers.insert(viewer);
+    if(m_frameTimer.isActive())
+        return;
+
+    // Render as soon as possible, but not twice in the same frame
+    int wait = 0;
+    if(m_lastFrame.isValid())
+        wait = max(0, s_framePeriod - m_lastFrame.elapsed());
+    m_frameTimer.start(wait);
+}
+
+// The 'forget' method
+void RenderScheduler::forget(Viewer* viewer)
+{
+    m_dirtyViewers.erase(viewer);
+}
+
+// The 'renderFrame' slot
+void RenderScheduler::renderFrame()
+{
+    m_lastFrame.start();
+
+    // Apply the updates first, as a viewer may show the props of the others
+    // (the fused views), and they may ask for more renders
+    set<Viewer*> frame;
+    while(!m_dirtyViewers.empty())
+    {
+        set<Viewer*> viewers;
+        viewers.swap(m_dirtyViewers);
+        for(set<Viewer*>::iterator it = viewers.begin() ; it != viewers.end() ; ++it)
+        {
+            (*it)->applyPendingUpdates();
+            frame.insert(*it);
+        }
+    }
+
+    for(set<Viewer*>::iterator it = frame.begin() ; it != frame.end() ; ++it)
+        (*it)->render();
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file RenderScheduler.h
+//! \brief The RenderScheduler.h file contains the interface of the
+//!        RenderScheduler class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <iostream>
+#include <set>
+
+#include <QObject>
+#include <QTime>
+#include <QTimer>
+
+class Viewer;
+
+//!
+//! \brief The RenderScheduler class renders the viewers which need it at most
+//!        once per display frame.
+//!
+//! Instead of rendering at once, the viewers ask the scheduler for a render.
+//! At the next frame, the scheduler first applies the updates the viewers
+//! have kept meanwhile (only the last one of each view parameter), then
+//! renders each of them once. Dragging a slider then costs one render per
+//! frame instead of one per move.
+//!
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The instance static method returns the scheduler, and creates
+        //!        it if it does not exist yet.
+        //!
+        //! \return The scheduler.
+        //!
+        static RenderScheduler* instance();
+
+        //!
+        //! \brief The scheduleRender method asks for a render of a viewer at
+        //!        the next frame.
+        //!
+        //! \param viewer The viewer to render.
+        //!
+        //! \return Nothing.
+        //!
+        void scheduleRender(Viewer* viewer);
+
+        //!
+        //! \brief The forget method cancels the render of a viewer which is
+        //!        destroyed.
+        //!
+        //! \param viewer The destroyed viewer.
+        //!
+        //! \return Nothing.
+        //!
+        void forget(Viewer* viewer);
+
+    private slots:
+        //!
+        //! \brief The renderFrame slot applies the kept updates of the viewers
+        //!        which need a render, then renders them.
+        //!
+        //! \return Nothing.
+        //!
+        void renderFrame();
+
+    private:
+        //!
+        //! \brief The RenderScheduler constructor.
+        //!
+        RenderScheduler();
+
+        static RenderScheduler* s_renderScheduler;
+        static int const s_framePeriod = 16; // In ms (about 60 frames per second)
+
+        std::set<Viewer*> m_dirtyViewers; // The viewers to render at the next frame
+        QTimer m_frameTimer;
+        QTime m_lastFrame;                // Restarted at each frame
+};
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesDisplayMapping.cpp
+//! \brief The SeriesDisplayMapping.cpp file contains the definition of
+//!        non-inline methods of the SeriesDisplayMapping class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SeriesDisplayMapping.h"
+using namespace std;
+
+// Static attributes
+map<SeriesData const*, SeriesDisplayMapping*> SeriesDisplayMapping::s_mappings;
+unsigned int SeriesDisplayMapping::s_lastVersion = 0;
+
+// Constructor
+SeriesDisplayMapping::SeriesDisplayMapping(SeriesData const* series, bool denseTable)
+    : m_series(series), m_userCount(0), m_denseTable(denseTable), m_version(0),
+      m_computed(false), m_colormapVersion(0)
+{
+    m_colorFunction.TakeReference(vtkColorTransferFunction::New());
+}
+
+// The 'acquire' static method
+SeriesDisplayMapping* SeriesDisplayMapping::acquire(SeriesData const* series)
+{
+    map<SeriesData const*, SeriesDisplayMapping*>::iterator it = s_mappings.find(series);
+    if(it == s_mappings.end())
+        it = s_mappings.insert(make_pair(series, new SeriesDisplayMapping(series))).first;
+
+    it->second->m_userCount++;
+    return it->second;
+}
+
+// The 'release' static method
+void SeriesDisplayMapping::release(SeriesData const* series)
+{
+    map<SeriesData const*, SeriesDisplayMapping*>::iterator it = s_mappings.find(series);
+    if(it == s_mappings.end())
+        return;
+
+    if(--it->second->m_userCount <= 0)
+    {
+        delete it->second;
+        s_mappings.erase(it);
+    }
+}
+
+// The 'update' method
+bool SeriesDisplayMapping::update(ViewConfiguration const& config)
+{
+    Range const& hounsfield = config.hounsfield();
+    Range const& maxRange = config.hounsfieldMaxRange();
+    unsigned int colormapVersion = config.colormap().version();
+
+    if(m_computed && m_colormapVersion == colormapVersion
+       && m_hounsfield == hounsfield && m_hounsfieldMaxRange == maxRange)
+        return false;
+
+    // Add hounsfield boundaries in a custom colormap
+    Range huRange(m_series->convertFromHU(maxRange.min()),
+                  m_series->convertFromHU(maxRange.max()));
+
+    // Compute color transfert function
+    Range hu(m_series->convertFromHU(hounsfield.min()),
+             m_series->convertFromHU(hounsfield.max()));
+    vtkSmartPointer<vtkColorTransferFunction> func;
+    func.TakeReference(config.colormap().computeVTKColorTransferFunction(huRange, hu));
+    m_colorFunction->DeepCopy(func);
+
+    // The series stored on 8 or 16 bits get one color per stored value
+    int firstValue = 0, valueCount = 0;
+    switch(const_cast<SeriesData*>(m_series)->GetScalarType())
+    {
+        case VTK_CHAR:
+        case VTK_SIGNED_CHAR:
+            firstValue = -128;
+            valueCount = 256;
+            break;
+
+        case VTK_UNSIGNED_CHAR:
+            valueCount = 256;
+            break;
+
+        case VTK_SHORT:
+            firstValue = -32768;
+            valueCount = 65536;
+            break;
+
+        case VTK_UNSIGNED_SHORT:
+            valueCount = 65536;
+            break;
+    }
+
+    if(valueCount > 0 && m_denseTable)
+        m_kernel.compileDense(config.colormap(), huRange, hu, firstValue, valueCount);
+    else
+        m_kernel.compile(m_colorFunction, m_series->rescaleSlope(),
+                         m_series->rescaleIntercept(), hounsfield, maxRange);
+    m_version = ++s_lastVersion;
+
+    m_computed = true;
+    m_colormapVersion = colormapVersion;
+    m_hounsfield = hounsfield;
+    m_hounsfieldMaxRange = maxRange;
+
+    return true;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SeriesDisplayMapping.h
+//! \brief The SeriesDisplayMapping.h file contains the interface of the
+//!        SeriesDisplayMapping class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SERIESDISPLAYMAPPING_H
+#define SERIESDISPLAYMAPPING_H
+
+#include <map>
+
+#include <vtkSmartPointer.h>
+#include <vtkColorTransferFunction.h>
+
+#include "Model/SeriesData.h"
+#include "Model/ViewConfiguration.h"
+#include "Model/Range.h"
+#include "Model/WindowLevelKernel.h"
+
+//!
+//! \brief The SeriesDisplayMapping class holds the color transfer function
+//!        which maps the voxels of a series to colors.
+//!
+//! There is one mapping per series, shared by all the viewers of this series
+//! (the three slice viewers, the volume viewer and the fused views which reuse
+//! them). The function is only computed again when the colormap or the
+//! hounsfield window really changed, and every viewer sees the new function
+//! as they all use the same VTK object.
+//!
+//! The mapping also compiles the function in a WindowLevelKernel, with which
+//! the slice viewers color their slice. For the series stored on 8 or 16 bits,
+//! the kernel gets a dense table with one color per stored value, which is
+//! therefore cached by colormap version and hounsfield window. A mapping
+//! updated at each frame, like the preview of a window drag, rather compiles
+//! the kernel on the hounsfield values (with the AVX2 or SSE2 rows), which is
+//! much cheaper than filling the 65536 entries of a 16-bit table.
+//!
+class SeriesDisplayMapping
+{
+    public:
+        //!
+        //! \brief The SeriesDisplayMapping constructor creates a mapping which
+        //!        is not shared.
+        //!
+        //! The mappings shared by the viewers are given by the acquire()
+        //! method. A mapping created directly belongs to its creator, like the
+        //! preview of a slice viewer while the hounsfield window is dragged.
+        //!
+        //! \param series The series to map.
+        //! \param denseTable A boolean which is false if the kernel must not
+        //!                   use a dense table, because the window changes
+        //!                   at each frame.
+        //!
+        SeriesDisplayMapping(SeriesData const* series, bool denseTable = true);
+
+        //!
+        //! \brief The acquire static method returns the mapping of a series,
+        //!        and creates it if it does not exist yet.
+        //!
+        //! Each call must be balanced by a call to the release() method.
+        //!
+        //! \param series The series to map.
+        //!
+        //! \return The mapping of the series.
+        //!
+        static SeriesDisplayMapping* acquire(SeriesData const* series);
+
+        //!
+        //! \brief The release static method releases the mapping of a series,
+        //!        which is destroyed when no viewer uses it anymore.
+        //!
+        //! \param series The mapped series.
+        //!
+        //! \return Nothing.
+        //!
+        static void release(SeriesData const* series);
+
+        //!
+        //! \brief The colorFunction method returns the color transfer function
+        //!        shared by the viewers of the series.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The shared color transfer function.
+        //!
+        inline vtkColorTransferFunction* colorFunction() const;
+
+        //!
+        //! \brief The kernel method returns the kernel which applies the color
+        //!        transfer function to rows of voxels.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The kernel compiled from the color transfer function.
+        //!
+        inline WindowLevelKernel const& kernel() const;
+
+        //!
+        //! \brief The version method returns a number which changes each time
+        //!        the function is computed again.
+        //!
+        //! The versions are unique among all the mappings, so that an image
+        //! colored by another mapping is never taken as up to date.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The version of the mapping (0 before the first update).
+        //!
+        inline unsigned int version() const;
+
+        //!
+        //! \brief The update method computes the color transfer function
+        //!        according to the colormap and the hounsfield window of a
+        //!        ViewConfiguration.
+        //!
+        //! Nothing is done if the same colormap and the same hounsfield window
+        //! have already been applied.
+        //!
+        //! \param config The ViewConfiguration object to work on.
+        //!
+        //! \return True if the function changed, false otherwise.
+        //!
+        bool update(ViewConfiguration const& config);
+
+    private:
+        static std::map<SeriesData const*, SeriesDisplayMapping*> s_mappings;
+        static unsigned int s_lastVersion; // The last given version
+
+        SeriesData const* m_series;
+        int m_userCount;
+        bool m_denseTable; // False if the window changes at each frame
+
+        vtkSmartPointer<vtkColorTransferFunction> m_colorFunction;
+        WindowLevelKernel m_kernel;
+        unsigned int m_version;
+
+        // The parameters of the last computation
+        bool m_computed;
+        unsigned int m_colormapVersion;
+        Range m_hounsfield, m_hounsfieldMaxRange;
+};
+
+// The 'colorFunction' method
+inline vtkColorTransferFunction* SeriesDisplayMapping::colorFunction() const
+{ return m_colorFunction; }
+
+// The 'kernel' method
+inline WindowLevelKernel const& SeriesDisplayMapping::kernel() const
+{ return m_kernel; }
+
+// The 'version' method
+inline unsigned int SeriesDisplayMapping::version() const { return m_version; }
+
+#endif
@@ -38,7 +38,10 @@ using namespace customwidget;
 
 // Constructor
 SeriesSliceViewer::SeriesSliceViewer(SeriesData* series, SliceOrientation orientation)
-    : SeriesViewer(series), m_orientation(orientation), m_sliceOffset(0), m_currentSlice(0)
+    : SeriesViewer(series), m_mappedVersion(0), m_oblique(false), m_slabMode(SLAB_NONE),
+      m_slabThickness(10), m_prefetcher(0), m_orientation(orientation),
+      m_sliceOffset(0), m_currentSlice(0), m_slicePending(false),
+      m_previewMapping(0), m_windowLevelPending(false)
 {
     // Create the vtkProp3D (ImageActor)
     vtkImageActor* imageActor = vtkImageActor::New();
@@ -48,19 +51,19 @@ SeriesSliceViewer::SeriesSliceViewer(SeriesData* series, SliceOrientation orient
     renderer()->AddViewProp(m_vtkProp3D);
     renderWindow()->GetInteractor()->SetInteractorStyle(vtkSmartPointer<vtkInteractorStyleImage>::New());
 
-    // Custom properties
-    m_colorFunction.TakeReference(vtkColorTransferFunction::New());
+    // The color function is shared with the other viewers of the series
+    m_sharedMapping = SeriesDisplayMapping::acquire(series);
+    m_mapping = m_sharedMapping;
 
-    // Create the mapper
-    m_vtkMapper = vtkImageMapToRGBA::New();
-    m_vtkMapper->SetOutputFormatToRGBA();
-    m_vtkMapper->PassAlphaToOutputOn();
-    m_vtkMapper->SetInput(series);
-    m_vtkMapper->SetLookupTable(m_colorFunction);
-    imageActor->SetInput(m_vtkMapper->GetOutput());
+    // Create the colored slice, which is filled by the display mapping
+    m_sliceImage = vtkSmartPointer<vtkImageData>::New();
+    m_sliceImage->SetScalarTypeToUnsignedChar();
+    m_sliceImage->SetNumberOfScalarComponents(4);
+    imageActor->SetInput(m_sliceImage);
 
     // Update camera
     int* ext = series->GetExtent();
+    copy(ext, ext + 6, m_seriesExtent);
     vtkCamera* camera = renderer()->GetActiveCamera();
     camera->ParallelProjectionOn();
     double* bound = series->GetBounds();
@@ -74,6 +77,8 @@ SeriesSliceViewer::SeriesSliceViewer(SeriesData* series, SliceOrientation orient
             imageActor->SetDisplayExtent(0, 0, ext[2], ext[3], ext[4], ext[5]);
             m_sliceRange.min() = bound[0];
             m_sliceRange.max() = bound[1];
+            m_sliceIndexRange.min() = ext[0];
+            m_sliceIndexRange.max() = ext[1];
             break;
 
         case FRONTAL:
@@ -83,6 +88,8 @@ SeriesSliceViewer::SeriesSliceViewer(SeriesData* series, SliceOrientation orient
             imageActor->SetDisplayExtent(ext[0], ext[1], 0, 0, ext[4], ext[5]);
             m_sliceRange.min() = bound[2];
             m_sliceRange.max() = bound[3];
+            m_sliceIndexRange.min() = ext[2];
+            m_sliceIndexRange.max() = ext[3];
             break;
 
         case TRANSVERSE:
@@ -92,17 +99,30 @@ SeriesSliceViewer::SeriesSliceViewer(SeriesData* series, SliceOrientation orient
             imageActor->SetDisplayExtent(ext[0], ext[1], ext[2], ext[3], 0, 0);
             m_sliceRange.min() = bound[4];
             m_sliceRange.max() = bound[5];
+            m_sliceIndexRange.min() = ext[4];
+            m_sliceIndexRange.max() = ext[5];
             break;
     }
     renderer()->ResetCamera();
 
-    m_sliceIndexRange.min() = imageActor->GetSliceNumberMin();
-    m_sliceIndexRange.max() = imageActor->GetSliceNumberMax();
+    // Loading notice
+    m_sliceCount = ext[5] - ext[4] + 1;
+    m_loadingText = vtkSmartPointer<vtkTextActor>::New();
+    m_loadingText->GetTextProperty()->SetFontSize(14);
+    m_loadingText->GetTextProperty()->SetColor(1.0, 0.6, 0.0);
+    m_loadingText->SetDisplayPosition(10, 10);
+    m_loadingText->VisibilityOff();
+    renderer()->AddActor2D(m_loadingText);
+    updateLoadingNotice();
 }
 
 // Destructor
 SeriesSliceViewer::~SeriesSliceViewer()
-{}
+{
+    delete m_prefetcher;
+    delete m_previewMapping;
+    SeriesDisplayMapping::release(m_series);
+}
 
 // The 'minSlice' method
 double SeriesSliceViewer::minSlice() const
@@ -116,12 +136,69 @@ double SeriesSliceViewer::maxSlice() const
     return m_sliceRange.max();
 }
 
+// The 'sliceStep' method
+double SeriesSliceViewer::sliceStep() const
+{
+    return m_sliceRange.size() / max(1.0, m_sliceIndexRange.size());
+}
+
 // The 'getPropOpacity' method
 double SeriesSliceViewer::getPropOpacity() const
 {
     return dynamic_cast<vtkImageActor*>(m_vtkProp3D)->GetOpacity();
 }
 
+// The 'sliceImage' method
+vtkImageData* SeriesSliceViewer::sliceImage() const
+{
+    return m_sliceImage;
+}
+
+// The 'kernel' method
+WindowLevelKernel const& SeriesSliceViewer::kernel() const
+{
+    return m_mapping->kernel();
+}
+
+// The 'displayedPlanes' method
+bool SeriesSliceViewer::displayedPlanes(int& first, int& last) const
+{
+    if(m_oblique)
+        return false;
+
+    int axis = m_orientation;
+    int extent[6];
+    dynamic_cast<vtkImageActor*>(m_vtkProp3D)->GetDisplayExtent(extent);
+    first = last = extent[2*axis];
+    if(m_slabMode == SLAB_NONE)
+        return true;
+
+    // The slab is centered on the displayed slice
+    double spacing = const_cast<SeriesData*>(m_series)->GetSpacing()[axis];
+    int planeCount = static_cast<int>(floor(0.5 + m_slabThickness / spacing));
+    if(planeCount < 1)
+        planeCount = 1;
+    first = extent[2*axis] - (planeCount - 1) / 2;
+    last = first + planeCount - 1;
+    return true;
+}
+
+// The 'seriesTransform' method
+void SeriesSliceViewer::seriesTransform(vtkMatrix4x4* matrix) const
+{
+    // The rotation around the origin of the prop, then the translation
+    double* center = m_vtkProp3D->GetOrigin();
+    vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
+    transform->PostMultiply();
+    transform->Translate(-center[0], -center[1], -center[2]);
+    transform->RotateY(m_rotation.y());
+    transform->RotateX(m_rotation.x());
+    transform->RotateZ(m_rotation.z());
+    transform->Translate(center[0], center[1], center[2]);
+    transform->Translate(m_translation.x(), m_translation.y(), m_translation.z());
+    transform->GetMatrix(matrix);
+}
+
 // The 'setPropOpacity' method
 void SeriesSliceViewer::setPropOpacity(double opacity)
 {
@@ -131,11 +208,90 @@ void SeriesSliceViewer::setPropOpacity(double opacity)
 // The 'changeCurrentSlice' slot
 void SeriesSliceViewer::changeCurrentSlice(double value)
 {
+    // Only the last slice asked before the next frame is shown
     m_currentSlice = value;
-    value -= m_sliceOffset; // TODO maybe update slider ranges in subinterface could be useful (but not required)
+    m_slicePending = true;
+    scheduleRender();
+}
+
+// The 'applyPendingUpdates' method
+void SeriesSliceViewer::applyPendingUpdates()
+{
+    Viewer::applyPendingUpdates();
+
+    // Only the last window dragged before the frame is previewed
+    if(m_windowLevelPending && m_previewMapping)
+        m_previewMapping->update(m_previewConfig);
+
+    if(m_slicePending)
+        showCurrentSlice();
+    else if(m_windowLevelPending)
+        updateSliceImage();
+    m_windowLevelPending = false;
+}
+
+// The 'startWindowLevel' method
+bool SeriesSliceViewer::startWindowLevel()
+{
+    if(m_previewMapping || !m_sharedMapping->kernel().isCompiled())
+        return false;
+
+    // The slice is colored by a mapping of its own until the drag ends, with
+    // a kernel which is quick to compile again at each frame
+    m_previewMapping = new SeriesDisplayMapping(m_series, false);
+    m_mapping = m_previewMapping;
+    m_previewConfig = m_config;
+    m_previewMapping->update(m_previewConfig);
+    m_dragStart = m_config.hounsfield();
+
+    return true;
+}
+
+// The 'dragWindowLevel' method
+Range SeriesSliceViewer::dragWindowLevel(int dx, int dy)
+{
+    if(!m_previewMapping)
+        return m_config.hounsfield();
+
+    // The horizontal moves change the width of the window, the vertical ones
+    // its center, by about 1/1000 of the maximum range per pixel
+    Range const& maxRange = m_config.hounsfieldMaxRange();
+    double sensitivity = maxRange.size() / 1000.0;
+    double width = max(1.0, m_dragStart.size() + dx * sensitivity);
+    double center = (m_dragStart.min() + m_dragStart.max()) / 2 + dy * sensitivity;
+    Range hounsfield(maxRange.bound(center - width / 2), maxRange.bound(center + width / 2));
+
+    m_previewConfig.setHounsfield(hounsfield, maxRange);
+    m_windowLevelPending = true;
+    scheduleRender();
+
+    return hounsfield;
+}
+
+// The 'finishWindowLevel' method
+Range SeriesSliceViewer::finishWindowLevel()
+{
+    Range hounsfield = m_previewConfig.hounsfield();
+    if(!m_previewMapping)
+        return hounsfield;
+
+    // The preview stays shown until the new window reaches the shared mapping
+    m_mapping = m_sharedMapping;
+    delete m_previewMapping;
+    m_previewMapping = 0;
+    m_windowLevelPending = false;
+
+    return hounsfield;
+}
+
+// The 'showCurrentSlice' method
+void SeriesSliceViewer::showCurrentSlice()
+{
+    m_slicePending = false;
+    double value = m_currentSlice - m_sliceOffset; // TODO maybe update slider ranges in subinterface could be useful (but not required)
 
     vtkImageActor* actor = dynamic_cast<vtkImageActor*>(m_vtkProp3D);
-    int* ext = actor->GetDisplayExtent();
+    int* ext = m_seriesExtent;
 
     if(value < minSlice() || value > maxSlice())
         actor->VisibilityOff();
@@ -157,10 +313,24 @@ void SeriesSliceViewer::changeCurrentSlice(double value)
                 actor->SetDisplayExtent(ext[0], ext[1], ext[2], ext[3], slice, slice);
                 break;
         }
+        if(!showPrefetchedSlice(slice))
+            updateSliceImage();
     }
 
+    updateLoadingNotice();
+
     renderer()->ResetCameraClippingRange();
-    repaint();
+}
+
+// The 'refreshLoadedSlices' slot
+void SeriesSliceViewer::refreshLoadedSlices()
+{
+    m_slabReducer.invalidate();
+    if(m_prefetcher)
+        m_prefetcher->clear();
+    updateSliceImage();
+    updateLoadingNotice();
+    scheduleRender();
 }
 
 // The 'updateHounsfield' method
@@ -172,23 +342,19 @@ void SeriesSliceViewer::updateHounsfield(ViewConfiguration const& config)
 // The 'updateColormap' method
 void SeriesSliceViewer::updateColormap(ViewConfiguration const& config)
 {
-    // Add hounsfield boundaries in a custom colormap
-    Range maxRange = config.hounsfieldMaxRange();
-    Range huRange(m_series->convertFromHU(maxRange.min()),
-                  m_series->convertFromHU(maxRange.max()));
+    m_config = config;
+    m_sharedMapping->update(config); // Shared with the other viewers of the series
 
-    // Compute color transfert function
-    Range hu(m_series->convertFromHU(config.hounsfield().min()),
-             m_series->convertFromHU(config.hounsfield().max()));
-    vtkSmartPointer<vtkColorTransferFunction> func;
-    func.TakeReference(config.colormap().computeVTKColorTransferFunction(huRange, hu));
-    m_colorFunction->DeepCopy(func);
+    // Another viewer of the series may already have updated the mapping
+    if(m_mapping->version() != m_mappedVersion)
+        updateSliceImage();
 }
 
 // The 'updateTranslation' method
 void SeriesSliceViewer::updateTranslation(ViewConfiguration const& config)
 {
     double* position = m_vtkProp3D->GetPosition();
+    m_translation = config.translation();
 
     switch(m_orientation)
     {
@@ -211,21 +377,248 @@ void SeriesSliceViewer::updateTranslation(ViewConfiguration const& config)
     changeCurrentSlice(m_currentSlice);
 }
 
+// The 'updateLoadingNotice' method
+void SeriesSliceViewer::updateLoadingNotice()
+{
+    int loaded = m_series->loadedSliceCount();
+    if(loaded >= m_sliceCount)
+    {
+        m_loadingText->VisibilityOff();
+        return;
+    }
+
+    QString notice;
+    if(m_series->isLoading())
+        notice = QString("Chargement : %1 / %2 coupes").arg(loaded).arg(m_sliceCount);
+    else
+        notice = QString("%1 coupes manquantes").arg(m_sliceCount - loaded);
+
+    // In the transverse orientation, the visualized slice is a single plane
+    vtkImageActor* actor = dynamic_cast<vtkImageActor*>(m_vtkProp3D);
+    if(m_orientation == TRANSVERSE && !m_oblique && actor->GetVisibility()
+       && !m_series->isSliceLoaded(actor->GetDisplayExtent()[4]))
+        notice += " (coupe courante manquante)";
+
+    m_loadingText->SetInput(notice.toUtf8().constData());
+    m_loadingText->VisibilityOn();
+}
+
+// The 'updateSliceImage' method
+void SeriesSliceViewer::updateSliceImage()
+{
+    WindowLevelKernel const& kernel = m_mapping->kernel();
+    if(!kernel.isCompiled())
+        return;
+
+    if(m_oblique)
+    {
+        updateObliqueImage();
+        return;
+    }
+
+    // The image follows the displayed extent, and is only allocated again
+    // when its size changes
+    int extent[6];
+    dynamic_cast<vtkImageActor*>(m_vtkProp3D)->GetDisplayExtent(extent);
+    vtkImageData* series = const_cast<SeriesData*>(m_series);
+    m_sliceImage->SetSpacing(series->GetSpacing());
+    m_sliceImage->SetOrigin(series->GetOrigin());
+    vtkDataArray* scalars = m_sliceImage->GetPointData()->GetScalars();
+    vtkIdType pointCount = static_cast<vtkIdType>(extent[1] - extent[0] + 1)
+                         * (extent[3] - extent[2] + 1) * (extent[5] - extent[4] + 1);
+    m_sliceImage->SetExtent(extent);
+    if(!scalars || scalars->GetNumberOfTuples() != pointCount)
+        m_sliceImage->AllocateScalars();
+
+    unsigned char* out = static_cast<unsigned char*>(m_sliceImage->GetScalarPointer());
+    if(m_slabMode != SLAB_NONE)
+    {
+        int first, last;
+        displayedPlanes(first, last);
+        m_slabReducer.reduce(series, m_orientation, m_slabMode, first, last, kernel, out);
+    }
+    else
+    {
+        kernel.mapSlice(series, extent, out);
+    }
+
+    m_sliceImage->Modified();
+    m_mappedVersion = m_mapping->version();
+}
+
+// The 'updateObliqueImage' method
+void SeriesSliceViewer::updateObliqueImage()
+{
+    vtkImageData* series = const_cast<SeriesData*>(m_series);
+    int a = m_orientation;                  // The view axis
+    int b = (m_orientation == SAGITTAL) ? 1 : 0;   // The axis of the rows
+    int c = (m_orientation == TRANSVERSE) ? 1 : 2; // The axis of the columns
+
+    // The rotation of the volume viewer, around the origin of the prop
+    double* center = m_vtkProp3D->GetOrigin();
+    vtkSmartPointer<vtkTransform> rotation = vtkSmartPointer<vtkTransform>::New();
+    rotation->PostMultiply();
+    rotation->Translate(-center[0], -center[1], -center[2]);
+    rotation->RotateY(m_rotation.y());
+    rotation->RotateX(m_rotation.x());
+    rotation->RotateZ(m_rotation.z());
+    rotation->Translate(center[0], center[1], center[2]);
+
+    // The image covers the rotated series on the plane axes
+    double* bounds = series->GetBounds();
+    double low[3], high[3];
+    for(int corner = 0 ; corner < 8 ; corner++)
+    {
+        double point[3] = { bounds[corner & 1], bounds[2 + ((corner >> 1) & 1)],
+                            bounds[4 + ((corner >> 2) & 1)] };
+        rotation->TransformPoint(point, point);
+        for(int i = 0 ; i < 3 ; i++)
+        {
+            low[i] = (corner == 0 || point[i] < low[i]) ? point[i] : low[i];
+            high[i] = (corner == 0 || point[i] > high[i]) ? point[i] : high[i];
+        }
+    }
+
+    double* spacing = series->GetSpacing();
+    double pixel = min(spacing[0], min(spacing[1], spacing[2]));
+    int width = static_cast<int>(ceil((high[b] - low[b]) / pixel)) + 1;
+    int height = static_cast<int>(ceil((high[c] - low[c]) / pixel)) + 1;
+
+    // The image lies in the plane of the viewer, at the current position
+    int extent[6] = { 0, 0, 0, 0, 0, 0 };
+    extent[2*b+1] = width - 1;
+    extent[2*c+1] = height - 1;
+    double origin[3];
+    origin[a] = m_currentSlice - m_sliceOffset;
+    origin[b] = low[b];
+    origin[c] = low[c];
+
+    vtkDataArray* scalars = m_sliceImage->GetPointData()->GetScalars();
+    m_sliceImage->SetSpacing(pixel, pixel, pixel);
+    m_sliceImage->SetOrigin(origin);
+    m_sliceImage->SetExtent(extent);
+    if(!scalars || scalars->GetNumberOfTuples() != static_cast<vtkIdType>(width) * height)
+        m_sliceImage->AllocateScalars();
+    dynamic_cast<vtkImageActor*>(m_vtkProp3D)->SetDisplayExtent(extent);
+
+    // The pixels are brought back in the series by the inverse rotation
+    vtkLinearTransform* inverse = rotation->GetLinearInverse();
+    double first[3], rowStep[3], columnStep[3], point[3];
+    inverse->TransformPoint(origin, first);
+
+    copy(origin, origin + 3, point);
+    point[b] += pixel;
+    inverse->TransformPoint(point, rowStep);
+
+    copy(origin, origin + 3, point);
+    point[c] += pixel;
+    inverse->TransformPoint(point, columnStep);
+
+    for(int i = 0 ; i < 3 ; i++)
+    {
+        rowStep[i] -= first[i];
+        columnStep[i] -= first[i];
+    }
+
+    m_resampler.setPlane(first, rowStep, columnStep);
+    m_resampler.resample(series, width, height, m_mapping->kernel(),
+                         static_cast<unsigned char*>(m_sliceImage->GetScalarPointer()));
+
+    m_sliceImage->Modified();
+    m_mappedVersion = m_mapping->version();
+}
+
+// The 'enableOblique' slot
+void SeriesSliceViewer::enableOblique(bool enable)
+{
+    m_oblique = enable;
+    applyRotation();
+    changeCurrentSlice(m_currentSlice);
+}
+
+// The 'setSlabMode' slot
+void SeriesSliceViewer::setSlabMode(int mode)
+{
+    m_slabMode = static_cast<SlabMode>(mode);
+    updateSliceImage();
+    scheduleRender();
+}
+
+// The 'setSlabThickness' slot
+void SeriesSliceViewer::setSlabThickness(double thickness)
+{
+    m_slabThickness = thickness;
+    updateSliceImage();
+    scheduleRender();
+}
+
+// The 'enableCine' slot
+void SeriesSliceViewer::enableCine(bool enable)
+{
+    delete m_prefetcher;
+    m_prefetcher = 0;
+
+    if(enable)
+        m_prefetcher = new SlicePrefetcher(const_cast<SeriesData*>(m_series), m_orientation);
+}
+
+// The 'showPrefetchedSlice' method
+bool SeriesSliceViewer::showPrefetchedSlice(int slice)
+{
+    WindowLevelKernel const& kernel = m_mapping->kernel();
+    if(!m_prefetcher || m_oblique || m_slabMode != SLAB_NONE || !kernel.isCompiled())
+        return false;
+
+    vtkSmartPointer<vtkImageData> image = m_prefetcher->take(slice, m_mapping->version());
+
+    // Ask for the next slices, going back to the first one after the last
+    int first = static_cast<int>(m_sliceIndexRange.min());
+    int count = static_cast<int>(m_sliceIndexRange.size()) + 1;
+    vector<int> slices;
+    for(int i = 1 ; i <= s_prefetchCount && i < count ; i++)
+        slices.push_back(first + (slice - first + i) % count);
+    m_prefetcher->request(slices, kernel, m_mapping->version());
+
+    if(!image)
+        return false;
+
+    m_sliceImage = image;
+    dynamic_cast<vtkImageActor*>(m_vtkProp3D)->SetInput(m_sliceImage);
+    m_mappedVersion = m_mapping->version();
+    return true;
+}
+
 // The 'updateRotation' method
 void SeriesSliceViewer::updateRotation(ViewConfiguration const& config)
 {
+    m_rotation = config.rotation();
+    applyRotation();
+
+    if(m_oblique)
+        updateSliceImage();
+}
+
+// The 'applyRotation' method
+void SeriesSliceViewer::applyRotation()
+{
+    if(m_oblique)
+    {
+        m_vtkProp3D->SetOrientation(0, 0, 0);
+        return;
+    }
+
     switch(m_orientation)
     {
         case SAGITTAL:
-            m_vtkProp3D->SetOrientation(config.rotation().x(), 0, 0);
+            m_vtkProp3D->SetOrientation(m_rotation.x(), 0, 0);
             break;
 
         case FRONTAL:
-            m_vtkProp3D->SetOrientation(0, config.rotation().y(), 0);
+            m_vtkProp3D->SetOrientation(0, m_rotation.y(), 0);
             break;
 
         case TRANSVERSE:
-            m_vtkProp3D->SetOrientation(0, 0, config.rotation().z());
+            m_vtkProp3D->SetOrientation(0, 0, m_rotation.z());
             break;
     }
 }
@@ -37,23 +37,36 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include <QBoxLayout>
 
 #include <vtkSmartPointer.h>
 #include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
 #include <vtkRenderer.h>
 #include <vtkCamera.h>
 #include <vtkInteractorStyleImage.h>
 #include <vtkRenderWindow.h>
-#include <vtkImageMapToRGBA.h>
-#include <vtkColorTransferFunction.h>
+#include <vtkTransform.h>
+#include <vtkMatrix4x4.h>
 
 #include <vtkImageActor.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
 
 #include "View/Qt/customwidget/Widget.h"
 
+#include "Model/PlaneResampler.h"
+#include "Model/SlabReducer.h"
+#include "Model/Vector3D.h"
+
 #include "SeriesViewer.h"
+#include "SeriesDisplayMapping.h"
+#include "SlicePrefetcher.h"
 #include "main.h"
 
 //!
@@ -110,6 +123,63 @@ class SeriesSliceViewer : public SeriesViewer
         //!
         double maxSlice() const;
 
+        //!
+        //! \brief The sliceStep method returns the distance between two
+        //!        consecutive slices of the series in the internal orientation.
+        //!
+        //! This is a redefinition of the Viewer::sliceStep() method.
+        //!
+        //! \return The distance between two consecutive slices.
+        //!
+        double sliceStep() const;
+
+        //!
+        //! \brief The applyPendingUpdates method applies the updates kept since
+        //!        the last frame, and shows the last slice asked meanwhile.
+        //!
+        //! This is a redefinition of the Viewer::applyPendingUpdates() method.
+        //!
+        //! \return Nothing.
+        //!
+        void applyPendingUpdates();
+
+        //!
+        //! \brief The startWindowLevel method starts a drag of the hounsfield
+        //!        window on the slice.
+        //!
+        //! Until the drag ends, the slice is colored by a mapping of its own,
+        //! so that only this slice is colored again while the window moves.
+        //! No drag starts while the slice is not colored yet, or while another
+        //! drag runs.
+        //!
+        //! \return A boolean which is true if the drag has started.
+        //!
+        bool startWindowLevel();
+
+        //!
+        //! \brief The dragWindowLevel method moves the hounsfield window of the
+        //!        drag, which is shown at the next frame.
+        //!
+        //! \param dx The horizontal move since the start of the drag (in
+        //!           pixels), which widens the window.
+        //! \param dy The vertical move since the start of the drag (in pixels),
+        //!           which moves the center of the window.
+        //!
+        //! \return The hounsfield window of the drag.
+        //!
+        Range dragWindowLevel(int dx, int dy);
+
+        //!
+        //! \brief The finishWindowLevel method ends the drag of the hounsfield
+        //!        window.
+        //!
+        //! The slice uses the shared mapping again, and keeps the preview until
+        //! the returned window is applied to the views of the series.
+        //!
+        //! \return The hounsfield window of the drag.
+        //!
+        Range finishWindowLevel();
+
         //!
         //! \brief The getPropOpacity method returns the opacity of the VTK
         //!        slice the viewer is showing.
@@ -118,6 +188,55 @@ class SeriesSliceViewer : public SeriesViewer
         //!
         double getPropOpacity() const;
 
+        //!
+        //! \brief The sliceImage method returns the colored slice the viewer is
+        //!        showing.
+        //!
+        //! \return The colored slice (RGBA), placed by the VTK prop.
+        //!
+        vtkImageData* sliceImage() const;
+
+        //!
+        //! \brief The kernel method returns the kernel which colors the slice.
+        //!
+        //! \return The kernel of the display mapping in use.
+        //!
+        WindowLevelKernel const& kernel() const;
+
+        //!
+        //! \brief The slabMode method returns how the planes of the slab are
+        //!        combined.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The SlabMode of the slab.
+        //!
+        inline SlabMode slabMode() const;
+
+        //!
+        //! \brief The displayedPlanes method gives the planes of the series
+        //!        which are combined in the displayed slice.
+        //!
+        //! \param first The index of the first plane (the current plane if there
+        //!              is no slab).
+        //! \param last The index of the last plane.
+        //!
+        //! \return False in the oblique mode, where the slice is not made of
+        //!         planes of the series.
+        //!
+        bool displayedPlanes(int& first, int& last) const;
+
+        //!
+        //! \brief The seriesTransform method computes the rigid transform from
+        //!        the physical coordinates of the series to the scene, like the
+        //!        volume viewer places the series.
+        //!
+        //! \param matrix The matrix which receives the transform.
+        //!
+        //! \return Nothing.
+        //!
+        void seriesTransform(vtkMatrix4x4* matrix) const;
+
         //!
         //! \brief The setPropOpacity method sets the opacity of the VTK slice
         //!        the viewer is showing.
@@ -134,10 +253,71 @@ class SeriesSliceViewer : public SeriesViewer
         //! \brief The changeCurrentSlice method update the slice which is
         //!        currently visualized.
         //!
+        //! The slice is shown at the next frame.
+        //!
         //! \return Nothing.
         //!
         void changeCurrentSlice(double value);
 
+        //!
+        //! \brief The refreshLoadedSlices slot redraws the slice after new
+        //!        planes of the series have been loaded and updates the notice
+        //!        which indicates the missing planes.
+        //!
+        //! \return Nothing.
+        //!
+        void refreshLoadedSlices();
+
+        //!
+        //! \brief The enableOblique slot switches the viewer between the
+        //!        axis-aligned slices and the oblique slices.
+        //!
+        //! In the oblique mode, the slice is resampled on the plane the viewer
+        //! would show if the series was rotated like in the volume viewer,
+        //! instead of rotating the slice in its own plane.
+        //!
+        //! \param enable True to show oblique slices.
+        //!
+        //! \return Nothing.
+        //!
+        void enableOblique(bool enable);
+
+        //!
+        //! \brief The setSlabMode slot chooses how the planes of the slab
+        //!        around the current slice are combined.
+        //!
+        //! With SLAB_NONE, only the current slice is shown. The slab is not
+        //! used in the oblique mode.
+        //!
+        //! \param mode The SlabMode of the slab.
+        //!
+        //! \return Nothing.
+        //!
+        void setSlabMode(int mode);
+
+        //!
+        //! \brief The setSlabThickness slot changes the thickness of the slab.
+        //!
+        //! \param thickness The thickness of the slab (in mm).
+        //!
+        //! \return Nothing.
+        //!
+        void setSlabThickness(double thickness);
+
+        //!
+        //! \brief The enableCine slot starts or stops the coloring of the next
+        //!        slices in advance, for the cine playback.
+        //!
+        //! While the cine is enabled, the next axis-aligned slices are colored
+        //! on a worker thread, so that changing the slice only swaps the image
+        //! of the actor.
+        //!
+        //! \param enable True to color the next slices in advance.
+        //!
+        //! \return Nothing.
+        //!
+        void enableCine(bool enable);
+
     protected:
         //!
         //! \brief The updateHounsfield method updates the viewer according to
@@ -189,6 +369,7 @@ class SeriesSliceViewer : public SeriesViewer
         //!
         //! This is an implementation of the SeriesViewer::updateRotation()
         //! method.
+        //! In the oblique mode, the slice is resampled with the new rotation.
         //!
         //! \param config The ViewConfiguration object to work on.
         //!
@@ -197,15 +378,103 @@ class SeriesSliceViewer : public SeriesViewer
         void updateRotation(ViewConfiguration const& config);
 
     private:
-        // The vtk mapper and its properties
-        vtkImageMapToRGBA* m_vtkMapper;
-        vtkSmartPointer<vtkColorTransferFunction> m_colorFunction;
+        //!
+        //! \brief The updateLoadingNotice method shows, while the series is
+        //!        not completely loaded, how many of its planes are available
+        //!        and if the visualized slice is missing.
+        //!
+        //! \return Nothing.
+        //!
+        void updateLoadingNotice();
+
+        //!
+        //! \brief The updateSliceImage method colors the displayed slice of
+        //!        the series with the kernel of the display mapping.
+        //!
+        //! \return Nothing.
+        //!
+        void updateSliceImage();
+
+        //!
+        //! \brief The updateObliqueImage method resamples and colors the
+        //!        oblique slice at the current position.
+        //!
+        //! \return Nothing.
+        //!
+        void updateObliqueImage();
+
+        //!
+        //! \brief The applyRotation method orients the slice according to the
+        //!        last rotation (the oblique slices are not rotated, as the
+        //!        rotation is in their resampling).
+        //!
+        //! \return Nothing.
+        //!
+        void applyRotation();
+
+        //!
+        //! \brief The showPrefetchedSlice method shows the colored image of a
+        //!        slice if the prefetcher has it ready, and asks it for the next
+        //!        slices.
+        //!
+        //! \param slice The index of the shown slice.
+        //!
+        //! \return True if the prefetched image is shown, false if the slice
+        //!         must be colored.
+        //!
+        bool showPrefetchedSlice(int slice);
+
+        //!
+        //! \brief The showCurrentSlice method shows the slice at the current
+        //!        position.
+        //!
+        //! \return Nothing.
+        //!
+        void showCurrentSlice();
+
+        // The colored slice shown by the actor (only the displayed slice is
+        // colored)
+        vtkSmartPointer<vtkImageData> m_sliceImage;
+        SeriesDisplayMapping* m_mapping;       // The shared one or the preview
+        SeriesDisplayMapping* m_sharedMapping; // Shared by the viewers of the series
+        ViewConfiguration m_config;            // The last configuration applied
+        unsigned int m_mappedVersion;    // The mapping version of the slice
+
+        // The oblique mode
+        bool m_oblique;
+        PlaneResampler m_resampler;
+        Vector3D m_rotation;
+        Vector3D m_translation;
+
+        // The slab mode
+        SlabMode m_slabMode;
+        double m_slabThickness;
+        SlabReducer m_slabReducer;
+
+        // The cine playback (the next slices are colored in advance)
+        SlicePrefetcher* m_prefetcher; // Null when the cine is disabled
+        static int const s_prefetchCount = 8;
 
         SliceOrientation m_orientation;
 
+        int m_seriesExtent[6];
         Range m_sliceRange, m_sliceIndexRange;
         double m_sliceOffset;
         double m_currentSlice;
+        bool m_slicePending; // True if the current slice is not shown yet
+
+        // The drag of the hounsfield window
+        SeriesDisplayMapping* m_previewMapping; // Null when there is no drag
+        ViewConfiguration m_previewConfig;
+        Range m_dragStart;         // The window at the start of the drag
+        bool m_windowLevelPending; // True if the window is not previewed yet
+
+        // The notice shown while the series is loading
+        vtkSmartPointer<vtkTextActor> m_loadingText;
+        int m_sliceCount;
 };
 
+inline SlabMode SeriesSliceViewer::slabMode() const
+{ return m_slabMode; }
+
 #endif
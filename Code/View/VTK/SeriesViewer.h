@@ -72,6 +72,16 @@ class SeriesViewer : public Viewer
         //!
         inline vtkProp3D* getVtkProp3D() const;
 
+        //!
+        //! \brief The getSeries method returns the series visualized by the
+        //!        viewer.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The series visualized by the viewer.
+        //!
+        inline SeriesData const* getSeries() const;
+
         //!
         //! \brief The allowFusion method does all it is needed to prepare the
         //!        series viewer to join/leave a fusion.
@@ -132,4 +142,7 @@ class SeriesViewer : public Viewer
 // The 'vtkProp3D' method
 inline vtkProp3D* SeriesViewer::getVtkProp3D() const { return m_vtkProp3D; }
 
+// The 'getSeries' method
+inline SeriesData const* SeriesViewer::getSeries() const { return m_series; }
+
 #endif
@@ -49,21 +49,24 @@ SeriesVolumeViewer::SeriesVolumeViewer(SeriesData* series) : SeriesViewer(series
 
     // Custom properties
     m_opacityFunction.TakeReference(vtkPiecewiseFunction::New());
-    m_colorFunction.TakeReference(vtkColorTransferFunction::New());
-    m_rayCastFunction = 0;
+    m_mapping = SeriesDisplayMapping::acquire(series); // Shared color function
 
     vtkSmartPointer<vtkVolumeProperty> property = vtkSmartPointer<vtkVolumeProperty>::New();
     property->SetScalarOpacity(m_opacityFunction);
-    property->SetColor(m_colorFunction);
+    property->SetColor(m_mapping->colorFunction());
     property->DisableGradientOpacityOn();
     property->SetInterpolationTypeToLinear();
     volume->SetProperty(property);
 
     // Create the mapper
-    m_mapper = vtkSmartPointer<vtkVolumeRayCastMapper>::New();
+    m_mapper = vtkSmartPointer<vtkFixedPointVolumeRayCastMapper>::New();
     m_mapper->SetInput(series);
     volume->SetMapper(m_mapper);
 
+    // The quality is lowered while the camera moves
+    m_levelOfDetail = new VolumeLevelOfDetail(renderWindow(), renderer(), this);
+    m_levelOfDetail->addMapper(m_mapper);
+
     // Update the properties according to current parameters
     enableMip(false);
 
@@ -76,7 +79,9 @@ SeriesVolumeViewer::SeriesVolumeViewer(SeriesData* series) : SeriesViewer(series
 
 // Destructor
 SeriesVolumeViewer::~SeriesVolumeViewer()
-{}
+{
+    SeriesDisplayMapping::release(m_series);
+}
 
 // The 'minSlice' method
 double SeriesVolumeViewer::minSlice() const
@@ -115,21 +120,12 @@ void SeriesVolumeViewer::setPropOpacity(double opacity)
 // The 'enableMip' slot
 void SeriesVolumeViewer::enableMip(bool enable)
 {
-    if(m_rayCastFunction != 0)
-        m_rayCastFunction->Delete();
-
     if(enable)
-    {
-        m_rayCastFunction = vtkVolumeRayCastMIPFunction::New();
-        static_cast<vtkVolumeRayCastMIPFunction*>(m_rayCastFunction)->SetMaximizeMethodToOpacity();
-    }
+        m_mapper->SetBlendModeToMaximumIntensity();
     else
-    {
-        m_rayCastFunction = vtkVolumeRayCastCompositeFunction::New();
-    }
+        m_mapper->SetBlendModeToComposite();
 
-    m_mapper->SetVolumeRayCastFunction(m_rayCastFunction);
-    repaint();
+    scheduleRender();
 }
 
 // The 'updateHounsfield' method
@@ -153,17 +149,7 @@ void SeriesVolumeViewer::updateHounsfield(ViewConfiguration const& config)
 // The 'updateColormap' method
 void SeriesVolumeViewer::updateColormap(ViewConfiguration const& config)
 {
-    // Load hounsfield boundaries
-    Range maxRange = config.hounsfieldMaxRange();
-    Range huRange(m_series->convertFromHU(maxRange.min()),
-                  m_series->convertFromHU(maxRange.max()));
-
-    // Compute color transfert function
-    Range hu(m_series->convertFromHU(config.hounsfield().min()),
-             m_series->convertFromHU(config.hounsfield().max()));
-    vtkSmartPointer<vtkColorTransferFunction> func;
-    func.TakeReference(config.colormap().computeVTKColorTransferFunction(huRange, hu));
-    m_colorFunction->DeepCopy(func);
+    m_mapping->update(config); // Shared with the other viewers of the series
 }
 
 // The 'updateTranslation' method
@@ -47,13 +47,9 @@
 
 #include <vtkPiecewiseFunction.h>
 #include <vtkColorTransferFunction.h>
-#include <vtkVolumeRayCastFunction.h>
-#include <vtkVolumeRayCastCompositeFunction.h>
-#include <vtkVolumeRayCastIsosurfaceFunction.h>
-#include <vtkVolumeRayCastMIPFunction.h>
 
 #include <vtkVolumeProperty.h>
-#include <vtkVolumeRayCastMapper.h>
+#include <vtkFixedPointVolumeRayCastMapper.h>
 
 #include <vtkRendererCollection.h>
 #include <vtkPropCollection.h>
@@ -61,12 +57,22 @@
 #include "View/Qt/customwidget/Widget.h"
 
 #include "SeriesViewer.h"
+#include "SeriesDisplayMapping.h"
+#include "VolumeLevelOfDetail.h"
 #include "main.h"
 
 //!
 //! \brief The SeriesVolumeViewer class is a SeriesViewer which is specialized in
 //!        visualizing a 3D volume.
 //!
+//! The quality of the rendering is lowered while the camera moves, by a
+//! VolumeLevelOfDetail.
+//!
+//! The empty space is skipped by the mapper itself: it keeps the minimum and
+//! maximum values of small blocks of the series, computed again only when the
+//! voxels change, and checks them against the transfer functions before each
+//! render, so that the rays step over the fully transparent blocks.
+//!
 class SeriesVolumeViewer : public SeriesViewer
 {
     Q_OBJECT
@@ -127,6 +133,15 @@ class SeriesVolumeViewer : public SeriesViewer
         //!
         void setPropOpacity(double opacity);
 
+        //!
+        //! \brief The mapper method returns the mapper which renders the volume.
+        //!
+        //! The method is inline.
+        //!
+        //! \return The mapper of the volume.
+        //!
+        inline vtkFixedPointVolumeRayCastMapper* mapper() const;
+
     public slots:
         //!
         //! \brief The enableMip slot enable or disable the maximum intensity
@@ -195,13 +210,17 @@ class SeriesVolumeViewer : public SeriesViewer
         void updateRotation(ViewConfiguration const& config);
 
     private:
-        vtkSmartPointer<vtkVolumeRayCastMapper> m_mapper;
+        // Renders the voxels in their native type
+        vtkSmartPointer<vtkFixedPointVolumeRayCastMapper> m_mapper;
+        VolumeLevelOfDetail* m_levelOfDetail; // Owned as a child
 
         vtkSmartPointer<vtkPiecewiseFunction> m_opacityFunction;
-        vtkSmartPointer<vtkColorTransferFunction> m_colorFunction;
-        vtkVolumeRayCastFunction* m_rayCastFunction;
+        SeriesDisplayMapping* m_mapping; // Shared by the viewers of the series
 
         double m_opacity;
 };
 
+inline vtkFixedPointVolumeRayCastMapper* SeriesVolumeViewer::mapper() const
+{ return m_mapper; }
+
 #endif
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlicePrefetcher.cpp
+//! \brief The SlicePrefetcher.cpp file contains the definition of non-inline
+//!        methods of the SlicePrefetcher class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "SlicePrefetcher.h"
+using namespace std;
+
+// Constructor
+SlicePrefetcher::SlicePrefetcher(SeriesData* series, int axis)
+    : QThread(), m_series(series), m_axis(axis), m_stopped(false), m_version(0),
+      m_generation(0)
+{
+    m_series->GetExtent(m_extent);
+    m_series->GetSpacing(m_spacing);
+    m_series->GetOrigin(m_origin);
+
+    start(QThread::LowPriority);
+}
+
+// Destructor
+SlicePrefetcher::~SlicePrefetcher()
+{
+    m_mutex.lock();
+    m_stopped = true;
+    m_wakeUp.wakeAll();
+    m_mutex.unlock();
+
+    wait();
+}
+
+// The 'request' method
+void SlicePrefetcher::request(vector<int> const& slices, WindowLevelKernel const& kernel,
+                              unsigned int version)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(version != m_version)
+    {
+        m_kernel = kernel;
+        m_version = version;
+        m_images.clear();
+    }
+
+    // Keep the images which are still wanted, and color the others
+    map<int, vtkSmartPointer<vtkImageData> > images;
+    m_wanted.clear();
+    for(unsigned int i = 0 ; i < slices.size() ; i++)
+    {
+        map<int, vtkSmartPointer<vtkImageData> >::iterator it = m_images.find(slices[i]);
+        if(it != m_images.end())
+            images.insert(*it);
+        else
+            m_wanted.push_back(slices[i]);
+    }
+    m_images.swap(images);
+
+    m_wakeUp.wakeAll();
+}
+
+// The 'take' method
+vtkSmartPointer<vtkImageData> SlicePrefetcher::take(int slice, unsigned int version)
+{
+    QMutexLocker locker(&m_mutex);
+
+    vtkSmartPointer<vtkImageData> image;
+    map<int, vtkSmartPointer<vtkImageData> >::iterator it = m_images.find(slice);
+    if(it != m_images.end() && version == m_version)
+    {
+        image = it->second;
+        m_images.erase(it);
+    }
+
+    return image;
+}
+
+// The 'clear' method
+void SlicePrefetcher::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_images.clear();
+    m_wanted.clear();
+    m_generation++;
+}
+
+// The 'run' method
+void SlicePrefetcher::run()
+{
+    WindowLevelKernel kernel;
+    unsigned int kernelVersion = 0;
+
+    m_mutex.lock();
+    while(!m_stopped)
+    {
+        if(m_wanted.empty())
+        {
+            m_wakeUp.wait(&m_mutex);
+            continue;
+        }
+
+        int slice = m_wanted.front();
+        m_wanted.pop_front();
+        unsigned int version = m_version, generation = m_generation;
+        if(version != kernelVersion)
+        {
+            kernel = m_kernel;
+            kernelVersion = version;
+        }
+
+        // The slice is colored without holding the lock
+        m_mutex.unlock();
+        vtkSmartPointer<vtkImageData> image = colorSlice(slice, kernel);
+        m_mutex.lock();
+
+        if(version == m_version && generation == m_generation)
+            m_images[slice] = image;
+    }
+    m_mutex.unlock();
+}
+
+// The 'colorSlice' method
+vtkSmartPointer<vtkImageData> SlicePrefetcher::colorSlice(int slice, WindowLevelKernel const& kernel) const
+{
+    int extent[6] = { m_extent[0], m_extent[1], m_extent[2],
+                      m_extent[3], m_extent[4], m_extent[5] };
+    extent[2*m_axis] = extent[2*m_axis+1] = slice;
+
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetSpacing(m_spacing);
+    image->SetOrigin(m_origin);
+    image->SetExtent(extent);
+    image->SetScalarTypeToUnsignedChar();
+    image->SetNumberOfScalarComponents(4);
+    image->AllocateScalars();
+
+    kernel.mapSlice(m_series, extent, static_cast<unsigned char*>(image->GetScalarPointer()));
+    return image;
+}
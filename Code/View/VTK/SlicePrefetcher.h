@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file SlicePrefetcher.h
+//! \brief The SlicePrefetcher.h file contains the interface of the
+//!        SlicePrefetcher class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef SLICEPREFETCHER_H
+#define SLICEPREFETCHER_H
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <vtkSmartPointer.h>
+#include <vtkImageData.h>
+
+#include "Model/SeriesData.h"
+#include "Model/WindowLevelKernel.h"
+
+//!
+//! \brief The SlicePrefetcher class colors, on its own thread, the slices a
+//!        slice viewer is about to show.
+//!
+//! The viewer asks for the next slices, and takes a colored image when it
+//! shows one of them, so that changing the slice only swaps the image of the
+//! actor. The images are colored with a copy of the kernel of the display
+//! mapping, and are dropped when the mapping changes.
+//!
+class SlicePrefetcher : public QThread
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The SlicePrefetcher constructor starts the thread.
+        //!
+        //! \param series The series whose slices are colored.
+        //! \param axis The axis of the slices (0 for the sagittal slices, 1
+        //!             for the frontal ones and 2 for the transverse ones).
+        //!
+        SlicePrefetcher(SeriesData* series, int axis);
+
+        //!
+        //! \brief The SlicePrefetcher destructor stops the thread.
+        //!
+        ~SlicePrefetcher();
+
+        //!
+        //! \brief The request method gives the slices to color next.
+        //!
+        //! The images of the other slices are dropped.
+        //!
+        //! \param slices The indexes of the slices, in the order to color them.
+        //! \param kernel The kernel which colors the slices.
+        //! \param version The version of the display mapping of the kernel.
+        //!
+        //! \return Nothing.
+        //!
+        void request(std::vector<int> const& slices, WindowLevelKernel const& kernel,
+                     unsigned int version);
+
+        //!
+        //! \brief The take method gives the colored image of a slice, if it is
+        //!        ready.
+        //!
+        //! \param slice The index of the slice.
+        //! \param version The current version of the display mapping.
+        //!
+        //! \return The colored image, or a null pointer if it is not ready.
+        //!
+        vtkSmartPointer<vtkImageData> take(int slice, unsigned int version);
+
+        //!
+        //! \brief The clear method drops all the images, after the voxels of
+        //!        the series changed.
+        //!
+        //! \return Nothing.
+        //!
+        void clear();
+
+    protected:
+        //!
+        //! \brief The run method colors the requested slices until the
+        //!        prefetcher is destroyed.
+        //!
+        //! This is an implementation of the QThread method.
+        //!
+        //! \see void QThread::run()
+        //!
+        //! \return Nothing.
+        //!
+        void run();
+
+    private:
+        //!
+        //! \brief The colorSlice method creates the colored image of a slice.
+        //!
+        //! \param slice The index of the slice.
+        //! \param kernel The kernel which colors the slice.
+        //!
+        //! \return The colored image.
+        //!
+        vtkSmartPointer<vtkImageData> colorSlice(int slice, WindowLevelKernel const& kernel) const;
+
+        SeriesData* m_series;
+        int m_axis;
+        int m_extent[6];      // Read on the GUI thread by the constructor
+        double m_spacing[3];
+        double m_origin[3];
+
+        QMutex m_mutex;           // Protects the attributes below
+        QWaitCondition m_wakeUp;  // Signaled on a request or the end
+        bool m_stopped;
+        std::deque<int> m_wanted; // The slices still to color
+        std::map<int, vtkSmartPointer<vtkImageData> > m_images;
+        WindowLevelKernel m_kernel;
+        unsigned int m_version;
+        unsigned int m_generation; // Changed by each clear
+};
+
+#endif
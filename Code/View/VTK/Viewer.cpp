@@ -36,10 +36,33 @@
 using namespace std;
 using namespace customwidget;
 
+// Static attributes
+bool Viewer::s_offScreen = false;
+int Viewer::s_offScreenSize[2] = { 512, 512 };
+
 // Constructor
-Viewer::Viewer() : VTKWidget()
+Viewer::Viewer() : QObject(), m_offScreen(s_offScreen)
 {
-    m_renderWindow = GetRenderWindow();
+    // The off-screen window is kept by the viewer alone, without any widget
+    // which would bind it to a native window. Its interactor only carries the
+    // interactor styles, it never reads any event.
+    if(m_offScreen)
+    {
+        m_offScreenWindow = vtkSmartPointer<vtkRenderWindow>::New();
+        m_offScreenWindow->OffScreenRenderingOn();
+        m_offScreenWindow->SetSize(s_offScreenSize);
+
+        m_offScreenInteractor = vtkSmartPointer<vtkGenericRenderWindowInteractor>::New();
+        m_offScreenInteractor->SetRenderWindow(m_offScreenWindow);
+
+        m_renderWindow = m_offScreenWindow;
+    }
+    else
+    {
+        m_widget = new VTKWidget();
+        m_renderWindow = m_widget->GetRenderWindow();
+    }
+
     m_renderer = vtkOpenGLRenderer::New();
     m_renderer->SetBackground(0, 0, 0);
     m_renderWindow->AddRenderer(m_renderer);
@@ -58,10 +81,84 @@ Viewer::Viewer() : VTKWidget()
 
 // Destructor
 Viewer::~Viewer()
-{}
+{
+    RenderScheduler::instance()->forget(this);
+    delete m_widget;
+}
+
+// The 'sliceStep' method
+double Viewer::sliceStep() const
+{
+    return (maxSlice() - minSlice()) / 1000.0;
+}
+
+// The 'scheduleRender' method
+void Viewer::scheduleRender()
+{
+    RenderScheduler::instance()->scheduleRender(this);
+}
+
+// The 'applyPendingUpdates' method
+void Viewer::applyPendingUpdates()
+{
+    // The map is ordered as the ViewParam enum, so a complete update comes
+    // before the updates of single parameters which followed it
+    map<ViewConfiguration::ViewParam, ViewConfiguration> updates;
+    updates.swap(m_pendingUpdates);
+
+    map<ViewConfiguration::ViewParam, ViewConfiguration>::iterator it;
+    for(it = updates.begin() ; it != updates.end() ; ++it)
+        applyUpdate(it->second, it->first);
+}
+
+// The 'render' method
+void Viewer::render()
+{
+    if(m_offScreen)
+        m_renderWindow->Render();
+    else
+        m_widget->repaint();
+}
+
+// The 'saveSnapshot' method
+void Viewer::saveSnapshot(string const& fileName)
+{
+    applyPendingUpdates();
+    m_renderWindow->Render();
+
+    vtkSmartPointer<vtkWindowToImageFilter> grabber = vtkSmartPointer<vtkWindowToImageFilter>::New();
+    grabber->SetInput(m_renderWindow);
+    if(m_offScreen)
+        grabber->ReadFrontBufferOff(); // The off-screen windows have no front buffer
+    grabber->Update();
+
+    vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+    writer->SetInput(grabber->GetOutput());
+    writer->SetFileName(fileName.c_str());
+    writer->Write();
+}
+
+// The 'setOffScreen' static method
+void Viewer::setOffScreen(bool offScreen, int width, int height)
+{
+    s_offScreen = offScreen;
+    s_offScreenSize[0] = width;
+    s_offScreenSize[1] = height;
+}
 
 // The 'updateView' slot
 void Viewer::updateView(ViewConfiguration const& config, ViewConfiguration::ViewParam param)
+{
+    // A complete update replaces all the others
+    if(param == ViewConfiguration::ALL)
+        m_pendingUpdates.clear();
+    m_pendingUpdates[param] = config;
+
+    scheduleRender();
+}
+
+// The 'applyUpdate' method
+void Viewer::applyUpdate(ViewConfiguration const& config, ViewConfiguration::ViewParam param)
 {
     // Check the param to update and call the corresponding function
     switch(param)
@@ -89,9 +186,6 @@ void Viewer::updateView(ViewConfiguration const& config, ViewConfiguration::View
             updateRotation(config);
             break;
     }
-
-    // Repaint the viewer to really apply the update
-    repaint();
 }
 
 // The 'showAxes' method
@@ -99,5 +193,5 @@ void Viewer::showAxes(bool show)
 {
     m_axes->SetVisibility(show);
     m_renderer->ResetCameraClippingRange();
-    repaint();
+    scheduleRender();
 }
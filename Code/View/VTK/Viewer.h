@@ -36,6 +36,11 @@
 #define VIEWER_H
 
 #include <iostream>
+#include <string>
+#include <map>
+
+#include <QObject>
+#include <QPointer>
 
 #include <vtkRenderWindow.h>
 #include <vtkRenderer.h>
@@ -45,16 +50,26 @@
 #include <vtkAxesActor.h>
 #include <vtkOrientationMarkerWidget.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkGenericRenderWindowInteractor.h>
+#include <vtkWindowToImageFilter.h>
+#include <vtkPNGWriter.h>
 
 #include "View/Qt/customwidget/VTKWidget.h"
 
 #include "Model/ViewConfiguration.h"
 
+#include "RenderScheduler.h"
+
 //!
-//! \brief The Viewer class represents a specific widget to visualize
+//! \brief The Viewer class represents a specific view to visualize
 //!        customizable object with the ViewConfiguration class.
 //!
-class Viewer : public customwidget::VTKWidget
+//! The viewer holds the render window and the renderer. An on-screen viewer
+//! shows its render window in a VTKWidget, given by the widget() method. An
+//! off-screen viewer has no widget at all, so that it can render without any
+//! display, with only a QCoreApplication.
+//!
+class Viewer : public QObject
 {
     Q_OBJECT
 
@@ -88,12 +103,107 @@ class Viewer : public customwidget::VTKWidget
         //!
         virtual double maxSlice() const = 0;
 
+        //!
+        //! \brief The sliceStep method returns the distance between two
+        //!        consecutive slices, used to step through the slices.
+        //!
+        //! By default, the slice range is divided in 1000 steps, like the
+        //! slice slider.
+        //!
+        //! \return The distance between two consecutive slices.
+        //!
+        virtual double sliceStep() const;
+
+        //!
+        //! \brief The scheduleRender method asks the RenderScheduler to render
+        //!        the viewer at the next display frame.
+        //!
+        //! The viewers render this way instead of at once, so that the
+        //! changes of a frame only cost one render.
+        //!
+        //! \return Nothing.
+        //!
+        void scheduleRender();
+
+        //!
+        //! \brief The applyPendingUpdates method applies the updates the viewer
+        //!        has kept since the last frame.
+        //!
+        //! The method is called by the RenderScheduler before the render.
+        //! Subclasses which keep their own updates must call it.
+        //!
+        //! \return Nothing.
+        //!
+        virtual void applyPendingUpdates();
+
+        //!
+        //! \brief The render method renders the viewer at once.
+        //!
+        //! The on-screen viewers repaint their widget, the off-screen ones
+        //! render in their framebuffer.
+        //!
+        //! \return Nothing.
+        //!
+        void render();
+
+        //!
+        //! \brief The saveSnapshot method applies the pending updates, renders
+        //!        the viewer and writes the image in a PNG file.
+        //!
+        //! \param fileName The path of the PNG file.
+        //!
+        //! \return Nothing.
+        //!
+        void saveSnapshot(std::string const& fileName);
+
+        //!
+        //! \brief The setOffScreen static method chooses if the viewers created
+        //!        afterwards render off-screen.
+        //!
+        //! The off-screen viewers are never shown: they render in a framebuffer
+        //! of their own (a software one when VTK is built with OSMesa), for
+        //! the batch snapshots and the render measurements. They create no
+        //! widget, so their render window is not bound to a native window.
+        //!
+        //! \param offScreen True to render off-screen.
+        //! \param width The width of the off-screen framebuffer.
+        //! \param height The height of the off-screen framebuffer.
+        //!
+        //! \return Nothing.
+        //!
+        static void setOffScreen(bool offScreen, int width = 512, int height = 512);
+
+        //!
+        //! \brief The isOffScreen method indicates if the viewer renders
+        //!        off-screen.
+        //!
+        //! The method is inline.
+        //!
+        //! \return True if the viewer renders off-screen.
+        //!
+        inline bool isOffScreen() const;
+
+        //!
+        //! \brief The widget method returns the widget which shows the render
+        //!        window of the viewer.
+        //!
+        //! The method is inline.
+        //! The widget is destroyed with the viewer.
+        //!
+        //! \return A pointer to the widget, or a null pointer if the viewer
+        //!         renders off-screen.
+        //!
+        inline customwidget::VTKWidget* widget() const;
+
     public slots:
         //!
         //! \brief The updateView slot calls the specific routines according to
         //!        view parameter that need to be modified and use the view
         //!        configuration to do it.
         //!
+        //! The update is only applied at the next frame, and replaces the
+        //! update of the same view parameter which is not applied yet.
+        //!
         //! \param config The view configuration parameters.
         //! \param param A constant which identifies the view parameter type to
         //!              be modified.
@@ -191,6 +301,34 @@ class Viewer : public customwidget::VTKWidget
         inline vtkRenderer* renderer() const;
 
     private:
+        //!
+        //! \brief The applyUpdate method calls the specific routines according
+        //!        to the view parameter to update.
+        //!
+        //! \param config The view configuration parameters.
+        //! \param param A constant which identifies the view parameter type to
+        //!              be modified.
+        //!
+        //! \return Nothing.
+        //!
+        void applyUpdate(ViewConfiguration const& config, ViewConfiguration::ViewParam param);
+
+        // The off-screen mode of the next viewers
+        static bool s_offScreen;
+        static int s_offScreenSize[2];
+
+        bool m_offScreen;
+
+        // The widget of an on-screen viewer
+        QPointer<customwidget::VTKWidget> m_widget;
+
+        // The window and the interactor of an off-screen viewer
+        vtkSmartPointer<vtkRenderWindow> m_offScreenWindow;
+        vtkSmartPointer<vtkGenericRenderWindowInteractor> m_offScreenInteractor;
+
+        // The updates not applied yet (the last one of each parameter)
+        std::map<ViewConfiguration::ViewParam, ViewConfiguration> m_pendingUpdates;
+
         //! The vtk object which contains the window for visualization.
         vtkRenderWindow* m_renderWindow;
         vtkRenderer* m_renderer;
@@ -198,6 +336,12 @@ class Viewer : public customwidget::VTKWidget
         vtkSmartPointer<vtkAxesActor> m_axes;
 };
 
+// The 'isOffScreen' method
+inline bool Viewer::isOffScreen() const { return m_offScreen; }
+
+// The 'widget' method
+inline customwidget::VTKWidget* Viewer::widget() const { return m_widget; }
+
 // The 'renderWindow' method
 inline vtkRenderWindow* Viewer::renderWindow() const { return m_renderWindow; }
 
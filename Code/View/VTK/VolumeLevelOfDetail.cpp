@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file VolumeLevelOfDetail.cpp
+//! \brief The VolumeLevelOfDetail.cpp file contains the definition of
+//!        non-inline methods of the VolumeLevelOfDetail class.
+//!
+//! \author Quentin Smetz
+//!
+
+#include "VolumeLevelOfDetail.h"
+using namespace std;
+
+// Constructor
+VolumeLevelOfDetail::VolumeLevelOfDetail(vtkRenderWindow* renderWindow, vtkRenderer* renderer,
+                                         QObject* parent)
+    : QObject(parent), m_coarsening(1), m_interacting(false)
+{
+    m_connections = vtkSmartPointer<vtkEventQtSlotConnect>::New();
+
+    vtkInteractorObserver* style = renderWindow->GetInteractor()->GetInteractorStyle();
+    m_connections->Connect(style, vtkCommand::StartInteractionEvent, this, SLOT(startInteraction()));
+    m_connections->Connect(style, vtkCommand::EndInteractionEvent, this, SLOT(endInteraction()));
+    m_connections->Connect(renderer, vtkCommand::StartEvent, this, SLOT(startFrame()));
+    m_connections->Connect(renderer, vtkCommand::EndEvent, this, SLOT(endFrame()));
+}
+
+// Destructor
+VolumeLevelOfDetail::~VolumeLevelOfDetail()
+{
+    m_connections->Disconnect();
+}
+
+// The 'addMapper' method
+void VolumeLevelOfDetail::addMapper(vtkFixedPointVolumeRayCastMapper* mapper)
+{
+    if(m_sampleDistances.count(mapper))
+        return;
+
+    mapper->AutoAdjustSampleDistancesOff();
+    m_sampleDistances[mapper] = mapper->GetSampleDistance();
+}
+
+// The 'removeMapper' method
+void VolumeLevelOfDetail::removeMapper(vtkFixedPointVolumeRayCastMapper* mapper)
+{
+    map<vtkFixedPointVolumeRayCastMapper*, double>::iterator it = m_sampleDistances.find(mapper);
+    if(it == m_sampleDistances.end())
+        return;
+
+    mapper->SetImageSampleDistance(1);
+    mapper->SetSampleDistance(it->second);
+    m_sampleDistances.erase(it);
+}
+
+// The 'startInteraction' slot
+void VolumeLevelOfDetail::startInteraction()
+{
+    m_interacting = true;
+    applyCoarsening(m_coarsening);
+}
+
+// The 'endInteraction' slot
+void VolumeLevelOfDetail::endInteraction()
+{
+    m_interacting = false;
+    applyCoarsening(1);
+}
+
+// The 'startFrame' slot
+void VolumeLevelOfDetail::startFrame()
+{
+    m_frameClock.start();
+}
+
+// The 'endFrame' slot
+void VolumeLevelOfDetail::endFrame()
+{
+    if(!m_interacting)
+        return;
+
+    // The factor only changes when the frame is too long, or much shorter
+    // than the budget
+    double ratio = static_cast<double>(m_frameClock.elapsed()) / s_frameBudget;
+    if(ratio >= 0.5 && ratio <= 1)
+        return;
+
+    double coarsening = m_coarsening * pow(ratio, 1.0 / 3);
+    if(coarsening < 1)
+        coarsening = 1;
+    if(coarsening > s_maxCoarsening)
+        coarsening = s_maxCoarsening;
+
+    m_coarsening = coarsening;
+    applyCoarsening(m_coarsening);
+}
+
+// The 'applyCoarsening' private method
+void VolumeLevelOfDetail::applyCoarsening(double coarsening)
+{
+    map<vtkFixedPointVolumeRayCastMapper*, double>::iterator it;
+    for(it = m_sampleDistances.begin() ; it != m_sampleDistances.end() ; ++it)
+    {
+        it->first->SetImageSampleDistance(coarsening);
+        it->first->SetSampleDistance(it->second * coarsening);
+    }
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2013-2014 Quentin Smetz <qsmetz@gmail.com>, Sebastien
+ * Jodogne <s.jodogne@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+
+
+//!
+//! \file VolumeLevelOfDetail.h
+//! \brief The VolumeLevelOfDetail.h file contains the interface of the
+//!        VolumeLevelOfDetail class and the definitions of its inline methods.
+//!
+//! \author Quentin Smetz
+//!
+
+#ifndef VOLUMELEVELOFDETAIL_H
+#define VOLUMELEVELOFDETAIL_H
+
+#include <iostream>
+#include <map>
+#include <cmath>
+
+#include <QObject>
+#include <QTime>
+
+#include <vtkSmartPointer.h>
+#include <vtkCommand.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkInteractorObserver.h>
+#include <vtkFixedPointVolumeRayCastMapper.h>
+#include <vtkEventQtSlotConnect.h>
+
+//!
+//! \brief The VolumeLevelOfDetail class lowers the quality of the volume
+//!        rendering of a viewer while the user moves the camera, so that each
+//!        frame fits in a time budget.
+//!
+//! While the interactor style of the viewer interacts, the rays are cast
+//! every few pixels and sampled with larger steps, by the same coarsening
+//! factor. After each frame, the factor is tuned with the time of the frame
+//! (the cost of a frame goes down like its cube), and it is kept for the next
+//! interaction. When the interaction stops, the mappers go back to the full
+//! quality before the last render of the interactor style.
+//!
+//! The automatic adjustment of the mappers, which follows the update rate of
+//! the render window, is disabled.
+//!
+class VolumeLevelOfDetail : public QObject
+{
+    Q_OBJECT
+
+    public:
+        //!
+        //! \brief The VolumeLevelOfDetail constructor follows the interactions
+        //!        and the frames of a viewer.
+        //!
+        //! \param renderWindow The render window of the viewer, whose
+        //!                     interactor style must be set.
+        //! \param renderer The renderer which draws the volumes.
+        //! \param parent The parent of the object.
+        //!
+        VolumeLevelOfDetail(vtkRenderWindow* renderWindow, vtkRenderer* renderer,
+                            QObject* parent = 0);
+
+        //!
+        //! \brief The VolumeLevelOfDetail destructor.
+        //!
+        ~VolumeLevelOfDetail();
+
+        //!
+        //! \brief The addMapper method adds a mapper whose quality is lowered
+        //!        during the interactions.
+        //!
+        //! Its current sample distance is kept as the one of the full quality.
+        //!
+        //! \param mapper The mapper.
+        //!
+        //! \return Nothing.
+        //!
+        void addMapper(vtkFixedPointVolumeRayCastMapper* mapper);
+
+        //!
+        //! \brief The removeMapper method gives back the full quality to a
+        //!        mapper, and stops changing it.
+        //!
+        //! \param mapper The mapper.
+        //!
+        //! \return Nothing.
+        //!
+        void removeMapper(vtkFixedPointVolumeRayCastMapper* mapper);
+
+        //!
+        //! \brief The isInteracting method tells if the quality is lowered for
+        //!        an interaction.
+        //!
+        //! The method is inline.
+        //!
+        //! \return True during an interaction.
+        //!
+        inline bool isInteracting() const;
+
+    private slots:
+        //!
+        //! \brief The startInteraction slot lowers the quality of the mappers
+        //!        to the last tuned level.
+        //!
+        //! \return Nothing.
+        //!
+        void startInteraction();
+
+        //!
+        //! \brief The endInteraction slot gives back the full quality to the
+        //!        mappers.
+        //!
+        //! \return Nothing.
+        //!
+        void endInteraction();
+
+        //!
+        //! \brief The startFrame slot starts to measure the time of a frame.
+        //!
+        //! \return Nothing.
+        //!
+        void startFrame();
+
+        //!
+        //! \brief The endFrame slot tunes the quality of the next frames with
+        //!        the time of the last one, during an interaction.
+        //!
+        //! \return Nothing.
+        //!
+        void endFrame();
+
+    private:
+        //!
+        //! \brief The applyCoarsening method sets the distances of the mappers
+        //!        for a coarsening factor.
+        //!
+        //! \param coarsening The coarsening factor (1 for the full quality).
+        //!
+        //! \return Nothing.
+        //!
+        void applyCoarsening(double coarsening);
+
+        static int const s_frameBudget = 50;   // In ms (20 frames per second)
+        static int const s_maxCoarsening = 4;  // The coarsest factor
+
+        // The mappers and their sample distance at the full quality
+        std::map<vtkFixedPointVolumeRayCastMapper*, double> m_sampleDistances;
+
+        double m_coarsening; // The factor tuned for the interactions
+        bool m_interacting;
+        QTime m_frameClock;  // Restarted at the start of each frame
+
+        vtkSmartPointer<vtkEventQtSlotConnect> m_connections;
+};
+
+inline bool VolumeLevelOfDetail::isInteracting() const
+{ return m_interacting; }
+
+#endif
@@ -32,13 +32,17 @@
 //!
 
 #include <iostream>
+#include <string>
 #include <QApplication>
+#include <QCoreApplication>
 #include <QTextCodec>
 
 #include "orthanc/OrthancCppClient.h"
 
 #include "Model/ProgramConfiguration.h"
+#include "Model/WindowLevelKernel.h"
 
+#include "Controller/SnapshotBatch.h"
 #include "Controller/ViewerWindow.h"
 
 using namespace std;
@@ -55,6 +59,20 @@ int main(int argc, char* argv[])
 {
     QTextCodec::setCodecForCStrings(QTextCodec::codecForName("UTF-8"));
 
+    // Only compare the slice coloring paths
+    if(argc > 1 && string(argv[1]) == "--benchmark")
+    {
+        WindowLevelKernel::benchmark(cout);
+        return 0;
+    }
+
+    // Render snapshots off-screen, without Orthanc nor display
+    if(argc > 2 && string(argv[1]) == "--snapshots")
+    {
+        QCoreApplication app(argc, argv);
+        return SnapshotBatch::run(argv[2], cout);
+    }
+
 	// Initialize Orthanc client library
     try {
 #if 0